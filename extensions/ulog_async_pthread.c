@@ -0,0 +1,82 @@
+// *************************************************************************
+//
+// microlog extension: pthread writer thread for async mode (implementation)
+//
+// The writer thread calls `ulog_async_flush()` in a loop and sleeps while the
+// queue has nothing to write. Only one writer thread is supported, as the
+// core queue has a single consumer.
+//
+// *************************************************************************
+
+#include "ulog_async_pthread.h"
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+
+static pthread_t writer_thread;
+static atomic_bool writer_running  = false;
+static unsigned int writer_idle_ms = 0;
+
+/**
+ * @brief Sleeps for the idle time, or yields if it is zero.
+ */
+static void writer_idle(void) {
+    if (writer_idle_ms == 0) {
+        sched_yield();
+        return;
+    }
+    struct timespec ts = {
+        .tv_sec  = writer_idle_ms / 1000,
+        .tv_nsec = (long)(writer_idle_ms % 1000) * 1000000L,
+    };
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Writer thread body; flushes the queue until stopped.
+ */
+static void *writer_main(void *arg) {
+    (void)arg;
+    while (writer_running) {
+        size_t pending = ulog_async_pending();
+        if (pending == 0) {
+            writer_idle();
+            continue;
+        }
+        (void)ulog_async_flush();
+        // Pending also counts events still being queued, which the flush
+        // skips: without a drop in the count, nothing may have been written
+        if (ulog_async_pending() >= pending) {
+            writer_idle();
+        }
+    }
+    return NULL;
+}
+
+/** @copydoc ulog_async_pthread_start */
+ulog_status ulog_async_pthread_start(unsigned int idle_ms) {
+    if (writer_running) {
+        return ULOG_STATUS_BUSY;
+    }
+
+    writer_idle_ms = idle_ms;
+    writer_running = true;
+    if (pthread_create(&writer_thread, NULL, writer_main, NULL) != 0) {
+        writer_running = false;
+        return ULOG_STATUS_ERROR;
+    }
+    return ULOG_STATUS_OK;
+}
+
+/** @copydoc ulog_async_pthread_stop */
+ulog_status ulog_async_pthread_stop(void) {
+    if (!writer_running) {
+        return ULOG_STATUS_NOT_FOUND;
+    }
+
+    writer_running = false;
+    if (pthread_join(writer_thread, NULL) != 0) {
+        return ULOG_STATUS_ERROR;
+    }
+    return ulog_async_flush();  // Events queued after the last loop
+}
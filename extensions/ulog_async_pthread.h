@@ -0,0 +1,43 @@
+// *************************************************************************
+//
+// microlog extension: pthread writer thread for async mode
+//
+// Requires the core to be built with ULOG_BUILD_ASYNC > 0. Events are queued
+// by the logging calls and written to the outputs by a background thread.
+//
+// Usage:
+//    #include "ulog_async_pthread.h"
+//    ...
+//    ulog_async_pthread_start(1);  // Poll every 1 ms when the queue is empty
+//    ulog_info("written by the writer thread");
+//    ...
+//    ulog_async_pthread_stop();    // Flushes the remaining events
+//
+// *************************************************************************
+
+#pragma once
+#include <pthread.h>
+#include "ulog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * @brief Start the writer thread.
+ * @param idle_ms Sleep time when the queue is empty or the events in it are
+ * still being queued, in milliseconds. 0 means the thread only yields.
+ * @return ULOG_STATUS_OK on success, ULOG_STATUS_BUSY if the thread is already
+ * running, ULOG_STATUS_ERROR if the thread cannot be created.
+ */
+ulog_status ulog_async_pthread_start(unsigned int idle_ms);
+
+/**
+ * @brief Stop the writer thread and flush the remaining events.
+ * @return ULOG_STATUS_OK on success, ULOG_STATUS_NOT_FOUND if the thread is not
+ * running, ULOG_STATUS_ERROR if the thread cannot be joined.
+ */
+ulog_status ulog_async_pthread_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,458 @@
+// *************************************************************************
+//
+// microlog extension: buffered POSIX file output with flush policies
+// (implementation)
+//
+// Lines are rendered by ulog_event_to_line() straight into a page aligned
+// buffer owned by the extension and written to the file descriptor with
+// write(2) when a flush condition is met. One mutex guards all files, the
+// output handler is the only writer while logging and the worker thread
+// (flush_ms, rotation) only takes it to write the buffer or swap files.
+//
+// Rotation keeps the logging call short: the next file is opened by the
+// worker ahead of time, the write that reaches the size (or the worker at
+// the time limit) swaps the descriptors, and the worker renames the files,
+// closes the old one and opens the next one without the mutex.
+//
+// *************************************************************************
+
+#include "ulog_file_posix.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FILE_POSIX_ALIGN 4096u  // Buffer alignment and size granularity
+#define FILE_POSIX_NS_PER_SEC 1000000000L
+#define FILE_POSIX_PATH_MAX 512  // Path with a rotation suffix
+#define FILE_POSIX_SUFFIX_MAX 32  // Longest suffix: ".YYYYmmdd-HHMMSS-N"
+#define FILE_POSIX_NEXT_SUFFIX ".next"
+
+typedef struct {
+    bool used;              // Slot is taken
+    ulog_output_id output;  // ULOG_OUTPUT_INVALID until the output is added
+    int fd;
+    char *buf;    // NULL once the file is closing
+    size_t size;  // Buffer size
+    size_t len;   // Buffered bytes
+    size_t flush_bytes;
+    unsigned int flush_ms;
+    ulog_level flush_level;
+    bool worker_running;
+    pthread_t worker;
+
+    // Rotation, rotate_keep is 0 if it is off
+    size_t rotate_bytes;
+    unsigned int rotate_sec;
+    unsigned int rotate_keep;
+    ulog_file_posix_naming rotate_naming;
+    size_t written;    // Bytes in the current file
+    time_t rotate_at;  // Time of the next rotation by time, 0 - none
+    bool rotate_due;   // Rotation by time waits for the next file
+    int next_fd;       // Opened ahead of time, -1 - not ready
+    int old_fd;        // Rotated out, -1 - renamed and closed by the worker
+    char path[FILE_POSIX_PATH_MAX];
+    char next_path[FILE_POSIX_PATH_MAX];
+    char (*names)[FILE_POSIX_PATH_MAX];  // Timestamp naming: rotated files
+    unsigned int names_count;            // Files rotated so far
+} file_posix;
+
+static file_posix files[ULOG_FILE_POSIX_NUM];
+static pthread_mutex_t file_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t file_wake   = PTHREAD_COND_INITIALIZER;
+
+/**
+ * @brief Start of the next rotate_sec interval since the epoch.
+ */
+static time_t file_rotate_next_time(unsigned int rotate_sec) {
+    time_t now = time(NULL);
+    return (now / rotate_sec + 1) * rotate_sec;
+}
+
+/**
+ * @brief Swaps in the next file if a rotation is due and the worker has
+ * opened it. Locked.
+ */
+static void file_rotate_swap(file_posix *f) {
+    if (f->rotate_keep == 0) {
+        return;  // Rotation is off
+    }
+    bool by_size = f->rotate_bytes > 0 && f->written >= f->rotate_bytes;
+    if (!by_size && !f->rotate_due) {
+        return;
+    }
+    if (f->next_fd < 0 || f->old_fd >= 0) {
+        return;  // The worker is busy, rotate after a later write
+    }
+    f->old_fd     = f->fd;
+    f->fd         = f->next_fd;
+    f->next_fd    = -1;
+    f->written    = 0;
+    f->rotate_due = false;
+    (void)pthread_cond_broadcast(&file_wake);  // Rename and open the next
+}
+
+/**
+ * @brief Writes the buffered lines and empties the buffer. Locked.
+ * @return ULOG_STATUS_ERROR if write(2) failed, the lines are dropped.
+ */
+static ulog_status file_write(file_posix *f) {
+    ulog_status status = ULOG_STATUS_OK;
+    size_t done        = 0;
+    while (done < f->len) {
+        ssize_t n = write(f->fd, f->buf + done, f->len - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            status = ULOG_STATUS_ERROR;
+            break;
+        }
+        done += (size_t)n;
+    }
+    f->len = 0;
+    f->written += done;
+    file_rotate_swap(f);
+    return status;
+}
+
+/**
+ * @brief Renders the event line at the end of the buffer. Locked.
+ */
+static void file_append(file_posix *f, ulog_event *ev) {
+    char *end          = f->buf + f->len;
+    size_t len         = 0;
+    ulog_status status = ulog_event_to_line(ev, end, f->size - f->len, &len);
+    if (status != ULOG_STATUS_OK && f->len > 0) {
+        // Not enough space left, retry in the empty buffer
+        (void)file_write(f);
+        end    = f->buf;
+        status = ulog_event_to_line(ev, end, f->size, &len);
+    }
+    if (status != ULOG_STATUS_OK && len > 0) {
+        end[len - 1] = '\n';  // Longer than the buffer, keep the line break
+    }
+    f->len += len;
+}
+
+/**
+ * @brief Output handler; buffers the line and applies the flush policy.
+ */
+static void file_handler(ulog_event *ev, void *arg) {
+    file_posix *f = (file_posix *)arg;
+
+    (void)pthread_mutex_lock(&file_mutex);
+    if (f->buf != NULL) {
+        file_append(f, ev);
+        if (ulog_event_get_level(ev) >= f->flush_level ||
+            (f->flush_bytes > 0 && f->len >= f->flush_bytes)) {
+            (void)file_write(f);
+        }
+    }
+    (void)pthread_mutex_unlock(&file_mutex);
+}
+
+/**
+ * @brief Opens the next file ahead of a rotation.
+ * @return File descriptor or -1.
+ */
+static int file_open_next(file_posix *f) {
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC;
+    return open(f->next_path, flags, 0644);
+}
+
+/**
+ * @brief Gives the rotated file its name and the next file the path. Called
+ * by the worker without the mutex: the paths do not change while the file is
+ * open and the names are used only here.
+ */
+static void file_rename(file_posix *f) {
+    char from[FILE_POSIX_PATH_MAX];
+    char to[FILE_POSIX_PATH_MAX];
+
+    if (f->rotate_naming == ULOG_FILE_POSIX_NAMING_TIMESTAMP) {
+        time_t now = time(NULL);
+        struct tm tm;
+        (void)localtime_r(&now, &tm);
+        size_t n = (size_t)snprintf(to, sizeof(to), "%s.", f->path);
+        n += strftime(to + n, sizeof(to) - n, "%Y%m%d-%H%M%S", &tm);
+        // Several rotations in one second
+        for (int i = 1; access(to, F_OK) == 0 && i < 1000; i++) {
+            (void)snprintf(to + n, sizeof(to) - n, "-%d", i);
+        }
+
+        char *slot = f->names[f->names_count % f->rotate_keep];
+        if (f->names_count >= f->rotate_keep) {
+            (void)unlink(slot);  // The oldest rotated file
+        }
+        (void)snprintf(slot, FILE_POSIX_PATH_MAX, "%s", to);
+        f->names_count++;
+    } else {
+        for (unsigned int i = f->rotate_keep - 1; i > 0; i--) {
+            int from_len = snprintf(from, sizeof(from), "%s.%u", f->path, i);
+            int to_len = snprintf(to, sizeof(to), "%s.%u", f->path, i + 1);
+            if (from_len < (int)sizeof(from) && to_len < (int)sizeof(to)) {
+                (void)rename(from, to);  // Replaces the oldest one
+            }
+        }
+        if (snprintf(to, sizeof(to), "%s.1", f->path) >= (int)sizeof(to)) {
+            return;  // Not possible, the path length is checked on open
+        }
+    }
+
+    (void)rename(f->path, to);
+    (void)rename(f->next_path, f->path);
+}
+
+/**
+ * @brief Finishes a rotation and opens the next file. Called by the worker
+ * with the mutex, which is released while files are renamed and opened.
+ */
+static void file_rotate_finish(file_posix *f) {
+    if (f->rotate_keep == 0 || (f->old_fd < 0 && f->next_fd >= 0)) {
+        return;  // No rotation, or the next file is ready
+    }
+    int old_fd = f->old_fd;
+    (void)pthread_mutex_unlock(&file_mutex);
+
+    if (old_fd >= 0) {
+        file_rename(f);
+        (void)close(old_fd);
+    }
+    int next_fd = file_open_next(f);
+
+    (void)pthread_mutex_lock(&file_mutex);
+    f->old_fd  = -1;
+    f->next_fd = next_fd;
+    file_rotate_swap(f);  // A rotation may be waiting for the next file
+}
+
+/**
+ * @brief Waits for the next flush, the next rotation by time or a signal.
+ * Locked.
+ */
+static void file_worker_wait(file_posix *f) {
+    if (f->flush_ms == 0 && f->rotate_at == 0) {
+        (void)pthread_cond_wait(&file_wake, &file_mutex);
+        return;
+    }
+
+    struct timespec deadline = {.tv_sec = f->rotate_at, .tv_nsec = 0};
+    if (f->flush_ms > 0) {
+        struct timespec flush;
+        (void)clock_gettime(CLOCK_REALTIME, &flush);
+        flush.tv_sec += f->flush_ms / 1000;
+        flush.tv_nsec += (long)(f->flush_ms % 1000) * 1000000L;
+        if (flush.tv_nsec >= FILE_POSIX_NS_PER_SEC) {
+            flush.tv_sec++;
+            flush.tv_nsec -= FILE_POSIX_NS_PER_SEC;
+        }
+        if (f->rotate_at == 0 || flush.tv_sec < f->rotate_at) {
+            deadline = flush;
+        }
+    }
+    // Woken early by another file, an extra write is harmless
+    (void)pthread_cond_timedwait(&file_wake, &file_mutex, &deadline);
+}
+
+/**
+ * @brief Worker thread body; writes the buffer every flush_ms and rotates the
+ * file until stopped.
+ */
+static void *file_worker_main(void *arg) {
+    file_posix *f = (file_posix *)arg;
+
+    (void)pthread_mutex_lock(&file_mutex);
+    while (f->worker_running) {
+        file_worker_wait(f);
+        if (f->flush_ms > 0 && f->len > 0) {
+            (void)file_write(f);
+        }
+        if (f->rotate_at > 0 && time(NULL) >= f->rotate_at) {
+            f->rotate_at  = file_rotate_next_time(f->rotate_sec);
+            f->rotate_due = true;
+            (void)file_write(f);  // The buffered lines end the old file
+        }
+        file_rotate_finish(f);
+    }
+    file_rotate_finish(f);  // A rotation during the last wait
+    (void)pthread_mutex_unlock(&file_mutex);
+    return NULL;
+}
+
+/**
+ * @brief Finds the file of the output. Locked.
+ */
+static file_posix *file_find(ulog_output_id output) {
+    for (int i = 0; i < ULOG_FILE_POSIX_NUM; i++) {
+        file_posix *f = &files[i];
+        if (f->used && f->buf != NULL && f->output == output &&
+            output != ULOG_OUTPUT_INVALID) {
+            return f;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Stops the worker, writes the buffer, closes the files and frees the
+ * slot. The output must already be removed.
+ */
+static ulog_status file_release(file_posix *f) {
+    (void)pthread_mutex_lock(&file_mutex);
+    bool worker       = f->worker_running;
+    f->worker_running = false;
+    (void)pthread_cond_broadcast(&file_wake);
+    (void)pthread_mutex_unlock(&file_mutex);
+    if (worker) {
+        (void)pthread_join(f->worker, NULL);
+    }
+
+    (void)pthread_mutex_lock(&file_mutex);
+    file_rotate_finish(f);   // Rotated by a write after the worker stopped
+    f->rotate_keep     = 0;  // The last lines stay in this file
+    ulog_status status = file_write(f);
+    if (close(f->fd) != 0) {
+        status = ULOG_STATUS_ERROR;
+    }
+    if (f->next_fd >= 0) {
+        (void)close(f->next_fd);
+        (void)unlink(f->next_path);
+    }
+    free(f->buf);
+    free(f->names);
+    f->buf   = NULL;
+    f->names = NULL;
+    f->used  = false;
+    (void)pthread_mutex_unlock(&file_mutex);
+    return status;
+}
+
+/** @copydoc ulog_file_posix_open */
+ulog_output_id ulog_file_posix_open(const char *path, ulog_level level,
+                                    const ulog_file_posix_config *config) {
+    static const ulog_file_posix_config config_default =
+        ULOG_FILE_POSIX_CONFIG_DEFAULT;
+    if (path == NULL ||
+        strlen(path) >= FILE_POSIX_PATH_MAX - FILE_POSIX_SUFFIX_MAX) {
+        return ULOG_OUTPUT_INVALID;
+    }
+    if (config == NULL) {
+        config = &config_default;
+    }
+    bool rotate       = config->rotate_bytes > 0 || config->rotate_sec > 0;
+    unsigned int keep = config->rotate_keep > 0 ? config->rotate_keep
+                                                : ULOG_FILE_POSIX_ROTATE_KEEP;
+
+    size_t size = config->buffer_size > 0 ? config->buffer_size
+                                          : ULOG_FILE_POSIX_BUFFER_SIZE;
+    size = (size + FILE_POSIX_ALIGN - 1) / FILE_POSIX_ALIGN * FILE_POSIX_ALIGN;
+    void *buf = NULL;
+    if (posix_memalign(&buf, FILE_POSIX_ALIGN, size) != 0) {
+        return ULOG_OUTPUT_INVALID;
+    }
+    char(*names)[FILE_POSIX_PATH_MAX] = NULL;
+    if (rotate && config->rotate_naming == ULOG_FILE_POSIX_NAMING_TIMESTAMP) {
+        names = calloc(keep, sizeof(*names));
+        if (names == NULL) {
+            free(buf);
+            return ULOG_OUTPUT_INVALID;
+        }
+    }
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        free(names);
+        free(buf);
+        return ULOG_OUTPUT_INVALID;
+    }
+    off_t written = lseek(fd, 0, SEEK_END);  // Appended to the existing file
+
+    // Reserve a slot
+    file_posix *f = NULL;
+    (void)pthread_mutex_lock(&file_mutex);
+    for (int i = 0; i < ULOG_FILE_POSIX_NUM && f == NULL; i++) {
+        if (!files[i].used) {
+            f  = &files[i];
+            *f = (file_posix){
+                .used          = true,
+                .output        = ULOG_OUTPUT_INVALID,
+                .fd            = fd,
+                .buf           = (char *)buf,
+                .size          = size,
+                .flush_bytes   = config->flush_bytes,
+                .flush_ms      = config->flush_ms,
+                .flush_level   = config->flush_level,
+                .rotate_bytes  = config->rotate_bytes,
+                .rotate_sec    = config->rotate_sec,
+                .rotate_keep   = rotate ? keep : 0,
+                .rotate_naming = config->rotate_naming,
+                .written       = written > 0 ? (size_t)written : 0,
+                .next_fd       = -1,
+                .old_fd        = -1,
+                .names         = names,
+            };
+            (void)snprintf(f->path, sizeof(f->path), "%s", path);
+            (void)snprintf(f->next_path, sizeof(f->next_path), "%s%s", path,
+                           FILE_POSIX_NEXT_SUFFIX);
+        }
+    }
+    (void)pthread_mutex_unlock(&file_mutex);
+    if (f == NULL) {
+        close(fd);
+        free(names);
+        free(buf);
+        return ULOG_OUTPUT_INVALID;  // All files are in use
+    }
+
+    if (rotate) {
+        f->next_fd = file_open_next(f);
+        f->rotate_at =
+            f->rotate_sec > 0 ? file_rotate_next_time(f->rotate_sec) : 0;
+    }
+    if (f->flush_ms > 0 || rotate) {
+        f->worker_running = true;
+        if (pthread_create(&f->worker, NULL, file_worker_main, f) != 0) {
+            f->worker_running = false;
+            (void)file_release(f);
+            return ULOG_OUTPUT_INVALID;
+        }
+    }
+
+    ulog_output_id output = ulog_output_add(file_handler, f, level);
+    if (output == ULOG_OUTPUT_INVALID) {
+        (void)file_release(f);
+        return ULOG_OUTPUT_INVALID;
+    }
+    (void)pthread_mutex_lock(&file_mutex);
+    f->output = output;
+    (void)pthread_mutex_unlock(&file_mutex);
+    return output;
+}
+
+/** @copydoc ulog_file_posix_flush */
+ulog_status ulog_file_posix_flush(ulog_output_id output) {
+    (void)pthread_mutex_lock(&file_mutex);
+    file_posix *f      = file_find(output);
+    ulog_status status = f != NULL ? file_write(f) : ULOG_STATUS_NOT_FOUND;
+    (void)pthread_mutex_unlock(&file_mutex);
+    return status;
+}
+
+/** @copydoc ulog_file_posix_close */
+ulog_status ulog_file_posix_close(ulog_output_id output) {
+    (void)pthread_mutex_lock(&file_mutex);
+    file_posix *f = file_find(output);
+    (void)pthread_mutex_unlock(&file_mutex);
+    if (f == NULL) {
+        return ULOG_STATUS_NOT_FOUND;
+    }
+
+    // Handlers may run until the output is removed; not found after cleanup
+    (void)ulog_output_remove(output);
+    return file_release(f);
+}
@@ -0,0 +1,110 @@
+// *************************************************************************
+//
+// microlog extension: buffered POSIX file output with flush policies
+//
+// Usage:
+//    #include "ulog_file_posix.h"
+//    ...
+//    ulog_file_posix_config config = ULOG_FILE_POSIX_CONFIG_DEFAULT;
+//    config.flush_ms = 100;  // Buffered lines are written within 100 ms
+//    ulog_output_id out = ulog_file_posix_open("app.log", ULOG_LEVEL_TRACE,
+//                                              &config);
+//    ulog_info("Buffered");
+//    ulog_error("Written to the file before the call returns");
+//    ...
+//    ulog_file_posix_close(out);  // Writes the rest of the buffer
+//
+// Rotation: with rotate_bytes or rotate_sec set, the file is rolled over to
+// "app.log.1" ... "app.log.<rotate_keep>" (or "app.log.<date>-<time>") and a
+// new "app.log" is started. The next file is opened ahead of time as
+// "app.log.next", so the logging call only swaps file descriptors; renames and
+// opens are done by the worker thread of the file.
+//
+// Requires ULOG_BUILD_EXTRA_OUTPUTS=1 (or ULOG_BUILD_DYNAMIC_CONFIG=1).
+//
+// *************************************************************************
+
+#pragma once
+#include <stddef.h>
+#include "ulog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ULOG_FILE_POSIX_NUM 4  ///< Files open at the same time
+
+/// @brief Default buffer size, also used when the configured size is 0
+#define ULOG_FILE_POSIX_BUFFER_SIZE (64u * 1024u)
+
+/// @brief Default number of rotated files, used when rotate_keep is 0
+#define ULOG_FILE_POSIX_ROTATE_KEEP 5u
+
+/// @brief Names of rotated files
+typedef enum {
+    ULOG_FILE_POSIX_NAMING_NUMBERED,   ///< path.1 (newest) to path.<keep>
+    ULOG_FILE_POSIX_NAMING_TIMESTAMP,  ///< path.YYYYmmdd-HHMMSS, local time
+} ulog_file_posix_naming;
+
+/**
+ * @brief Flush and rotation policy of a file. The buffer is written with
+ * write(2) when any of the flush conditions is met, and always when it is
+ * full. The file is rotated after a write that reaches rotate_bytes, or at
+ * multiples of rotate_sec since the epoch (rotate_sec 3600 - every full hour).
+ */
+typedef struct {
+    size_t buffer_size;      ///< Buffer size in bytes, 0 - default size
+    size_t flush_bytes;      ///< Write at this many buffered bytes, 0 - off
+    unsigned int flush_ms;   ///< Write the buffer every N ms, 0 - off
+    ulog_level flush_level;  ///< Write at once lines of this level and above
+
+    size_t rotate_bytes;       ///< Start a new file at this size, 0 - off
+    unsigned int rotate_sec;   ///< New file every N s of UTC time, 0 - off
+    unsigned int rotate_keep;  ///< Rotated files kept, 0 - default number
+    /// Names of rotated files
+    ulog_file_posix_naming rotate_naming;
+} ulog_file_posix_config;
+
+/// @brief Default policy: 64 KiB buffer, ERROR and FATAL written at once, no
+/// rotation
+#define ULOG_FILE_POSIX_CONFIG_DEFAULT                                         \
+    {ULOG_FILE_POSIX_BUFFER_SIZE, 0, 0, ULOG_LEVEL_ERROR, 0, 0, 0,             \
+     ULOG_FILE_POSIX_NAMING_NUMBERED}
+
+/**
+ * @brief Opens the file for appending and adds it as an output. Lines are the
+ * same as of ulog_output_add_file(). A line longer than the buffer is
+ * truncated. A worker thread is started if flush_ms or rotation is set.
+ * @param path File path, created if it does not exist.
+ * @param level Minimum log level for this output.
+ * @param config Flush and rotation policy, NULL -
+ * ULOG_FILE_POSIX_CONFIG_DEFAULT.
+ * @return Output handle on success, ULOG_OUTPUT_INVALID if the file cannot be
+ * opened, the path is too long, the buffer or thread cannot be created, or
+ * all files are in use.
+ */
+ulog_output_id ulog_file_posix_open(const char *path, ulog_level level,
+                                    const ulog_file_posix_config *config);
+
+/**
+ * @brief Writes the buffered lines to the file.
+ * @param output Handle returned by ulog_file_posix_open().
+ * @return ULOG_STATUS_OK on success, ULOG_STATUS_NOT_FOUND if the output is
+ * not a file of this extension, ULOG_STATUS_ERROR if write(2) failed; the
+ * buffered lines are dropped in this case.
+ */
+ulog_status ulog_file_posix_flush(ulog_output_id output);
+
+/**
+ * @brief Removes the output, writes the buffered lines and closes the file.
+ * Call it before ulog_cleanup(), which removes the output but leaves the file
+ * open.
+ * @param output Handle returned by ulog_file_posix_open().
+ * @return ULOG_STATUS_OK on success, ULOG_STATUS_NOT_FOUND if the output is
+ * not a file of this extension, ULOG_STATUS_ERROR if the last write failed.
+ */
+ulog_status ulog_file_posix_close(ulog_output_id output);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,220 @@
+// *************************************************************************
+//
+// microlog extension: in-memory flight recorder dumped on crashes
+// (implementation)
+//
+// Each slot carries a sequence number: 2 * n + 1 while line n is rendered
+// into it, 2 * n + 2 once the line is complete. A dump copies a slot and
+// keeps the copy only if the sequence was the expected even value before and
+// after the copy, so lines torn by a concurrent writer or by the crash itself
+// are skipped. A writer claims the slot only from a complete older line, so
+// two writers never render into the same slot.
+//
+// *************************************************************************
+
+#include "ulog_flight_posix.h"
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#if (ULOG_FLIGHT_POSIX_SLOTS & (ULOG_FLIGHT_POSIX_SLOTS - 1u)) != 0
+#error "ULOG_FLIGHT_POSIX_SLOTS must be a power of two"
+#endif
+
+#define FLIGHT_MASK (ULOG_FLIGHT_POSIX_SLOTS - 1u)
+
+typedef struct {
+    _Atomic uint64_t seq;
+    size_t len;
+    char text[ULOG_FLIGHT_POSIX_SLOT_SIZE];
+} flight_slot;
+
+static const int flight_signals[] = {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT};
+#define FLIGHT_SIGNAL_NUM (sizeof(flight_signals) / sizeof(flight_signals[0]))
+
+static flight_slot flight_ring[ULOG_FLIGHT_POSIX_SLOTS];
+static _Atomic uint64_t flight_head;  // Number of claimed slots
+
+static pthread_mutex_t flight_mutex = PTHREAD_MUTEX_INITIALIZER;
+static ulog_output_id flight_output = ULOG_OUTPUT_INVALID;
+static ulog_flight_posix_config flight_config;
+static struct sigaction flight_old_actions[FLIGHT_SIGNAL_NUM];
+
+/**
+ * @brief Output handler; renders the line into the next slot.
+ */
+static void flight_handler(ulog_event *ev, void *arg) {
+    (void)arg;
+    uint64_t n =
+        atomic_fetch_add_explicit(&flight_head, 1, memory_order_relaxed);
+    flight_slot *slot = &flight_ring[n & FLIGHT_MASK];
+
+    // A call a whole ring earlier may still be in the slot, drop the line
+    uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    if ((seq & 1u) != 0 || seq > 2 * n ||
+        !atomic_compare_exchange_strong_explicit(&slot->seq, &seq, 2 * n + 1,
+                                                 memory_order_acquire,
+                                                 memory_order_relaxed)) {
+        return;
+    }
+    atomic_thread_fence(memory_order_release);
+
+    size_t len = 0;
+    if (ulog_event_to_line(ev, slot->text, sizeof(slot->text), &len) !=
+            ULOG_STATUS_OK &&
+        len > 0) {
+        slot->text[len - 1] = '\n';  // Truncated, keep the line break
+    }
+    slot->len = len;
+    atomic_store_explicit(&slot->seq, 2 * n + 2, memory_order_release);
+
+    if (flight_config.dump_on_fatal &&
+        ulog_event_get_level(ev) == ULOG_LEVEL_FATAL) {
+        (void)ulog_flight_posix_dump(flight_config.dump_fd);
+    }
+}
+
+/**
+ * @brief Writes all bytes, retrying on EINTR. Async-signal-safe.
+ */
+static bool flight_write(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(fd, data, len);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        len -= (size_t)written;
+    }
+    return true;
+}
+
+/** @copydoc ulog_flight_posix_dump */
+ulog_status ulog_flight_posix_dump(int fd) {
+    int saved_errno = errno;  // Callable from signal handlers
+    uint64_t head = atomic_load_explicit(&flight_head, memory_order_acquire);
+    uint64_t n    = head > ULOG_FLIGHT_POSIX_SLOTS
+                        ? head - ULOG_FLIGHT_POSIX_SLOTS
+                        : 0;
+    ulog_status status = ULOG_STATUS_OK;
+    char line[ULOG_FLIGHT_POSIX_SLOT_SIZE];
+
+    for (; n < head && status == ULOG_STATUS_OK; n++) {
+        flight_slot *slot = &flight_ring[n & FLIGHT_MASK];
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq != 2 * n + 2) {
+            continue;  // Being written, or overwritten by a newer line
+        }
+        size_t len = slot->len;
+        if (len > sizeof(line)) {
+            continue;  // Torn by a newer line
+        }
+        memcpy(line, slot->text, len);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq) {
+            continue;  // Overwritten while copied
+        }
+        if (!flight_write(fd, line, len)) {
+            status = ULOG_STATUS_ERROR;
+        }
+    }
+    errno = saved_errno;
+    return status;
+}
+
+/**
+ * @brief Restores the previous handlers of the fatal signals. Locked, or
+ * from the signal handler.
+ */
+static void flight_restore_signals(void) {
+    for (size_t i = 0; i < FLIGHT_SIGNAL_NUM; i++) {
+        (void)sigaction(flight_signals[i], &flight_old_actions[i], NULL);
+    }
+}
+
+/**
+ * @brief Handler of the fatal signals; dumps the recorder and raises the
+ * signal again for the previous handler.
+ */
+static void flight_signal_handler(int sig) {
+    (void)ulog_flight_posix_dump(flight_config.dump_fd);
+    flight_restore_signals();
+    (void)raise(sig);  // Delivered when the handler returns
+}
+
+/**
+ * @brief Installs the handler of the fatal signals. Locked.
+ * @return false if a handler cannot be installed, none are left installed.
+ */
+static bool flight_install_signals(void) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = flight_signal_handler;
+    action.sa_flags   = SA_ONSTACK;  // Stack overflows if sigaltstack is set
+    (void)sigemptyset(&action.sa_mask);
+
+    for (size_t i = 0; i < FLIGHT_SIGNAL_NUM; i++) {
+        if (sigaction(flight_signals[i], &action, &flight_old_actions[i]) !=
+            0) {
+            for (size_t j = 0; j < i; j++) {
+                (void)sigaction(flight_signals[j], &flight_old_actions[j],
+                                NULL);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @copydoc ulog_flight_posix_open */
+ulog_output_id ulog_flight_posix_open(ulog_level level,
+                                      const ulog_flight_posix_config *config) {
+    ulog_flight_posix_config defaults = ULOG_FLIGHT_POSIX_CONFIG_DEFAULT;
+
+    (void)pthread_mutex_lock(&flight_mutex);
+    if (flight_output != ULOG_OUTPUT_INVALID) {
+        (void)pthread_mutex_unlock(&flight_mutex);
+        return ULOG_OUTPUT_INVALID;  // Only one ring
+    }
+    flight_config = config != NULL ? *config : defaults;
+    atomic_store_explicit(&flight_head, 0, memory_order_relaxed);
+    for (size_t i = 0; i < ULOG_FLIGHT_POSIX_SLOTS; i++) {
+        atomic_store_explicit(&flight_ring[i].seq, 0, memory_order_relaxed);
+    }
+
+    if (flight_config.dump_on_signal && !flight_install_signals()) {
+        (void)pthread_mutex_unlock(&flight_mutex);
+        return ULOG_OUTPUT_INVALID;
+    }
+    flight_output = ulog_output_add(flight_handler, NULL, level);
+    if (flight_output == ULOG_OUTPUT_INVALID && flight_config.dump_on_signal) {
+        flight_restore_signals();
+    }
+    ulog_output_id output = flight_output;
+    (void)pthread_mutex_unlock(&flight_mutex);
+    return output;
+}
+
+/** @copydoc ulog_flight_posix_close */
+ulog_status ulog_flight_posix_close(ulog_output_id output) {
+    (void)pthread_mutex_lock(&flight_mutex);
+    if (output == ULOG_OUTPUT_INVALID || output != flight_output) {
+        (void)pthread_mutex_unlock(&flight_mutex);
+        return ULOG_STATUS_NOT_FOUND;
+    }
+    // Not found after ulog_cleanup(), the recorder is closed anyway
+    (void)ulog_output_remove(output);
+    if (flight_config.dump_on_signal) {
+        flight_restore_signals();
+    }
+    flight_output = ULOG_OUTPUT_INVALID;
+    (void)pthread_mutex_unlock(&flight_mutex);
+    return ULOG_STATUS_OK;
+}
@@ -0,0 +1,89 @@
+// *************************************************************************
+//
+// microlog extension: in-memory flight recorder dumped on crashes
+//
+// Usage:
+//    #include "ulog_flight_posix.h"
+//    ...
+//    ulog_output_level_set(ULOG_OUTPUT_STDOUT, ULOG_LEVEL_INFO);
+//    ulog_output_id rec = ulog_flight_posix_open(ULOG_LEVEL_TRACE, NULL);
+//    ulog_trace("Kept in memory only");
+//    ...
+//    ulog_fatal("Out of memory");  // Last events are written to stderr
+//    ...
+//    ulog_flight_posix_dump(fd);   // At any time, also from signal handlers
+//    ulog_flight_posix_close(rec);
+//
+// The last ULOG_FLIGHT_POSIX_SLOTS lines are kept in a preallocated ring of
+// fixed size slots. A logging call claims a slot with an atomic increment
+// and renders the line into it; no lock and no system call. The line is
+// dropped if a call a whole ring earlier, e.g. one interrupted by a signal
+// handler that logs, is still writing that slot. Dumps
+// write the complete slots, oldest first, with write(2) only and are
+// async-signal-safe.
+//
+// Requires ULOG_BUILD_EXTRA_OUTPUTS=1 (or ULOG_BUILD_DYNAMIC_CONFIG=1).
+//
+// *************************************************************************
+
+#pragma once
+#include <stdbool.h>
+#include "ulog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ULOG_FLIGHT_POSIX_SLOTS
+#define ULOG_FLIGHT_POSIX_SLOTS 1024u  ///< Lines kept, a power of two
+#endif
+
+#ifndef ULOG_FLIGHT_POSIX_SLOT_SIZE
+#define ULOG_FLIGHT_POSIX_SLOT_SIZE 256u  ///< Longer lines are truncated
+#endif
+
+/**
+ * @brief When the recorder dumps itself.
+ */
+typedef struct {
+    int dump_fd;          ///< File descriptor of automatic dumps
+    bool dump_on_fatal;   ///< Dump after each FATAL line
+    bool dump_on_signal;  ///< Dump on SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT
+} ulog_flight_posix_config;
+
+/// @brief Default: dump to stderr on FATAL lines and fatal signals
+#define ULOG_FLIGHT_POSIX_CONFIG_DEFAULT {2, true, true}
+
+/**
+ * @brief Adds the recorder as an output. The ring is cleared. With
+ * dump_on_signal, handlers of the fatal signals are installed: they dump the
+ * recorder, restore the previous handlers and raise the signal again.
+ * @param level Minimum log level for the recorder, usually ULOG_LEVEL_TRACE.
+ * Messages below the level of all outputs are rejected early, so other
+ * outputs keep their own levels.
+ * @param config Dump policy, NULL - ULOG_FLIGHT_POSIX_CONFIG_DEFAULT.
+ * @return Output handle on success, ULOG_OUTPUT_INVALID if the recorder is
+ * already open or the output or signal handlers cannot be added.
+ */
+ulog_output_id ulog_flight_posix_open(ulog_level level,
+                                      const ulog_flight_posix_config *config);
+
+/**
+ * @brief Writes the recorded lines, oldest first. Async-signal-safe; lines
+ * being written at the same time are skipped.
+ * @param fd File descriptor to write to.
+ * @return ULOG_STATUS_OK on success, ULOG_STATUS_ERROR if write(2) failed.
+ */
+ulog_status ulog_flight_posix_dump(int fd);
+
+/**
+ * @brief Removes the output and restores the signal handlers.
+ * @param output Handle returned by ulog_flight_posix_open().
+ * @return ULOG_STATUS_OK on success, ULOG_STATUS_NOT_FOUND if the output is
+ * not the recorder.
+ */
+ulog_status ulog_flight_posix_close(ulog_output_id output);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,426 @@
+// *************************************************************************
+//
+// microlog extension: memory mapped segment files that survive crashes
+// (implementation)
+//
+// A segment is a preallocated file mapped with MAP_SHARED: a 64-byte header
+// followed by lines. The handler renders the line with ulog_event_to_line()
+// straight into the mapping and then stores the new end offset into the
+// header with release order. A reader that loads the offset with acquire
+// order sees whole lines only; bytes after the offset are an uncommitted
+// line of a process that died while writing it.
+//
+// A worker thread per output creates the next segment once half of the
+// current one is used and trims full segments, so the handler only swaps
+// mappings when a segment is full.
+//
+// *************************************************************************
+
+#include "ulog_mmap_posix.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MMAP_POSIX_MAGIC "ULOGSEG"  // With the terminating NUL, 8 bytes
+#define MMAP_POSIX_VERSION 1u
+#define MMAP_POSIX_HEADER_SIZE 64u
+#define MMAP_POSIX_PATH_MAX 512
+#define MMAP_POSIX_SUFFIX_MAX 16  // ".NNNNNN.seg"
+#define MMAP_POSIX_SEQUENCE_MAX 1000000u
+
+/// Segment header, MMAP_POSIX_HEADER_SIZE bytes
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t size;  // Preallocated size, the file is trimmed on close
+    uint64_t sequence;
+    _Atomic uint64_t commit;  // Bytes of committed lines after the header
+    _Atomic uint32_t closed;  // 1 - closed cleanly
+    uint8_t reserved[20];
+} mmap_posix_header;
+
+/// A mapped segment file
+typedef struct {
+    char *map;              // NULL - none
+    size_t pos;             // Committed bytes after the header
+    unsigned int sequence;  // Segment number
+    char path[MMAP_POSIX_PATH_MAX];
+} mmap_posix_segment;
+
+typedef struct {
+    bool used;              // Slot is taken
+    ulog_output_id output;  // ULOG_OUTPUT_INVALID until the output is added
+    size_t size;            // Segment size
+    mmap_posix_segment seg;   // Written by the handler, no map once closing
+    mmap_posix_segment next;  // Created ahead of time by the worker
+    mmap_posix_segment old;   // Full, unmapped and trimmed by the worker
+    bool next_wanted;         // Half of the segment is used, create the next
+    bool next_failed;         // The next segment could not be created
+    bool worker_running;
+    pthread_t worker;
+    char prefix[MMAP_POSIX_PATH_MAX];
+} mmap_posix;
+
+static mmap_posix mmaps[ULOG_MMAP_POSIX_NUM];
+static pthread_mutex_t mmap_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t mmap_wake   = PTHREAD_COND_INITIALIZER;
+
+static mmap_posix_header *mmap_header(mmap_posix_segment *seg) {
+    return (mmap_posix_header *)seg->map;
+}
+
+/**
+ * @brief Creates, allocates and maps the first unused segment from the
+ * sequence number on. Needs no lock: only reads the prefix and the size.
+ * @return false if no segment could be created.
+ */
+static bool mmap_segment_create(const mmap_posix *m, unsigned int sequence,
+                                mmap_posix_segment *seg) {
+    int fd = -1;
+    for (; sequence < MMAP_POSIX_SEQUENCE_MAX && fd < 0; sequence++) {
+        int n = snprintf(seg->path, sizeof(seg->path), "%s.%06u.seg",
+                         m->prefix, sequence);
+        if (n < 0 || (size_t)n >= sizeof(seg->path)) {
+            break;
+        }
+        fd = open(seg->path, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd < 0 && errno != EEXIST) {
+            break;
+        }
+    }
+    if (fd < 0) {
+        return false;
+    }
+
+    void *map = MAP_FAILED;
+    if (posix_fallocate(fd, 0, (off_t)m->size) == 0) {
+        map = mmap(NULL, m->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    (void)close(fd);  // The mapping keeps the file
+    if (map == MAP_FAILED) {
+        (void)unlink(seg->path);
+        return false;
+    }
+
+    seg->map      = (char *)map;
+    seg->pos      = 0;
+    seg->sequence = sequence - 1;
+
+    mmap_posix_header *header = mmap_header(seg);
+    header->version           = MMAP_POSIX_VERSION;
+    header->header_size       = MMAP_POSIX_HEADER_SIZE;
+    header->size              = m->size;
+    header->sequence          = seg->sequence;
+    atomic_store_explicit(&header->commit, 0, memory_order_relaxed);
+    atomic_store_explicit(&header->closed, 0, memory_order_relaxed);
+    memcpy(header->magic, MMAP_POSIX_MAGIC, sizeof(header->magic));
+    return true;
+}
+
+/**
+ * @brief Marks the segment as closed, unmaps it and trims the file to the
+ * committed lines.
+ */
+static void mmap_segment_close(const mmap_posix *m, mmap_posix_segment *seg) {
+    mmap_posix_header *header = mmap_header(seg);
+    atomic_store_explicit(&header->closed, 1, memory_order_release);
+    (void)munmap(seg->map, m->size);
+    seg->map = NULL;
+    (void)truncate(seg->path, (off_t)(MMAP_POSIX_HEADER_SIZE + seg->pos));
+}
+
+/**
+ * @brief Creates the next segment when it is wanted and closes the full one.
+ * Runs until the output is released; the mutex is released while files are
+ * created and trimmed.
+ */
+static void *mmap_worker_main(void *arg) {
+    mmap_posix *m = (mmap_posix *)arg;
+
+    (void)pthread_mutex_lock(&mmap_mutex);
+    while (m->worker_running) {
+        bool create =
+            m->next_wanted && m->next.map == NULL && !m->next_failed;
+        if (!create && m->old.map == NULL) {
+            (void)pthread_cond_wait(&mmap_wake, &mmap_mutex);
+            continue;
+        }
+        mmap_posix_segment old = m->old;
+        unsigned int sequence  = m->seg.sequence + 1;
+        m->old.map             = NULL;
+        (void)pthread_mutex_unlock(&mmap_mutex);
+
+        mmap_posix_segment next = {0};
+        bool created = create && mmap_segment_create(m, sequence, &next);
+        if (old.map != NULL) {
+            mmap_segment_close(m, &old);
+        }
+
+        (void)pthread_mutex_lock(&mmap_mutex);
+        if (create) {
+            m->next        = next;
+            m->next_failed = !created;
+            (void)pthread_cond_broadcast(&mmap_wake);  // A handler may wait
+        }
+    }
+    (void)pthread_mutex_unlock(&mmap_mutex);
+    return NULL;
+}
+
+/**
+ * @brief Continues in the next segment; waits for the worker only if it has
+ * not created it yet. The full segment is left to the worker. Locked.
+ * @return false if there is no next segment, the line is dropped.
+ */
+static bool mmap_rollover(mmap_posix *m) {
+    unsigned int sequence = m->seg.sequence;
+    m->next_wanted        = true;
+    (void)pthread_cond_broadcast(&mmap_wake);
+    while ((m->next.map == NULL || m->old.map != NULL) && !m->next_failed &&
+           m->worker_running && m->seg.sequence == sequence) {
+        (void)pthread_cond_wait(&mmap_wake, &mmap_mutex);
+    }
+    if (m->seg.map == NULL) {
+        return false;  // Stopped by another handler
+    }
+    if (m->seg.sequence != sequence) {
+        return true;  // Another handler has continued in the next segment
+    }
+    if (m->next_failed) {
+        mmap_segment_close(m, &m->seg);  // The output stops
+        return false;
+    }
+    if (m->next.map == NULL || m->old.map != NULL) {
+        return false;  // Closing
+    }
+
+    m->old         = m->seg;
+    m->seg         = m->next;
+    m->next.map    = NULL;
+    m->next_wanted = false;
+    (void)pthread_cond_broadcast(&mmap_wake);  // Close the full segment
+    return true;
+}
+
+/**
+ * @brief Output handler; writes the line into the mapping and commits it.
+ */
+static void mmap_handler(ulog_event *ev, void *arg) {
+    mmap_posix *m = (mmap_posix *)arg;
+
+    (void)pthread_mutex_lock(&mmap_mutex);
+    if (m->seg.map == NULL) {
+        (void)pthread_mutex_unlock(&mmap_mutex);
+        return;  // Closing, or the next segment could not be created
+    }
+
+    size_t data_size   = m->size - MMAP_POSIX_HEADER_SIZE;
+    char *end          = m->seg.map + MMAP_POSIX_HEADER_SIZE + m->seg.pos;
+    size_t len         = 0;
+    ulog_status status =
+        ulog_event_to_line(ev, end, data_size - m->seg.pos, &len);
+    if (status != ULOG_STATUS_OK && m->seg.pos > 0) {
+        // Segment is full, continue in the next one
+        if (!mmap_rollover(m)) {
+            (void)pthread_mutex_unlock(&mmap_mutex);
+            return;
+        }
+        end    = m->seg.map + MMAP_POSIX_HEADER_SIZE + m->seg.pos;
+        status = ulog_event_to_line(ev, end, data_size - m->seg.pos, &len);
+    }
+    if (status != ULOG_STATUS_OK && len > 0) {
+        end[len - 1] = '\n';  // Longer than a segment, keep the line break
+    }
+
+    m->seg.pos += len;
+    atomic_store_explicit(&mmap_header(&m->seg)->commit, m->seg.pos,
+                          memory_order_release);
+    if (!m->next_wanted && m->seg.pos >= data_size / 2) {
+        m->next_wanted = true;  // Let the worker create the next segment
+        (void)pthread_cond_broadcast(&mmap_wake);
+    }
+    (void)pthread_mutex_unlock(&mmap_mutex);
+}
+
+/**
+ * @brief Finds the state of the output. Locked.
+ */
+static mmap_posix *mmap_find(ulog_output_id output) {
+    for (int i = 0; i < ULOG_MMAP_POSIX_NUM; i++) {
+        mmap_posix *m = &mmaps[i];
+        if (m->used && m->output == output && output != ULOG_OUTPUT_INVALID) {
+            return m;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Stops the worker, closes the segments, removes the unused next one
+ * and frees the slot. The output must already be removed.
+ */
+static void mmap_release(mmap_posix *m) {
+    (void)pthread_mutex_lock(&mmap_mutex);
+    bool worker       = m->worker_running;
+    m->worker_running = false;
+    (void)pthread_cond_broadcast(&mmap_wake);
+    (void)pthread_mutex_unlock(&mmap_mutex);
+    if (worker) {
+        (void)pthread_join(m->worker, NULL);
+    }
+
+    (void)pthread_mutex_lock(&mmap_mutex);
+    if (m->old.map != NULL) {
+        mmap_segment_close(m, &m->old);
+    }
+    if (m->seg.map != NULL) {
+        mmap_segment_close(m, &m->seg);
+    }
+    if (m->next.map != NULL) {
+        (void)munmap(m->next.map, m->size);
+        m->next.map = NULL;
+        (void)unlink(m->next.path);
+    }
+    m->used = false;
+    (void)pthread_mutex_unlock(&mmap_mutex);
+}
+
+/** @copydoc ulog_mmap_posix_open */
+ulog_output_id ulog_mmap_posix_open(const char *prefix, size_t segment_size,
+                                    ulog_level level) {
+    if (prefix == NULL ||
+        strlen(prefix) >= MMAP_POSIX_PATH_MAX - MMAP_POSIX_SUFFIX_MAX) {
+        return ULOG_OUTPUT_INVALID;
+    }
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = (segment_size + page - 1) / page * page;
+    if (size < 2 * page) {
+        size = 2 * page;  // The header and at least a page of lines
+    }
+
+    mmap_posix *m = NULL;
+    (void)pthread_mutex_lock(&mmap_mutex);
+    for (int i = 0; i < ULOG_MMAP_POSIX_NUM && m == NULL; i++) {
+        if (!mmaps[i].used) {
+            m  = &mmaps[i];
+            *m = (mmap_posix){
+                .used   = true,
+                .output = ULOG_OUTPUT_INVALID,
+                .size   = size,
+            };
+            (void)snprintf(m->prefix, sizeof(m->prefix), "%s", prefix);
+            if (!mmap_segment_create(m, 0, &m->seg)) {
+                m->used = false;
+                m       = NULL;
+                break;
+            }
+        }
+    }
+    (void)pthread_mutex_unlock(&mmap_mutex);
+    if (m == NULL) {
+        return ULOG_OUTPUT_INVALID;  // No free slot or no segment
+    }
+
+    m->worker_running = true;
+    if (pthread_create(&m->worker, NULL, mmap_worker_main, m) != 0) {
+        m->worker_running = false;
+        mmap_release(m);
+        return ULOG_OUTPUT_INVALID;
+    }
+
+    ulog_output_id output = ulog_output_add(mmap_handler, m, level);
+    if (output == ULOG_OUTPUT_INVALID) {
+        mmap_release(m);
+        return ULOG_OUTPUT_INVALID;
+    }
+    (void)pthread_mutex_lock(&mmap_mutex);
+    m->output = output;
+    (void)pthread_mutex_unlock(&mmap_mutex);
+    return output;
+}
+
+/** @copydoc ulog_mmap_posix_close */
+ulog_status ulog_mmap_posix_close(ulog_output_id output) {
+    (void)pthread_mutex_lock(&mmap_mutex);
+    mmap_posix *m = mmap_find(output);
+    (void)pthread_mutex_unlock(&mmap_mutex);
+    if (m == NULL) {
+        return ULOG_STATUS_NOT_FOUND;
+    }
+
+    // Handlers may run until the output is removed; not found after cleanup
+    (void)ulog_output_remove(output);
+    mmap_release(m);
+    return ULOG_STATUS_OK;
+}
+
+/**
+ * @brief Length of the complete lines at the start of the data: up to the
+ * last line break before the first NUL byte.
+ */
+static size_t mmap_complete_lines(const char *data, size_t size) {
+    const char *nul = memchr(data, '\0', size);
+    size_t len      = nul != NULL ? (size_t)(nul - data) : size;
+    while (len > 0 && data[len - 1] != '\n') {
+        len--;
+    }
+    return len;
+}
+
+/** @copydoc ulog_mmap_posix_read */
+ulog_status ulog_mmap_posix_read(const char *segment, FILE *out, bool recover,
+                                 ulog_mmap_posix_info *info) {
+    if (segment == NULL || out == NULL) {
+        return ULOG_STATUS_INVALID_ARGUMENT;
+    }
+    int fd = open(segment, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return ULOG_STATUS_ERROR;
+    }
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)MMAP_POSIX_HEADER_SIZE) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    (void)close(fd);
+    if (map == MAP_FAILED) {
+        return ULOG_STATUS_ERROR;
+    }
+
+    const mmap_posix_header *header = (const mmap_posix_header *)map;
+    const char *data                = (const char *)map + MMAP_POSIX_HEADER_SIZE;
+    size_t data_size = (size_t)st.st_size - MMAP_POSIX_HEADER_SIZE;
+    uint64_t commit =
+        atomic_load_explicit(&header->commit, memory_order_acquire);
+    if (memcmp(header->magic, MMAP_POSIX_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != MMAP_POSIX_VERSION ||
+        header->header_size != MMAP_POSIX_HEADER_SIZE || commit > data_size) {
+        (void)munmap(map, (size_t)st.st_size);
+        return ULOG_STATUS_ERROR;  // Not a segment of this version
+    }
+
+    size_t recovered = 0;
+    if (recover) {
+        recovered = mmap_complete_lines(data + commit, data_size - commit);
+    }
+    ulog_status status = ULOG_STATUS_OK;
+    if (fwrite(data, 1, commit + recovered, out) != commit + recovered) {
+        status = ULOG_STATUS_ERROR;
+    }
+    if (info != NULL) {
+        info->sequence  = header->sequence;
+        info->committed = commit;
+        info->recovered = recovered;
+        info->closed    = atomic_load_explicit(&header->closed,
+                                               memory_order_acquire) != 0;
+    }
+    (void)munmap(map, (size_t)st.st_size);
+    return status;
+}
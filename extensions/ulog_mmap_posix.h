@@ -0,0 +1,89 @@
+// *************************************************************************
+//
+// microlog extension: memory mapped segment files that survive crashes
+//
+// Usage:
+//    #include "ulog_mmap_posix.h"
+//    ...
+//    ulog_output_id out = ulog_mmap_posix_open("/var/log/app", 16u << 20,
+//                                              ULOG_LEVEL_TRACE);
+//    ulog_info("In the page cache as soon as the call returns");
+//    ...
+//    ulog_mmap_posix_close(out);  // Trims the last segment
+//
+//    // After a crash, or with the ulog-mmap-read tool:
+//    ulog_mmap_posix_read("/var/log/app.000000.seg", stdout, true, NULL);
+//
+// Lines are written into shared mappings of preallocated segment files
+// "<prefix>.<NNNNNN>.seg". A line is committed by an atomic store of its end
+// offset into the segment header; the kernel writes the pages back even if
+// the process is killed, no fsync is done. Power loss is not covered.
+//
+// Requires ULOG_BUILD_EXTRA_OUTPUTS=1 (or ULOG_BUILD_DYNAMIC_CONFIG=1).
+//
+// *************************************************************************
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "ulog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ULOG_MMAP_POSIX_NUM 2  ///< Outputs open at the same time
+
+/**
+ * @brief State of a segment file, filled by ulog_mmap_posix_read().
+ */
+typedef struct {
+    unsigned long long sequence;  ///< Segment number
+    size_t committed;             ///< Bytes of committed lines
+    size_t recovered;             ///< Bytes of complete lines after them
+    bool closed;                  ///< false - not closed cleanly
+} ulog_mmap_posix_info;
+
+/**
+ * @brief Adds an output writing to segment files "<prefix>.<NNNNNN>.seg",
+ * numbered from the first unused number. A worker thread allocates and maps
+ * the next segment once half of the current one is used; the logging call
+ * only switches to it when the current one is full. Lines are the same as of
+ * ulog_output_add_file(); a line longer than a segment is truncated.
+ * @param prefix Path prefix of the segment files.
+ * @param segment_size Segment file size, rounded up to the page size.
+ * @param level Minimum log level for this output.
+ * @return Output handle on success, ULOG_OUTPUT_INVALID if the first segment
+ * cannot be created, the prefix is too long or all outputs are in use.
+ */
+ulog_output_id ulog_mmap_posix_open(const char *prefix, size_t segment_size,
+                                    ulog_level level);
+
+/**
+ * @brief Removes the output, marks the segment as closed and truncates it to
+ * the committed lines. A next segment created ahead of time is removed.
+ * @param output Handle returned by ulog_mmap_posix_open().
+ * @return ULOG_STATUS_OK on success, ULOG_STATUS_NOT_FOUND if the output is
+ * not an output of this extension.
+ */
+ulog_status ulog_mmap_posix_close(ulog_output_id output);
+
+/**
+ * @brief Writes the committed lines of a segment file. Works on segments
+ * being written and on segments left by a process that died.
+ * @param segment Segment file path.
+ * @param out Stream to write the lines to.
+ * @param recover true - also write the complete lines after the last
+ * committed one: lines written by a process killed before the commit.
+ * @param info Segment state, may be NULL.
+ * @return ULOG_STATUS_OK on success, ULOG_STATUS_INVALID_ARGUMENT for NULL
+ * arguments, ULOG_STATUS_ERROR if the file cannot be read or is not a
+ * segment file.
+ */
+ulog_status ulog_mmap_posix_read(const char *segment, FILE *out, bool recover,
+                                 ulog_mmap_posix_info *info);
+
+#ifdef __cplusplus
+}
+#endif
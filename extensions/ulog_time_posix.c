@@ -0,0 +1,177 @@
+// *************************************************************************
+//
+// microlog extension: POSIX clock sources for event time stamps
+// (implementation)
+//
+// Realtime clocks return nanoseconds since the epoch directly. Monotonic
+// clocks store their own value in the event and are converted with an offset
+// taken when the clock is enabled. The TSC clock stores raw CPU ticks, the
+// conversion to nanoseconds happens only when the time is printed.
+//
+// *************************************************************************
+
+#include "ulog_time_posix.h"
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TIME_POSIX_HAS_TSC 1
+#elif defined(__aarch64__)
+#define TIME_POSIX_HAS_TSC 1
+#else
+#define TIME_POSIX_HAS_TSC 0
+#endif
+
+#define TIME_POSIX_NS_PER_SEC 1000000000LL
+#define TIME_POSIX_CALIBRATION_NS 10000000LL  // 10 ms
+
+typedef struct {
+    clockid_t id;         // Clock read by clock_fn
+    long long anchor;     // Clock value (ns or ticks) at the anchor point
+    long long anchor_ns;  // Wall clock at the anchor point
+    double ns_per_tick;   // TSC only
+} time_posix_data;
+
+static time_posix_data posix_clock;
+
+/**
+ * @brief Reads a POSIX clock in nanoseconds, 0 on error.
+ */
+static long long clock_read_ns(clockid_t id) {
+    struct timespec ts;
+    if (clock_gettime(id, &ts) != 0) {
+        return 0;
+    }
+    return (long long)ts.tv_sec * TIME_POSIX_NS_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * @brief Clock function for all clock_gettime() based sources.
+ */
+static long long clock_fn(void *arg) {
+    time_posix_data *data = (time_posix_data *)arg;
+    return clock_read_ns(data->id);
+}
+
+/**
+ * @brief Converts a monotonic clock value to wall time.
+ */
+static long long clock_to_ns(long long stamp, void *arg) {
+    time_posix_data *data = (time_posix_data *)arg;
+    return data->anchor_ns + (stamp - data->anchor);
+}
+
+#if TIME_POSIX_HAS_TSC
+
+/**
+ * @brief Reads the CPU counter.
+ */
+static long long tsc_read(void) {
+#if defined(__aarch64__)
+    unsigned long long ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return (long long)ticks;
+#else
+    return (long long)__rdtsc();
+#endif
+}
+
+static long long tsc_fn(void *arg) {
+    (void)arg;
+    return tsc_read();
+}
+
+/**
+ * @brief Converts CPU ticks to wall time.
+ */
+static long long tsc_to_ns(long long stamp, void *arg) {
+    time_posix_data *data = (time_posix_data *)arg;
+
+    double delta_ns = (double)(stamp - data->anchor) * data->ns_per_tick;
+    return data->anchor_ns + (long long)delta_ns;
+}
+
+/**
+ * @brief Measures the counter rate.
+ * @return false if the counter does not advance.
+ */
+static bool tsc_calibrate(void) {
+#if defined(__aarch64__)
+    unsigned long long freq;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+    if (freq == 0) {
+        return false;
+    }
+    posix_clock.ns_per_tick = (double)TIME_POSIX_NS_PER_SEC / (double)freq;
+#else
+    long long start_ns    = clock_read_ns(CLOCK_MONOTONIC);
+    long long start_ticks = tsc_read();
+    long long end_ns      = start_ns;
+    while (end_ns - start_ns < TIME_POSIX_CALIBRATION_NS) {
+        end_ns = clock_read_ns(CLOCK_MONOTONIC);
+    }
+    long long ticks = tsc_read() - start_ticks;
+    if (ticks <= 0) {
+        return false;
+    }
+    posix_clock.ns_per_tick = (double)(end_ns - start_ns) / (double)ticks;
+#endif
+    return true;
+}
+
+#endif  // TIME_POSIX_HAS_TSC
+
+/**
+ * @brief Takes the anchor: a clock value and the wall clock at that moment.
+ */
+static void anchor_take(long long (*read)(void *), void *arg) {
+    posix_clock.anchor    = read(arg);
+    posix_clock.anchor_ns = clock_read_ns(CLOCK_REALTIME);
+}
+
+/** @copydoc ulog_time_posix_enable */
+ulog_status ulog_time_posix_enable(ulog_time_posix_clock clock) {
+    // Detach the current source before its data changes
+    ulog_status status = ulog_time_set_fn(NULL, NULL, NULL);
+    if (status != ULOG_STATUS_OK) {
+        return status;
+    }
+
+    switch (clock) {
+        case ULOG_TIME_POSIX_REALTIME:
+            posix_clock.id = CLOCK_REALTIME;
+            return ulog_time_set_fn(clock_fn, NULL, &posix_clock);
+
+        case ULOG_TIME_POSIX_REALTIME_COARSE:
+#ifdef CLOCK_REALTIME_COARSE
+            posix_clock.id = CLOCK_REALTIME_COARSE;
+            return ulog_time_set_fn(clock_fn, NULL, &posix_clock);
+#else
+            return ULOG_STATUS_DISABLED;
+#endif
+
+        case ULOG_TIME_POSIX_MONOTONIC:
+            posix_clock.id = CLOCK_MONOTONIC;
+            anchor_take(clock_fn, &posix_clock);
+            return ulog_time_set_fn(clock_fn, clock_to_ns, &posix_clock);
+
+        case ULOG_TIME_POSIX_TSC:
+#if TIME_POSIX_HAS_TSC
+            if (!tsc_calibrate()) {
+                return ULOG_STATUS_ERROR;
+            }
+            anchor_take(tsc_fn, NULL);
+            return ulog_time_set_fn(tsc_fn, tsc_to_ns, &posix_clock);
+#else
+            return ULOG_STATUS_DISABLED;
+#endif
+
+        default:
+            return ULOG_STATUS_INVALID_ARGUMENT;
+    }
+}
+
+/** @copydoc ulog_time_posix_disable */
+ulog_status ulog_time_posix_disable(void) {
+    return ulog_time_set_fn(NULL, NULL, NULL);
+}
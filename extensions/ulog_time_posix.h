@@ -0,0 +1,56 @@
+// *************************************************************************
+//
+// microlog extension: POSIX clock sources for event time stamps
+//
+// Usage:
+//    #include "ulog_time_posix.h"
+//    ...
+//    ulog_time_posix_enable(ULOG_TIME_POSIX_TSC);
+//    ulog_info("Time stamps from the CPU counter");
+//    ...
+//    ulog_time_posix_disable();  // Back to the default wall clock
+//
+// Requires ULOG_BUILD_TIME=1 (or ULOG_BUILD_DYNAMIC_CONFIG=1).
+//
+// *************************************************************************
+
+#pragma once
+#include "ulog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Clock sources. Monotonic clocks are anchored to the wall clock when
+ * enabled, so they print wall time but do not follow later clock changes.
+ */
+typedef enum {
+    ULOG_TIME_POSIX_REALTIME,         ///< clock_gettime(CLOCK_REALTIME)
+    ULOG_TIME_POSIX_REALTIME_COARSE,  ///< CLOCK_REALTIME_COARSE (Linux)
+    ULOG_TIME_POSIX_MONOTONIC,        ///< CLOCK_MONOTONIC
+    ULOG_TIME_POSIX_TSC,              ///< CPU counter (x86-64, AArch64)
+} ulog_time_posix_clock;
+
+/**
+ * @brief Sets the clock of event time stamps. The TSC clock stores raw ticks
+ * in the event and converts them to time only when the time is printed; it is
+ * calibrated against CLOCK_MONOTONIC here, which takes about 10 ms on x86-64.
+ * The TSC must be invariant (constant rate, synchronized between cores).
+ * @param clock Clock to use.
+ * @return ULOG_STATUS_OK on success, ULOG_STATUS_INVALID_ARGUMENT for an
+ * unknown clock, ULOG_STATUS_DISABLED if the clock is not available on this
+ * platform, ULOG_STATUS_BUSY if the lock cannot be acquired.
+ */
+ulog_status ulog_time_posix_enable(ulog_time_posix_clock clock);
+
+/**
+ * @brief Restores the default wall clock.
+ * @return ULOG_STATUS_OK on success, ULOG_STATUS_BUSY if the lock cannot be
+ * acquired.
+ */
+ulog_status ulog_time_posix_disable(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -23,6 +23,79 @@
 #include <stdint.h>
 #include <stdio.h>
 
+/* ============================================================================
+   Optional Feature: Configuration Header
+============================================================================ */
+
+// Included here (not only in ulog.c) so the logging macros below see the same
+// build options as the library, e.g. ULOG_BUILD_MIN_LEVEL.
+
+// clang-format off
+
+#ifdef ULOG_BUILD_CONFIG_HEADER_ENABLED
+
+    // If ULOG_BUILD_CONFIG_HEADER_ENABLED is defined, no other ULOG_BUILD_* macros should be defined to avoid conflicts
+    #ifdef ULOG_BUILD_COLOR
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_COLOR"
+    #endif
+    #ifdef ULOG_BUILD_PREFIX_SIZE
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_PREFIX_SIZE"
+    #endif
+    #ifdef ULOG_BUILD_EXTRA_OUTPUTS
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_EXTRA_OUTPUTS"
+    #endif
+    #ifdef ULOG_BUILD_SOURCE_LOCATION
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_SOURCE_LOCATION"
+    #endif
+    #ifdef ULOG_BUILD_LEVEL_SHORT
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_LEVEL_SHORT"
+    #endif
+    #ifdef ULOG_BUILD_TIME
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_TIME"
+    #endif
+    #ifdef ULOG_BUILD_TIME_PRECISION
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_TIME_PRECISION"
+    #endif
+    #ifdef ULOG_BUILD_TOPICS_MODE
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_TOPICS_MODE"
+    #endif
+    #ifdef ULOG_BUILD_DYNAMIC_CONFIG
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_DYNAMIC_CONFIG"
+    #endif
+    #ifdef ULOG_BUILD_WARN_NOT_ENABLED
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_WARN_NOT_ENABLED"
+    #endif
+    #ifdef ULOG_BUILD_MIN_LEVEL
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_MIN_LEVEL"
+    #endif
+    #ifdef ULOG_BUILD_ASYNC
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_ASYNC"
+    #endif
+    #ifdef ULOG_BUILD_KV_FIELDS
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_KV_FIELDS"
+    #endif
+    #ifdef ULOG_BUILD_BINARY_OUTPUT
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_BINARY_OUTPUT"
+    #endif
+    #ifdef ULOG_BUILD_SIGNAL_SAFE
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_SIGNAL_SAFE"
+    #endif
+    #ifdef ULOG_BUILD_FORMATTER
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_FORMATTER"
+    #endif
+    #ifdef ULOG_BUILD_RENDER_LINE_SIZE
+        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_RENDER_LINE_SIZE"
+    #endif
+
+    // The user provided configuration header
+    #ifndef ULOG_BUILD_CONFIG_HEADER_NAME
+        #define ULOG_BUILD_CONFIG_HEADER_NAME "ulog_config.h"
+    #endif
+
+    #include ULOG_BUILD_CONFIG_HEADER_NAME
+#endif // ULOG_BUILD_CONFIG_HEADER_ENABLED
+// clang-format on
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -66,6 +139,62 @@ typedef enum ulog_level_enum {
 #define ULOG_LEVEL_ERROR (ulog_level)4  ///< For failures
 #define ULOG_LEVEL_FATAL (ulog_level)5  ///< May terminate program
 
+/* ============================================================================
+   Optional Feature: Minimum Build Level
+============================================================================ */
+
+// clang-format off
+#ifdef ULOG_BUILD_MIN_LEVEL
+
+/// @brief True if messages of LEVEL are compiled in (ULOG_BUILD_MIN_LEVEL set)
+#define ULOG_LEVEL_IS_BUILT(LEVEL) ((int)(LEVEL) >= (int)(ULOG_BUILD_MIN_LEVEL))
+
+/// @brief Calls `ulog_log` only for levels at or above ULOG_BUILD_MIN_LEVEL.
+/// For constant lower levels the call and its arguments are removed by the
+/// compiler, but the arguments are still parsed and type-checked.
+#define ULOG_LOG_IF_BUILT(LEVEL, FILE, LINE, TOPIC, ...) \
+    (ULOG_LEVEL_IS_BUILT(LEVEL) ? ULOG_LOG_LITERAL_OR(ulog_log(LEVEL, FILE, LINE, TOPIC, __VA_ARGS__), NULL, LEVEL, FILE, LINE, TOPIC, ULOG_FIRST_ARG(__VA_ARGS__)) : (void)0)
+
+/// @brief Same as ULOG_LOG_IF_BUILT for `ulog_log_tid`
+#define ULOG_LOG_TID_IF_BUILT(LEVEL, ...) \
+    (ULOG_LEVEL_IS_BUILT(LEVEL) ? ulog_log_tid(LEVEL, __VA_ARGS__) : (void)0)
+
+#else  // ULOG_BUILD_MIN_LEVEL
+
+#define ULOG_LEVEL_IS_BUILT(LEVEL) (1)
+#define ULOG_LOG_IF_BUILT(LEVEL, FILE, LINE, TOPIC, ...) ULOG_LOG_LITERAL_OR(ulog_log(LEVEL, FILE, LINE, TOPIC, __VA_ARGS__), NULL, LEVEL, FILE, LINE, TOPIC, ULOG_FIRST_ARG(__VA_ARGS__))
+#define ULOG_LOG_TID_IF_BUILT(LEVEL, ...) ulog_log_tid(LEVEL, __VA_ARGS__)
+
+#endif  // ULOG_BUILD_MIN_LEVEL
+
+/* ============================================================================
+   Core: Literal Messages
+============================================================================ */
+
+#if defined(__GNUC__) || defined(__clang__)
+
+/// @brief First argument of the list, the format of the logging macros
+#define ULOG_FIRST_ARG(...) ULOG_FIRST_ARG_(__VA_ARGS__, 0)
+#define ULOG_FIRST_ARG_(FIRST, ...) FIRST
+
+/// @brief True if FMT is a non-empty string literal without '%', known at
+/// compile time. FMT is evaluated only if it is a constant.
+#define ULOG_IS_LITERAL(FMT) \
+    (__builtin_constant_p(__builtin_strchr((FMT), '%') == NULL) && \
+     __builtin_strchr((FMT), '%') == NULL && __builtin_strlen(FMT) > 0)
+
+/// @brief Logs a literal FMT as text of a known length with `ulog_log_message`,
+/// otherwise makes the printf-style CALL
+#define ULOG_LOG_LITERAL_OR(CALL, CS, LEVEL, FILE, LINE, TOPIC, FMT) \
+    (ULOG_IS_LITERAL(FMT) ? ulog_log_message(CS, LEVEL, FILE, LINE, TOPIC, (FMT), __builtin_strlen(FMT)) : CALL)
+
+#else
+
+#define ULOG_LOG_LITERAL_OR(CALL, ...) CALL
+
+#endif  // defined(__GNUC__) || defined(__clang__)
+// clang-format on
+
 typedef const char *ulog_level_names[ULOG_LEVEL_TOTAL];
 
 typedef struct {
@@ -150,7 +279,7 @@ ulog_level ulog_event_get_level(ulog_event *ev);
 /// @brief Get the timestamp from an event (requires ULOG_BUILD_TIME=1)
 /// @param ev Event to get timestamp from
 /// @return Pointer to struct tm with time information, or NULL if event is NULL
-///         or time feature disabled
+///         or time feature disabled. Owned by the event
 struct tm *ulog_event_get_time(ulog_event *ev);
 
 #endif  // ULOG_BUILD_DISABLED != 1
@@ -253,6 +382,40 @@ ulog_status ulog_prefix_set_fn(ulog_prefix_fn function);
 
 #endif  // ULOG_BUILD_DISABLED != 1
 
+/* ============================================================================
+   Feature: Time
+============================================================================ */
+
+/// @brief Clock function type (requires ULOG_BUILD_TIME=1 or
+///        ULOG_BUILD_DYNAMIC_CONFIG=1)
+/// @param arg User-provided argument passed to ulog_time_set_fn
+/// @return Time stamp in the units of the clock
+typedef long long (*ulog_time_fn)(void *arg);
+
+/// @brief Converts a time stamp of the clock to nanoseconds since the epoch.
+///        Called only when the time is printed or read from the event.
+/// @param stamp Time stamp returned by the clock function
+/// @param arg User-provided argument passed to ulog_time_set_fn
+/// @return Nanoseconds since the epoch (UTC)
+typedef long long (*ulog_time_to_ns_fn)(long long stamp, void *arg);
+
+#if ULOG_BUILD_DISABLED != 1
+
+/// @brief Sets the clock of event time stamps (requires ULOG_BUILD_TIME=1 or
+///        ULOG_BUILD_DYNAMIC_CONFIG=1). Set it before logging from several
+///        threads: the clock is called without the lock in async mode.
+/// @param function Clock function, or NULL to use the default wall clock
+/// @param to_ns Converter, or NULL if the clock returns nanoseconds since the
+///        epoch
+/// @param arg User-provided argument passed to both functions
+/// @return ULOG_STATUS_OK on success, ULOG_STATUS_BUSY if lock cannot be
+///         acquired, ULOG_STATUS_INVALID_ARGUMENT if to_ns is set without
+///         function
+ulog_status ulog_time_set_fn(ulog_time_fn function, ulog_time_to_ns_fn to_ns,
+                             void *arg);
+
+#endif  // ULOG_BUILD_DISABLED != 1
+
 /* ============================================================================
    Feature: Output
 ============================================================================ */
@@ -276,13 +439,14 @@ typedef void (*ulog_output_handler_fn)(ulog_event *ev, void *arg);
 /// @param output Output handle to configure
 /// @param level Minimum log level for this output
 /// @return ULOG_STATUS_OK on success, ULOG_STATUS_INVALID_ARGUMENT if invalid
-///         parameters, ULOG_STATUS_NOT_FOUND if output not found
+///         parameters, ULOG_STATUS_NOT_FOUND if output not found,
+///         ULOG_STATUS_BUSY if lock cannot be acquired
 ulog_status ulog_output_level_set(ulog_output_id output, ulog_level level);
 
 /// @brief Sets the minimum log level for all outputs
 /// @param level Minimum log level for all outputs
 /// @return ULOG_STATUS_OK on success, ULOG_STATUS_INVALID_ARGUMENT if invalid
-/// level
+/// level, ULOG_STATUS_BUSY if lock cannot be acquired
 ulog_status ulog_output_level_set_all(ulog_level level);
 
 /// @brief Adds a custom output handler (requires ULOG_BUILD_EXTRA_OUTPUTS>0
@@ -301,6 +465,39 @@ ulog_output_id ulog_output_add(ulog_output_handler_fn handler, void *arg,
 /// @return Output handle on success, ULOG_OUTPUT_INVALID on error
 ulog_output_id ulog_output_add_file(FILE *file, ulog_level level);
 
+/// @brief Writes the event to a buffer as a line of the file output: full
+/// time, no color, terminated by a new line (requires
+/// ULOG_BUILD_EXTRA_OUTPUTS>0 or ULOG_BUILD_DYNAMIC_CONFIG=1)
+/// @details For user defined outputs that buffer lines themselves.
+/// @param ev Event to convert
+/// @param out Output buffer to write to, null-terminated
+/// @param out_size Size of the output buffer
+/// @param len Length of the written line without the null, may be NULL
+/// @return ULOG_STATUS_OK on success, ULOG_STATUS_ERROR if the line did not fit
+/// and was truncated, ULOG_STATUS_INVALID_ARGUMENT if invalid parameters
+ulog_status ulog_event_to_line(ulog_event *ev, char *out, size_t out_size,
+                               size_t *len);
+
+/// @brief Adds a file output that writes each event as a JSON object on its
+/// own line (requires ULOG_BUILD_EXTRA_OUTPUTS>0 or ULOG_BUILD_DYNAMIC_CONFIG=1)
+/// @details Fields: time, level, topic, file, line, message and the key-value
+/// fields. Fields of disabled features are left out.
+/// @param file File pointer to write logs to (must remain valid)
+/// @param level Minimum log level for this file output
+/// @return Output handle on success, ULOG_OUTPUT_INVALID on error
+ulog_output_id ulog_output_add_json_file(FILE *file, ulog_level level);
+
+/// @brief Adds a file output that writes events in a compact binary format
+/// (requires ULOG_BUILD_BINARY_OUTPUT>0 and ULOG_BUILD_EXTRA_OUTPUTS>0)
+/// @details Formats, file, topic and level names are written once per file,
+/// arguments are written as they are, without formatting. The file is turned
+/// back into text by the `ulog-decode` tool (tools/ulog-decode). Up to 2
+/// binary outputs at a time.
+/// @param file File pointer opened in binary mode (must remain valid)
+/// @param level Minimum log level for this file output
+/// @return Output handle on success, ULOG_OUTPUT_INVALID on error
+ulog_output_id ulog_output_add_binary_file(FILE *file, ulog_level level);
+
 /// @brief Removes an output from the logging system (requires
 /// ULOG_BUILD_EXTRA_OUTPUTS>0 or ULOG_BUILD_DYNAMIC_CONFIG=1)
 /// @param output Output handle to remove
@@ -310,6 +507,333 @@ ulog_status ulog_output_remove(ulog_output_id output);
 
 #endif  // ULOG_BUILD_DISABLED != 1
 
+/* ============================================================================
+   Feature: Async
+============================================================================ */
+
+/// @brief What a logging call does when the async queue is full
+typedef enum {
+    ULOG_ASYNC_POLICY_DROP_NEWEST = 0,  ///< Drop the new event (default)
+    ULOG_ASYNC_POLICY_DROP_OLDEST,      ///< Drop the oldest queued event
+    ULOG_ASYNC_POLICY_BLOCK,            ///< Wait for the writer
+    ULOG_ASYNC_POLICY_BLOCK_TIMEOUT,    ///< Wait up to a timeout, then drop
+} ulog_async_policy;
+
+#if ULOG_BUILD_DISABLED != 1
+
+/// @brief Passes the events queued before the call to the outputs (requires
+/// ULOG_BUILD_ASYNC>0). Events queued meanwhile wait for the next call, so
+/// the lock is held for a bounded time. Call it from a single writer thread,
+/// e.g. the one started by the `ulog_async_pthread` extension.
+/// @return ULOG_STATUS_OK on success, ULOG_STATUS_BUSY if lock cannot be
+/// acquired, ULOG_STATUS_DISABLED if async mode is not built
+ulog_status ulog_async_flush(void);
+
+/// @brief Returns the number of queued events (requires ULOG_BUILD_ASYNC>0)
+/// @return Number of events waiting for `ulog_async_flush`
+size_t ulog_async_pending(void);
+
+/// @brief Returns the number of events dropped because the queue was full
+/// (requires ULOG_BUILD_ASYNC>0). Reset by `ulog_cleanup`.
+/// @return Number of dropped events
+size_t ulog_async_dropped(void);
+
+/// @brief Returns the number of dropped events of a level (requires
+/// ULOG_BUILD_ASYNC>0). Reset by `ulog_cleanup`.
+/// @param level Level of the dropped events
+/// @return Number of dropped events, 0 for an invalid level
+size_t ulog_async_dropped_by_level(ulog_level level);
+
+/// @brief Sets what logging calls do when the queue is full (requires
+/// ULOG_BUILD_ASYNC>0). Blocking policies wait for `ulog_async_flush`, so do
+/// not use them if the writer can be starved by the logging threads.
+/// @param policy Overflow policy
+/// @param timeout_ms Wait limit for ULOG_ASYNC_POLICY_BLOCK_TIMEOUT
+/// @return ULOG_STATUS_OK on success, ULOG_STATUS_INVALID_ARGUMENT if invalid
+/// policy
+ulog_status ulog_async_policy_set(ulog_async_policy policy,
+                                  unsigned int timeout_ms);
+
+/// @brief Enables a WARN event "N messages dropped" written by
+/// `ulog_async_flush` once the queue is drained (requires ULOG_BUILD_ASYNC>0)
+/// @param enabled True to enable, false to disable (default)
+/// @return ULOG_STATUS_OK on success
+ulog_status ulog_async_drop_report_set(bool enabled);
+
+#endif  // ULOG_BUILD_DISABLED != 1
+
+/* ============================================================================
+   Feature: Signal Safe Logging
+============================================================================ */
+
+#if ULOG_BUILD_DISABLED != 1
+
+/// @brief Registers a file descriptor for `ulog_log_signal_safe` (requires
+/// ULOG_BUILD_SIGNAL_SAFE>0). Registering it again changes the level. Not
+/// signal-safe itself: call it at start-up.
+/// @param fd File descriptor, e.g. 2 for stderr
+/// @param level Minimum log level written to this descriptor
+/// @return ULOG_STATUS_OK on success, ULOG_STATUS_INVALID_ARGUMENT if invalid
+/// descriptor or level, ULOG_STATUS_ERROR if ULOG_BUILD_SIGNAL_SAFE
+/// descriptors are registered, ULOG_STATUS_BUSY if lock cannot be acquired
+ulog_status ulog_signal_safe_fd_add(int fd, ulog_level level);
+
+/// @brief Unregisters a file descriptor (requires ULOG_BUILD_SIGNAL_SAFE>0)
+/// @param fd File descriptor
+/// @return ULOG_STATUS_OK on success, ULOG_STATUS_NOT_FOUND if not registered,
+/// ULOG_STATUS_BUSY if lock cannot be acquired
+ulog_status ulog_signal_safe_fd_remove(int fd);
+
+/// @brief Async-signal-safe logging function - typically called through the
+/// `ulog_signal_safe_*` macros. Formats the line into a stack buffer without
+/// the C library, takes no lock, and writes it with write(2) to the
+/// registered descriptors. Outputs, time, prefix and color are not used.
+/// Without ULOG_BUILD_SIGNAL_SAFE it does nothing.
+/// @param level Log level for this message
+/// @param file Source file name (usually __FILE__)
+/// @param line Source line number (usually __LINE__)
+/// @param topic Topic name string printed as is, or NULL for no topic
+/// @param message Printf-style format string, see the supported conversions
+/// in doc/features.md
+/// @param ... Format arguments for the message
+void ulog_log_signal_safe(ulog_level level, const char *file, int line,
+                          const char *topic, const char *message, ...);
+
+// clang-format off
+
+/// @brief Calls `ulog_log_signal_safe` for levels compiled in
+#define ULOG_LOG_SIGNAL_SAFE_IF_BUILT(LEVEL, ...) \
+    (ULOG_LEVEL_IS_BUILT(LEVEL) ? ulog_log_signal_safe(LEVEL, __FILE__, __LINE__, NULL, __VA_ARGS__) : (void)0)
+
+/// @brief Log a message from a signal handler, see `ulog_log_signal_safe`
+#define ulog_signal_safe(LEVEL, ...) ULOG_LOG_SIGNAL_SAFE_IF_BUILT(LEVEL, __VA_ARGS__)
+#define ulog_signal_safe_trace(...) ULOG_LOG_SIGNAL_SAFE_IF_BUILT(ULOG_LEVEL_TRACE, __VA_ARGS__)
+#define ulog_signal_safe_debug(...) ULOG_LOG_SIGNAL_SAFE_IF_BUILT(ULOG_LEVEL_DEBUG, __VA_ARGS__)
+#define ulog_signal_safe_info(...) ULOG_LOG_SIGNAL_SAFE_IF_BUILT(ULOG_LEVEL_INFO, __VA_ARGS__)
+#define ulog_signal_safe_warn(...) ULOG_LOG_SIGNAL_SAFE_IF_BUILT(ULOG_LEVEL_WARN, __VA_ARGS__)
+#define ulog_signal_safe_error(...) ULOG_LOG_SIGNAL_SAFE_IF_BUILT(ULOG_LEVEL_ERROR, __VA_ARGS__)
+#define ulog_signal_safe_fatal(...) ULOG_LOG_SIGNAL_SAFE_IF_BUILT(ULOG_LEVEL_FATAL, __VA_ARGS__)
+
+// clang-format on
+
+#endif  // ULOG_BUILD_DISABLED != 1
+
+/* ============================================================================
+   Core: Callsite
+============================================================================ */
+
+/// @brief Type of `ulog_callsite.state`: a C11 atomic where ulog.c uses C11
+/// atomics, the same size and alignment as `unsigned int`
+#if !defined(__cplusplus) && defined(__STDC_VERSION__) &&                      \
+    (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#define ULOG_CALLSITE_STATE _Atomic unsigned int
+#else
+#define ULOG_CALLSITE_STATE volatile unsigned int
+#endif
+
+/// @brief Per-callsite cache declared by the topic logging macros. Holds the
+/// resolved topic and the filtering decision for the configuration
+/// generation it was computed for. Do not access the fields directly.
+typedef struct {
+    ULOG_CALLSITE_STATE state;    ///< Generation, level and enabled flag
+    const char *topic_name;       ///< Topic name the cache was resolved for
+    unsigned int topic_hash;      ///< Hash of the topic name content
+    ulog_topic_id topic;          ///< Resolved topic ID
+    ulog_output_id output;        ///< Output the topic is routed to
+} ulog_callsite;
+
+/// @brief Initializer for `ulog_callsite`
+#define ULOG_CALLSITE_INIT {0u, NULL, 0u, ULOG_TOPIC_ID_INVALID, ULOG_OUTPUT_ALL}
+
+#if ULOG_BUILD_DISABLED != 1
+
+/// @brief Checks if a message from the callsite would be logged. After the
+/// first call it is a generation compare plus a cached flag, until any
+/// configuration (levels, outputs, topics, `ulog_*_config`) changes.
+/// @param cs Callsite cache
+/// @param level Log level of the message
+/// @param topic Topic name string, or NULL for no topic
+/// @return true if the message would be handled by at least one output
+bool ulog_callsite_is_enabled(ulog_callsite *cs, ulog_level level,
+                              const char *topic);
+
+/// @brief Logging function using the callsite cache - typically called
+/// through the topic macros
+/// @param cs Callsite cache
+/// @param level Log level for this message
+/// @param file Source file name (usually __FILE__)
+/// @param line Source line number (usually __LINE__)
+/// @param topic Topic name string, or NULL for no topic
+/// @param message Printf-style format string
+/// @param ... Format arguments for the message
+void ulog_log_callsite(ulog_callsite *cs, ulog_level level, const char *file,
+                       int line, const char *topic, const char *message, ...);
+
+/// @brief Logs a message that is already formatted, e.g. by the C++ front end
+/// (`ulog.hpp`), or a literal from the logging macros. The text is copied as
+/// is, `%` is not interpreted.
+/// @param cs Callsite cache, or NULL to filter without a cache
+/// @param level Log level for this message
+/// @param file Source file name (usually __FILE__)
+/// @param line Source line number (usually __LINE__)
+/// @param topic Topic name string, or NULL for no topic
+/// @param message Message text, NUL-terminated
+/// @param len Length of the text without the terminating NUL
+void ulog_log_message(ulog_callsite *cs, ulog_level level, const char *file,
+                      int line, const char *topic, const char *message,
+                      size_t len);
+
+// clang-format off
+
+/// @brief Logs through a hidden static callsite cache. Arguments are not
+/// evaluated if the message is filtered out.
+#define ULOG_LOG_CALLSITE(LEVEL, TOPIC_NAME, ...)                              \
+    do {                                                                       \
+        static ulog_callsite ulog_callsite_ = ULOG_CALLSITE_INIT;              \
+        const char *ulog_callsite_topic_    = (TOPIC_NAME);                    \
+        if (ULOG_LEVEL_IS_BUILT(LEVEL) &&                                      \
+            ulog_callsite_is_enabled(&ulog_callsite_, LEVEL,                   \
+                                     ulog_callsite_topic_)) {                  \
+            ULOG_LOG_LITERAL_OR(                                               \
+                ulog_log_callsite(&ulog_callsite_, LEVEL, __FILE__, __LINE__,  \
+                                  ulog_callsite_topic_, __VA_ARGS__),          \
+                &ulog_callsite_, LEVEL, __FILE__, __LINE__,                    \
+                ulog_callsite_topic_, ULOG_FIRST_ARG(__VA_ARGS__));            \
+        }                                                                      \
+    } while (0)
+
+// clang-format on
+
+#endif  // ULOG_BUILD_DISABLED != 1
+
+/* ============================================================================
+   Feature: Key-Value Fields
+============================================================================ */
+
+/// @brief Type of a key-value field
+typedef enum {
+    ULOG_KV_TYPE_INT,     ///< Signed integer, `value.i`
+    ULOG_KV_TYPE_UINT,    ///< Unsigned integer, `value.u`
+    ULOG_KV_TYPE_DOUBLE,  ///< Floating point, `value.d`
+    ULOG_KV_TYPE_BOOL,    ///< Boolean, `value.b`
+    ULOG_KV_TYPE_STR,     ///< NUL-terminated string, `value.s`
+} ulog_kv_type;
+
+/// @brief Typed key-value field of an event, see `ulog_kv_info`
+typedef struct {
+    const char *key;
+    ulog_kv_type type;
+    union {
+        long long i;
+        unsigned long long u;
+        double d;
+        bool b;
+        const char *s;
+    } value;
+} ulog_kv;
+
+// clang-format off
+
+static inline ulog_kv ulog_kv_make_int(const char *key, long long value)
+    { ulog_kv kv; kv.key = key; kv.type = ULOG_KV_TYPE_INT; kv.value.i = value; return kv; }
+
+static inline ulog_kv ulog_kv_make_uint(const char *key, unsigned long long value)
+    { ulog_kv kv; kv.key = key; kv.type = ULOG_KV_TYPE_UINT; kv.value.u = value; return kv; }
+
+static inline ulog_kv ulog_kv_make_double(const char *key, double value)
+    { ulog_kv kv; kv.key = key; kv.type = ULOG_KV_TYPE_DOUBLE; kv.value.d = value; return kv; }
+
+static inline ulog_kv ulog_kv_make_bool(const char *key, bool value)
+    { ulog_kv kv; kv.key = key; kv.type = ULOG_KV_TYPE_BOOL; kv.value.b = value; return kv; }
+
+static inline ulog_kv ulog_kv_make_str(const char *key, const char *value)
+    { ulog_kv kv; kv.key = key; kv.type = ULOG_KV_TYPE_STR; kv.value.s = value; return kv; }
+
+/// @brief Field constructors for the `ulog_kv_*` macros
+#define ULOG_KV_INT(KEY, VALUE) ulog_kv_make_int((KEY), (VALUE))
+#define ULOG_KV_UINT(KEY, VALUE) ulog_kv_make_uint((KEY), (VALUE))
+#define ULOG_KV_DOUBLE(KEY, VALUE) ulog_kv_make_double((KEY), (VALUE))
+#define ULOG_KV_BOOL(KEY, VALUE) ulog_kv_make_bool((KEY), (VALUE))
+#define ULOG_KV_STR(KEY, VALUE) ulog_kv_make_str((KEY), (VALUE))
+
+// clang-format on
+
+#if ULOG_BUILD_DISABLED != 1
+
+/// @brief Logs a message with key-value fields - typically called through the
+/// `ulog_kv_*` macros. Fields beyond ULOG_BUILD_KV_FIELDS are ignored; without
+/// ULOG_BUILD_KV_FIELDS the message is logged without fields.
+/// @param cs Callsite cache
+/// @param level Log level for this message
+/// @param file Source file name (usually __FILE__)
+/// @param line Source line number (usually __LINE__)
+/// @param topic Topic name string, or NULL for no topic
+/// @param message Message text, `%` is not interpreted
+/// @param fields Fields, valid during the call
+/// @param count Number of fields
+void ulog_log_kv(ulog_callsite *cs, ulog_level level, const char *file,
+                 int line, const char *topic, const char *message,
+                 const ulog_kv *fields, size_t count);
+
+/// @brief Get the number of key-value fields of an event
+/// @param ev Event
+/// @return Number of fields, 0 if event is NULL
+size_t ulog_event_get_kv_count(ulog_event *ev);
+
+/// @brief Get a key-value field of an event
+/// @param ev Event
+/// @param index Field index, below `ulog_event_get_kv_count`
+/// @return Field, valid while the event is handled, or NULL if out of range
+const ulog_kv *ulog_event_get_kv(ulog_event *ev, size_t index);
+
+// clang-format off
+
+/// @brief Logs through a hidden static callsite cache. Fields are not
+/// evaluated if the message is filtered out. At least one field is required.
+#define ULOG_LOG_KV(LEVEL, TOPIC_NAME, MESSAGE, ...)                           \
+    do {                                                                       \
+        static ulog_callsite ulog_callsite_ = ULOG_CALLSITE_INIT;              \
+        const char *ulog_callsite_topic_    = (TOPIC_NAME);                    \
+        if (ULOG_LEVEL_IS_BUILT(LEVEL) &&                                      \
+            ulog_callsite_is_enabled(&ulog_callsite_, LEVEL,                   \
+                                     ulog_callsite_topic_)) {                  \
+            const ulog_kv ulog_kv_fields_[] = {__VA_ARGS__};                   \
+            ulog_log_kv(&ulog_callsite_, LEVEL, __FILE__, __LINE__,            \
+                        ulog_callsite_topic_, (MESSAGE), ulog_kv_fields_,      \
+                        sizeof(ulog_kv_fields_) / sizeof(ulog_kv_fields_[0])); \
+        }                                                                      \
+    } while (0)
+
+/// @brief Log a message with key-value fields (requires ULOG_BUILD_KV_FIELDS>0
+/// or ULOG_BUILD_DYNAMIC_CONFIG=1)
+/// @param LEVEL Log level
+/// @param TOPIC_NAME Topic name string, or NULL for no topic
+/// @param MESSAGE Message text
+/// @param ... Fields: `ULOG_KV_INT("status", 200), ULOG_KV_STR("path", p)`
+#define ulog_kv_log(LEVEL, TOPIC_NAME, MESSAGE, ...) ULOG_LOG_KV(LEVEL, TOPIC_NAME, MESSAGE, __VA_ARGS__)
+
+/// @brief Log a TRACE level message with key-value fields (see `ulog_kv_log`)
+#define ulog_kv_trace(TOPIC_NAME, MESSAGE, ...) ULOG_LOG_KV(ULOG_LEVEL_TRACE, TOPIC_NAME, MESSAGE, __VA_ARGS__)
+
+/// @brief Log a DEBUG level message with key-value fields (see `ulog_kv_log`)
+#define ulog_kv_debug(TOPIC_NAME, MESSAGE, ...) ULOG_LOG_KV(ULOG_LEVEL_DEBUG, TOPIC_NAME, MESSAGE, __VA_ARGS__)
+
+/// @brief Log an INFO level message with key-value fields (see `ulog_kv_log`)
+#define ulog_kv_info(TOPIC_NAME, MESSAGE, ...) ULOG_LOG_KV(ULOG_LEVEL_INFO, TOPIC_NAME, MESSAGE, __VA_ARGS__)
+
+/// @brief Log a WARN level message with key-value fields (see `ulog_kv_log`)
+#define ulog_kv_warn(TOPIC_NAME, MESSAGE, ...) ULOG_LOG_KV(ULOG_LEVEL_WARN, TOPIC_NAME, MESSAGE, __VA_ARGS__)
+
+/// @brief Log an ERROR level message with key-value fields (see `ulog_kv_log`)
+#define ulog_kv_error(TOPIC_NAME, MESSAGE, ...) ULOG_LOG_KV(ULOG_LEVEL_ERROR, TOPIC_NAME, MESSAGE, __VA_ARGS__)
+
+/// @brief Log a FATAL level message with key-value fields (see `ulog_kv_log`)
+#define ulog_kv_fatal(TOPIC_NAME, MESSAGE, ...) ULOG_LOG_KV(ULOG_LEVEL_FATAL, TOPIC_NAME, MESSAGE, __VA_ARGS__)
+
+// clang-format on
+
+#endif  // ULOG_BUILD_DISABLED != 1
+
 /* ============================================================================
    Feature: Topics (2/2)
 ============================================================================ */
@@ -328,50 +852,76 @@ ulog_status ulog_output_remove(ulog_output_id output);
 /// @param LEVEL Log level
 /// @param TOPIC_NAME Topic name string
 /// @param ... Format string and arguments (printf-style)
-#define ulog_topic_log(LEVEL, TOPIC_NAME,...) ulog_log(LEVEL, __FILE__, __LINE__, TOPIC_NAME, __VA_ARGS__)
+#define ulog_topic_log(LEVEL, TOPIC_NAME,...) ULOG_LOG_CALLSITE(LEVEL, TOPIC_NAME, __VA_ARGS__)
 #define ulog_t(...) ulog_topic_log(__VA_ARGS__) // Alias for `ulog_topic_log`
 
 /// @brief Alias: `ulog_t_trace`. Log a TRACE level message with topic (requires ULOG_BUILD_TOPICS!=0 or
 /// ULOG_BUILD_DYNAMIC_CONFIG=1)
 /// @param TOPIC_NAME Topic name string
 /// @param ... Format string and arguments (printf-style)
-#define ulog_topic_trace(TOPIC_NAME, ...) ulog_log(ULOG_LEVEL_TRACE, __FILE__, __LINE__, TOPIC_NAME, __VA_ARGS__)
+#define ulog_topic_trace(TOPIC_NAME, ...) ULOG_LOG_CALLSITE(ULOG_LEVEL_TRACE, TOPIC_NAME, __VA_ARGS__)
 #define ulog_t_trace(...) ulog_topic_trace(__VA_ARGS__) // Alias for `ulog_topic_trace`
 
 /// @brief Alias: `ulog_t_debug`. Log a DEBUG level message with topic (requires ULOG_BUILD_TOPICS!=0 or
 /// ULOG_BUILD_DYNAMIC_CONFIG=1)
 /// @param TOPIC_NAME Topic name string
 /// @param ... Format string and arguments (printf-style)
-#define ulog_topic_debug(TOPIC_NAME, ...) ulog_log(ULOG_LEVEL_DEBUG, __FILE__, __LINE__, TOPIC_NAME, __VA_ARGS__)
+#define ulog_topic_debug(TOPIC_NAME, ...) ULOG_LOG_CALLSITE(ULOG_LEVEL_DEBUG, TOPIC_NAME, __VA_ARGS__)
 #define ulog_t_debug(...) ulog_topic_debug(__VA_ARGS__)  // Alias for `ulog_topic_debug`
 
 /// @brief Alias: `ulog_t_info`. Log an INFO level message with topic (requires ULOG_BUILD_TOPICS!=0 or
 /// ULOG_BUILD_DYNAMIC_CONFIG=1)
 /// @param TOPIC_NAME Topic name string
 /// @param ... Format string and arguments (printf-style)
-#define ulog_topic_info(TOPIC_NAME, ...) ulog_log(ULOG_LEVEL_INFO, __FILE__, __LINE__, TOPIC_NAME, __VA_ARGS__)
+#define ulog_topic_info(TOPIC_NAME, ...) ULOG_LOG_CALLSITE(ULOG_LEVEL_INFO, TOPIC_NAME, __VA_ARGS__)
 #define ulog_t_info(...) ulog_topic_info(__VA_ARGS__)  // Alias for `ulog_topic_info`
 
 /// @brief Alias: `ulog_t_warn`. Log a WARN level message with topic (requires ULOG_BUILD_TOPICS!=0 or
 /// ULOG_BUILD_DYNAMIC_CONFIG=1)
 /// @param TOPIC_NAME Topic name string
 /// @param ... Format string and arguments (printf-style)
-#define ulog_topic_warn(TOPIC_NAME, ...) ulog_log(ULOG_LEVEL_WARN, __FILE__, __LINE__, TOPIC_NAME, __VA_ARGS__)
+#define ulog_topic_warn(TOPIC_NAME, ...) ULOG_LOG_CALLSITE(ULOG_LEVEL_WARN, TOPIC_NAME, __VA_ARGS__)
 #define ulog_t_warn(...) ulog_topic_warn(__VA_ARGS__)  // Alias for `ulog_topic_warn`
 
 /// @brief Alias: `ulog_t_error`. Log an ERROR level message with topic (requires ULOG_BUILD_TOPICS!=0 or
 /// ULOG_BUILD_DYNAMIC_CONFIG=1)
 /// @param TOPIC_NAME Topic name string
 /// @param ... Format string and arguments (printf-style)
-#define ulog_topic_error(TOPIC_NAME, ...) ulog_log(ULOG_LEVEL_ERROR, __FILE__, __LINE__, TOPIC_NAME, __VA_ARGS__)
+#define ulog_topic_error(TOPIC_NAME, ...) ULOG_LOG_CALLSITE(ULOG_LEVEL_ERROR, TOPIC_NAME, __VA_ARGS__)
 #define ulog_t_error(...) ulog_topic_error(__VA_ARGS__)  // Alias for `ulog_topic_error`
 
 /// @brief Alias: `ulog_t_fatal`. Log a FATAL level message with topic (requires ULOG_BUILD_TOPICS!=0 or
 /// ULOG_BUILD_DYNAMIC_CONFIG=1)
 /// @param TOPIC_NAME Topic name string
 /// @param ... Format string and arguments (printf-style)
-#define ulog_topic_fatal(TOPIC_NAME, ...) ulog_log(ULOG_LEVEL_FATAL, __FILE__, __LINE__, TOPIC_NAME, __VA_ARGS__)
+#define ulog_topic_fatal(TOPIC_NAME, ...) ULOG_LOG_CALLSITE(ULOG_LEVEL_FATAL, TOPIC_NAME, __VA_ARGS__)
 #define ulog_t_fatal(...) ulog_topic_fatal(__VA_ARGS__)  // Alias for `ulog_topic_fatal`
+
+/// @brief Log a message with topic ID from `ulog_topic_add` or
+/// `ulog_topic_get_id`. No string lookup is done (requires ULOG_BUILD_TOPICS!=0
+/// or ULOG_BUILD_DYNAMIC_CONFIG=1)
+/// @param LEVEL Log level
+/// @param TOPIC_ID Topic ID
+/// @param ... Format string and arguments (printf-style)
+#define ulog_tid(LEVEL, TOPIC_ID, ...) ULOG_LOG_TID_IF_BUILT(LEVEL, __FILE__, __LINE__, TOPIC_ID, __VA_ARGS__)
+
+/// @brief Log a TRACE level message with topic ID (see `ulog_tid`)
+#define ulog_tid_trace(TOPIC_ID, ...) ULOG_LOG_TID_IF_BUILT(ULOG_LEVEL_TRACE, __FILE__, __LINE__, TOPIC_ID, __VA_ARGS__)
+
+/// @brief Log a DEBUG level message with topic ID (see `ulog_tid`)
+#define ulog_tid_debug(TOPIC_ID, ...) ULOG_LOG_TID_IF_BUILT(ULOG_LEVEL_DEBUG, __FILE__, __LINE__, TOPIC_ID, __VA_ARGS__)
+
+/// @brief Log an INFO level message with topic ID (see `ulog_tid`)
+#define ulog_tid_info(TOPIC_ID, ...) ULOG_LOG_TID_IF_BUILT(ULOG_LEVEL_INFO, __FILE__, __LINE__, TOPIC_ID, __VA_ARGS__)
+
+/// @brief Log a WARN level message with topic ID (see `ulog_tid`)
+#define ulog_tid_warn(TOPIC_ID, ...) ULOG_LOG_TID_IF_BUILT(ULOG_LEVEL_WARN, __FILE__, __LINE__, TOPIC_ID, __VA_ARGS__)
+
+/// @brief Log an ERROR level message with topic ID (see `ulog_tid`)
+#define ulog_tid_error(TOPIC_ID, ...) ULOG_LOG_TID_IF_BUILT(ULOG_LEVEL_ERROR, __FILE__, __LINE__, TOPIC_ID, __VA_ARGS__)
+
+/// @brief Log a FATAL level message with topic ID (see `ulog_tid`)
+#define ulog_tid_fatal(TOPIC_ID, ...) ULOG_LOG_TID_IF_BUILT(ULOG_LEVEL_FATAL, __FILE__, __LINE__, TOPIC_ID, __VA_ARGS__)
 // clang-format on
 
 /// @brief Adds a topic  (requires ULOG_BUILD_TOPICS!=0 or
@@ -413,31 +963,31 @@ ulog_topic_id ulog_topic_get_id(const char *topic_name);
 /// and `ulog_fatal`.
 /// @param level Log level for this message
 /// @param ... Format arguments for the message
-#define ulog(LEVEL,...) ulog_log(LEVEL, __FILE__, __LINE__, NULL, __VA_ARGS__)
+#define ulog(LEVEL,...) ULOG_LOG_IF_BUILT(LEVEL, __FILE__, __LINE__, NULL, __VA_ARGS__)
 
 /// @brief Log a TRACE level message
 /// @param ... Format string and arguments (printf-style)
-#define ulog_trace(...) ulog_log(ULOG_LEVEL_TRACE, __FILE__, __LINE__, NULL, __VA_ARGS__)
+#define ulog_trace(...) ULOG_LOG_IF_BUILT(ULOG_LEVEL_TRACE, __FILE__, __LINE__, NULL, __VA_ARGS__)
 
 /// @brief Log a DEBUG level message
 /// @param ... Format string and arguments (printf-style)
-#define ulog_debug(...) ulog_log(ULOG_LEVEL_DEBUG, __FILE__, __LINE__, NULL, __VA_ARGS__)
+#define ulog_debug(...) ULOG_LOG_IF_BUILT(ULOG_LEVEL_DEBUG, __FILE__, __LINE__, NULL, __VA_ARGS__)
 
 /// @brief Log an INFO level message
 /// @param ... Format string and arguments (printf-style)
-#define ulog_info(...) ulog_log(ULOG_LEVEL_INFO, __FILE__, __LINE__, NULL, __VA_ARGS__)
+#define ulog_info(...) ULOG_LOG_IF_BUILT(ULOG_LEVEL_INFO, __FILE__, __LINE__, NULL, __VA_ARGS__)
 
 /// @brief Log a WARN level message
 /// @param ... Format string and arguments (printf-style)
-#define ulog_warn(...) ulog_log(ULOG_LEVEL_WARN, __FILE__, __LINE__, NULL, __VA_ARGS__)
+#define ulog_warn(...) ULOG_LOG_IF_BUILT(ULOG_LEVEL_WARN, __FILE__, __LINE__, NULL, __VA_ARGS__)
 
 /// @brief Log an ERROR level message
 /// @param ... Format string and arguments (printf-style)
-#define ulog_error(...) ulog_log(ULOG_LEVEL_ERROR, __FILE__, __LINE__, NULL, __VA_ARGS__)
+#define ulog_error(...) ULOG_LOG_IF_BUILT(ULOG_LEVEL_ERROR, __FILE__, __LINE__, NULL, __VA_ARGS__)
 
 /// @brief Log a FATAL level message
 /// @param ... Format string and arguments (printf-style)
-#define ulog_fatal(...) ulog_log(ULOG_LEVEL_FATAL, __FILE__, __LINE__, NULL, __VA_ARGS__)
+#define ulog_fatal(...) ULOG_LOG_IF_BUILT(ULOG_LEVEL_FATAL, __FILE__, __LINE__, NULL, __VA_ARGS__)
 
 
 /// @brief Main logging function - typically called through macros
@@ -449,6 +999,17 @@ ulog_topic_id ulog_topic_get_id(const char *topic_name);
 /// @param ... Format arguments for the message
 void ulog_log(ulog_level level, const char *file,
               int line, const char *topic, const char *message, ...);
+
+/// @brief Logging function with topic ID - typically called through `ulog_tid`
+/// macros. Indexes the topic table directly, without string lookup.
+/// @param level Log level for this message
+/// @param file Source file name (usually __FILE__)
+/// @param line Source line number (usually __LINE__)
+/// @param topic Topic ID from `ulog_topic_add` or `ulog_topic_get_id`
+/// @param message Printf-style format string
+/// @param ... Format arguments for the message
+void ulog_log_tid(ulog_level level, const char *file,
+                  int line, ulog_topic_id topic, const char *message, ...);
               
 
 /// @brief Clean up all topic, outputs and other dynamic resources
@@ -477,6 +1038,30 @@ ulog_status ulog_cleanup(void);
 ULOG_STATIC_INLINE ulog_status ulog_cleanup(void) 
     { return ULOG_STATUS_DISABLED; }
     
+ULOG_STATIC_INLINE ulog_status ulog_async_flush(void) 
+    { return ULOG_STATUS_DISABLED; }
+    
+ULOG_STATIC_INLINE size_t ulog_async_pending(void) 
+    { return 0; }
+    
+ULOG_STATIC_INLINE size_t ulog_async_dropped(void) 
+    { return 0; }
+    
+ULOG_STATIC_INLINE size_t ulog_async_dropped_by_level(ulog_level level) 
+    { (void)level; return 0; }
+    
+ULOG_STATIC_INLINE ulog_status ulog_async_policy_set(ulog_async_policy policy, unsigned int timeout_ms) 
+    { (void)policy; (void)timeout_ms; return ULOG_STATUS_DISABLED; }
+    
+ULOG_STATIC_INLINE ulog_status ulog_async_drop_report_set(bool enabled) 
+    { (void)enabled; return ULOG_STATUS_DISABLED; }
+    
+ULOG_STATIC_INLINE ulog_status ulog_signal_safe_fd_add(int fd, ulog_level level) 
+    { (void)fd; (void)level; return ULOG_STATUS_DISABLED; }
+    
+ULOG_STATIC_INLINE ulog_status ulog_signal_safe_fd_remove(int fd) 
+    { (void)fd; return ULOG_STATUS_DISABLED; }
+    
 ULOG_STATIC_INLINE ulog_status ulog_color_config(bool enabled) 
     { (void)enabled; return ULOG_STATUS_DISABLED; }
     
@@ -500,6 +1085,9 @@ ULOG_STATIC_INLINE ulog_topic_id ulog_event_get_topic(ulog_event *ev)
     
 ULOG_STATIC_INLINE ulog_status ulog_event_to_cstr(ulog_event *ev, char *out, size_t out_size) 
     { (void)ev; (void)out; (void)out_size; return ULOG_STATUS_DISABLED; }
+
+ULOG_STATIC_INLINE ulog_status ulog_event_to_line(ulog_event *ev, char *out, size_t out_size, size_t *len) 
+    { (void)ev; (void)out; (void)out_size; (void)len; return ULOG_STATUS_DISABLED; }
     
 ULOG_STATIC_INLINE ulog_status ulog_level_config(ulog_level_config_style style) 
     { (void)style; return ULOG_STATUS_DISABLED; }
@@ -519,12 +1107,43 @@ ULOG_STATIC_INLINE ulog_status ulog_lock_set_fn(ulog_lock_fn function, void *loc
 ULOG_STATIC_INLINE void ulog_log(ulog_level level, const char *file, int line, const char *topic, const char *message, ...) 
     { (void)level; (void)file; (void)line; (void)topic; (void)message; }
     
+ULOG_STATIC_INLINE void ulog_log_tid(ulog_level level, const char *file, int line, ulog_topic_id topic, const char *message, ...) 
+    { (void)level; (void)file; (void)line; (void)topic; (void)message; }
+    
+ULOG_STATIC_INLINE void ulog_log_signal_safe(ulog_level level, const char *file, int line, const char *topic, const char *message, ...) 
+    { (void)level; (void)file; (void)line; (void)topic; (void)message; }
+    
+ULOG_STATIC_INLINE bool ulog_callsite_is_enabled(ulog_callsite *cs, ulog_level level, const char *topic) 
+    { (void)cs; (void)level; (void)topic; return false; }
+    
+ULOG_STATIC_INLINE void ulog_log_callsite(ulog_callsite *cs, ulog_level level, const char *file, int line, const char *topic, const char *message, ...) 
+    { (void)cs; (void)level; (void)file; (void)line; (void)topic; (void)message; }
+    
+ULOG_STATIC_INLINE void ulog_log_message(ulog_callsite *cs, ulog_level level, const char *file, int line, const char *topic, const char *message, size_t len) 
+    { (void)cs; (void)level; (void)file; (void)line; (void)topic; (void)message; (void)len; }
+    
+ULOG_STATIC_INLINE void ulog_log_kv(ulog_callsite *cs, ulog_level level, const char *file, int line, const char *topic, const char *message, const ulog_kv *fields, size_t count) 
+    { (void)cs; (void)level; (void)file; (void)line; (void)topic; (void)message; (void)fields; (void)count; }
+    
+ULOG_STATIC_INLINE size_t ulog_event_get_kv_count(ulog_event *ev) 
+    { (void)ev; return 0; }
+    
+ULOG_STATIC_INLINE const ulog_kv *ulog_event_get_kv(ulog_event *ev, size_t index) 
+    { (void)ev; (void)index; return NULL; }
+    
 ULOG_STATIC_INLINE ulog_output_id ulog_output_add(ulog_output_handler_fn handler, void *arg, ulog_level level) 
     { (void)handler; (void)arg; (void)level; return ULOG_OUTPUT_INVALID; }
     
 ULOG_STATIC_INLINE ulog_output_id ulog_output_add_file(FILE *file, ulog_level level) 
     { (void)file; (void)level; return ULOG_OUTPUT_INVALID; }
     
+ULOG_STATIC_INLINE ulog_output_id ulog_output_add_json_file(FILE *file, ulog_level level) 
+    { (void)file; (void)level; return ULOG_OUTPUT_INVALID; }
+    
+ULOG_STATIC_INLINE ulog_output_id ulog_output_add_binary_file(FILE *file, ulog_level level) 
+    { (void)file; (void)level; return ULOG_OUTPUT_INVALID; }
+    
+    
 ULOG_STATIC_INLINE ulog_status ulog_output_level_set(ulog_output_id output, ulog_level level) 
     { (void)output; (void)level; return ULOG_STATUS_DISABLED; }
     
@@ -537,6 +1156,9 @@ ULOG_STATIC_INLINE ulog_status ulog_output_remove(ulog_output_id output)
 ULOG_STATIC_INLINE ulog_status ulog_prefix_config(bool enabled) 
     { (void)enabled; return ULOG_STATUS_DISABLED; }
     
+ULOG_STATIC_INLINE ulog_status ulog_time_set_fn(ulog_time_fn function, ulog_time_to_ns_fn to_ns, void *arg) 
+    { (void)function; (void)to_ns; (void)arg; return ULOG_STATUS_DISABLED; }
+    
 ULOG_STATIC_INLINE ulog_status ulog_prefix_set_fn(ulog_prefix_fn function) 
     { (void)function; return ULOG_STATUS_DISABLED; }
     
@@ -582,6 +1204,27 @@ ULOG_STATIC_INLINE ulog_status ulog_topic_remove(const char *topic_name)
 #define ulog_t_error(...) ((void)0)
 #define ulog_t_fatal(...) ((void)0)
 #define ulog_t(...) ((void)0)
+#define ulog_tid_trace(...) ((void)0)
+#define ulog_tid_debug(...) ((void)0)
+#define ulog_tid_info(...) ((void)0)
+#define ulog_tid_warn(...) ((void)0)
+#define ulog_tid_error(...) ((void)0)
+#define ulog_tid_fatal(...) ((void)0)
+#define ulog_tid(...) ((void)0)
+#define ulog_kv_log(...) ((void)0)
+#define ulog_kv_trace(...) ((void)0)
+#define ulog_kv_debug(...) ((void)0)
+#define ulog_kv_info(...) ((void)0)
+#define ulog_kv_warn(...) ((void)0)
+#define ulog_kv_error(...) ((void)0)
+#define ulog_kv_fatal(...) ((void)0)
+#define ulog_signal_safe(...) ((void)0)
+#define ulog_signal_safe_trace(...) ((void)0)
+#define ulog_signal_safe_debug(...) ((void)0)
+#define ulog_signal_safe_info(...) ((void)0)
+#define ulog_signal_safe_warn(...) ((void)0)
+#define ulog_signal_safe_error(...) ((void)0)
+#define ulog_signal_safe_fatal(...) ((void)0)
 
 #undef ULOG_STATIC_INLINE // not to expose it
 // clang-format on
@@ -0,0 +1,327 @@
+// *************************************************************************
+//
+// ulog v@ULOG_VERSION@  - C++ front end
+// https://github.com/an-dr/microlog
+//
+// *************************************************************************
+//
+// Type-safe logging functions for C++20. Format strings use `{}` placeholders
+// and are checked at compile time: a placeholder count that does not match the
+// arguments, or an argument type that cannot be printed, is a compile error.
+// Messages are written into a stack buffer without printf and passed to the
+// outputs, topics and levels of ulog.c via `ulog_log_message`.
+//
+//    #include "ulog.hpp"
+//    ...
+//    ulog::info("Connected to {}:{}", host, port);
+//    ulog::topic_warn("net", "Retry {} of {}", attempt, 3);
+//
+// Copyright (c) 2025 Andrei Gramakov. All rights reserved.
+//
+// This file is licensed under the terms of the MIT license.
+// For a copy, see: https://opensource.org/licenses/MIT
+//
+// *************************************************************************
+
+#pragma once
+
+#include "ulog.h"
+
+#if __cplusplus < 202002L
+#error "ulog.hpp requires C++20"
+#endif
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <source_location>
+#include <string_view>
+#include <type_traits>
+
+/// @brief Message buffer size of the C++ front end, longer messages are
+/// truncated
+#ifndef ULOG_HPP_MESSAGE_SIZE
+#define ULOG_HPP_MESSAGE_SIZE 256
+#endif
+
+namespace ulog {
+namespace detail {
+
+/* ============================================================================
+   Message Buffer
+============================================================================ */
+
+/// @brief Fixed-size message text, truncated when full
+class buffer {
+  public:
+    void append(const char *data, std::size_t size) {
+        std::size_t room = capacity - len_;
+        if (size > room) {
+            size = room;  // Truncate
+        }
+        std::memcpy(data_ + len_, data, size);
+        len_ += size;
+    }
+
+    void append(char c) {
+        if (len_ < capacity) {
+            data_[len_++] = c;
+        }
+    }
+
+    const char *c_str() {
+        data_[len_] = '\0';
+        return data_;
+    }
+
+    std::size_t size() const {
+        return len_;
+    }
+
+  private:
+    static constexpr std::size_t capacity = ULOG_HPP_MESSAGE_SIZE - 1;
+    char data_[ULOG_HPP_MESSAGE_SIZE];
+    std::size_t len_ = 0;
+};
+
+/* ============================================================================
+   Argument Writers
+============================================================================ */
+
+template <typename T>
+using plain = std::remove_cvref_t<T>;
+
+template <typename T>
+inline constexpr bool is_c_string =
+    std::is_same_v<std::decay_t<T>, const char *> ||
+    std::is_same_v<std::decay_t<T>, char *>;
+
+/// @brief Types accepted as `{}` arguments
+template <typename T>
+concept formattable =
+    std::is_arithmetic_v<plain<T>> || std::is_enum_v<plain<T>> ||
+    is_c_string<T> || std::is_convertible_v<const plain<T> &,
+                                            std::string_view> ||
+    std::is_pointer_v<std::decay_t<T>> || std::is_null_pointer_v<plain<T>>;
+
+template <typename T>
+void write_number(buffer &buf, T value) {
+    char tmp[64];
+    auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+    buf.append(tmp, static_cast<std::size_t>(result.ptr - tmp));
+}
+
+/// @brief Writes one argument, chosen at compile time by its type
+template <formattable T>
+void write(buffer &buf, const T &value) {
+    using U = plain<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        value ? buf.append("true", 4) : buf.append("false", 5);
+    } else if constexpr (std::is_same_v<U, char>) {
+        buf.append(value);
+    } else if constexpr (std::is_arithmetic_v<U>) {
+        write_number(buf, value);
+    } else if constexpr (std::is_enum_v<U>) {
+        write_number(buf, static_cast<std::underlying_type_t<U>>(value));
+    } else if constexpr (is_c_string<T>) {
+        const char *str = value;
+        str != nullptr ? buf.append(str, std::strlen(str))
+                       : buf.append("NULL", 4);
+    } else if constexpr (std::is_convertible_v<const U &, std::string_view>) {
+        std::string_view str = value;
+        buf.append(str.data(), str.size());
+    } else {
+        // Pointers, same as "%p" on glibc
+        char tmp[2 + 2 * sizeof(std::uintptr_t)];
+        auto address = reinterpret_cast<std::uintptr_t>(
+            static_cast<const void *>(value));
+        auto result = std::to_chars(tmp + 2, tmp + sizeof(tmp), address, 16);
+        tmp[0]      = '0';
+        tmp[1]      = 'x';
+        buf.append(tmp, static_cast<std::size_t>(result.ptr - tmp));
+    }
+}
+
+/* ============================================================================
+   Format String
+============================================================================ */
+
+/// @brief Not constexpr: calling it while parsing a format string at compile
+/// time makes the call a compile error that names the problem
+void format_error_placeholder_is_not_empty_braces();
+void format_error_more_placeholders_than_arguments();
+void format_error_fewer_placeholders_than_arguments();
+void format_error_unmatched_closing_brace();
+
+/// @brief Literal text before a placeholder or the end of the format
+struct segment {
+    std::size_t begin;
+    std::size_t size;
+    bool escaped;  // Contains "{{" or "}}", printed as "{" and "}"
+};
+
+/// @brief Format string split into literal segments and argument slots at
+/// compile time, along with the location of the logging call
+template <typename... Args>
+class format {
+  public:
+    template <std::size_t N>
+    consteval format(const char (&text)[N], std::source_location location =
+                                                std::source_location::current())
+        : text_(text, N - 1), location_(location) {
+        std::size_t slot  = 0;
+        std::size_t begin = 0;
+        bool escaped      = false;
+        for (std::size_t i = 0; i < N - 1; i++) {
+            char next = i + 1 < N - 1 ? text[i + 1] : '\0';
+            if ((text[i] == '{' && next == '{') ||
+                (text[i] == '}' && next == '}')) {
+                escaped = true;
+                i++;
+            } else if (text[i] == '{') {
+                if (next != '}') {
+                    format_error_placeholder_is_not_empty_braces();
+                }
+                if (slot == sizeof...(Args)) {
+                    format_error_more_placeholders_than_arguments();
+                }
+                segments_[slot++] = {begin, i - begin, escaped};
+                begin             = i + 2;
+                escaped           = false;
+                i++;
+            } else if (text[i] == '}') {
+                format_error_unmatched_closing_brace();
+            }
+        }
+        if (slot != sizeof...(Args)) {
+            format_error_fewer_placeholders_than_arguments();
+        }
+        segments_[slot] = {begin, N - 1 - begin, escaped};
+    }
+
+    /// @brief Writes the message: segments and arguments in turn
+    void write_to(buffer &buf, const Args &...args) const {
+        std::size_t slot = 0;
+        ((write_segment(buf, segments_[slot++]), write(buf, args)), ...);
+        write_segment(buf, segments_[sizeof...(Args)]);
+    }
+
+    const std::source_location &location() const {
+        return location_;
+    }
+
+  private:
+    void write_segment(buffer &buf, const segment &seg) const {
+        const char *data = text_.data() + seg.begin;
+        if (!seg.escaped) {
+            buf.append(data, seg.size);
+            return;
+        }
+        for (std::size_t i = 0; i < seg.size; i++) {
+            buf.append(data[i]);
+            if (data[i] == '{' || data[i] == '}') {
+                i++;  // Skip the second brace
+            }
+        }
+    }
+
+    std::string_view text_;
+    std::array<segment, sizeof...(Args) + 1> segments_{};
+    std::source_location location_;
+};
+
+/* ============================================================================
+   Callsite Cache
+============================================================================ */
+
+/// @brief Callsite cache of one logging call. `Tag` is a type unique to the
+/// call, so each call gets its own static, as with the C macros.
+template <typename Tag>
+inline ulog_callsite callsite = ULOG_CALLSITE_INIT;
+
+/// @brief Checks the callsite cache for a level and logs the formatted text
+template <ulog_level Level, typename... Args>
+void log(ulog_callsite &cs, const char *topic, const format<Args...> &fmt,
+         const Args &...args) {
+    if (!ULOG_LEVEL_IS_BUILT(Level)) {
+        return;
+    }
+    if (!ulog_callsite_is_enabled(&cs, Level, topic)) {
+        return;  // Filtered out: nothing is formatted
+    }
+    buffer buf;
+    fmt.write_to(buf, args...);
+    ulog_log_message(&cs, Level, fmt.location().file_name(),
+                     static_cast<int>(fmt.location().line()), topic,
+                     buf.c_str(), buf.size());
+}
+
+}  // namespace detail
+
+/// @brief Compile-time checked format string for the given argument types
+template <typename... Args>
+using format_string = detail::format<std::type_identity_t<Args>...>;
+
+/* ============================================================================
+   Logging Functions
+============================================================================ */
+
+// `Tag` defaults to the type of a new lambda at each call, giving the call its
+// own callsite cache. Do not pass it.
+
+// clang-format off
+
+/// @brief Log a TRACE level message, `{}` placeholders
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void trace(format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_TRACE>(detail::callsite<Tag>, nullptr, fmt, args...); }
+
+/// @brief Log a DEBUG level message, `{}` placeholders
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void debug(format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_DEBUG>(detail::callsite<Tag>, nullptr, fmt, args...); }
+
+/// @brief Log an INFO level message, `{}` placeholders
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void info(format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_INFO>(detail::callsite<Tag>, nullptr, fmt, args...); }
+
+/// @brief Log a WARN level message, `{}` placeholders
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void warn(format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_WARN>(detail::callsite<Tag>, nullptr, fmt, args...); }
+
+/// @brief Log an ERROR level message, `{}` placeholders
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void error(format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_ERROR>(detail::callsite<Tag>, nullptr, fmt, args...); }
+
+/// @brief Log a FATAL level message, `{}` placeholders
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void fatal(format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_FATAL>(detail::callsite<Tag>, nullptr, fmt, args...); }
+
+/// @brief Log a TRACE level message with topic (requires ULOG_BUILD_TOPICS!=0
+/// or ULOG_BUILD_DYNAMIC_CONFIG=1)
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void topic_trace(const char *topic, format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_TRACE>(detail::callsite<Tag>, topic, fmt, args...); }
+
+/// @brief Log a DEBUG level message with topic
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void topic_debug(const char *topic, format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_DEBUG>(detail::callsite<Tag>, topic, fmt, args...); }
+
+/// @brief Log an INFO level message with topic
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void topic_info(const char *topic, format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_INFO>(detail::callsite<Tag>, topic, fmt, args...); }
+
+/// @brief Log a WARN level message with topic
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void topic_warn(const char *topic, format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_WARN>(detail::callsite<Tag>, topic, fmt, args...); }
+
+/// @brief Log an ERROR level message with topic
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void topic_error(const char *topic, format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_ERROR>(detail::callsite<Tag>, topic, fmt, args...); }
+
+/// @brief Log a FATAL level message with topic
+template <detail::formattable... Args, typename Tag = decltype([] {})>
+void topic_fatal(const char *topic, format_string<Args...> fmt, const Args &...args) { detail::log<ULOG_LEVEL_FATAL>(detail::callsite<Tag>, topic, fmt, args...); }
+
+// clang-format on
+
+}  // namespace ulog
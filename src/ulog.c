@@ -33,12 +33,22 @@
 | ULOG_BUILD_SOURCE_LOCATION       | 1                          | ULOG_HAS_SOURCE_LOCATION  | File\:line output        |
 | ULOG_BUILD_LEVEL_SHORT           | 0                          | ULOG_LEVEL_HAS_SHORT/_LONG| Short level style        |
 | ULOG_BUILD_TIME                  | 0                          | ULOG_HAS_TIME             | Timestamp support        |
+| ULOG_BUILD_TIME_PRECISION        | 0                          | -                         | Sub-second digits        |
 | ULOG_BUILD_TOPICS_MODE           | ULOG_BUILD_TOPICS_MODE_OFF | ULOG_HAS_TOPICS           | Topics mode              |
 | ULOG_BUILD_TOPICS_STATIC_NUM     | 0                          | -                         | Topic number             |
 | ULOG_BUILD_DYNAMIC_CONFIG        | 0                          | ULOG_HAS_DYNAMIC_CONFIG   | Runtime toggles          |
 | ULOG_BUILD_WARN_NOT_ENABLED      | 1                          | ULOG_HAS_WARN_NOT_ENABLED | Warning stubs            |
 | ULOG_BUILD_CONFIG_HEADER_ENABLED | 0                          | -                         | Configuration header mode|
 | ULOG_BUILD_CONFIG_HEADER_NAME    | "ulog_config.h"            | -                         | Configuration header name|
+| ULOG_BUILD_MIN_LEVEL             | -                          | ULOG_LEVEL_IS_BUILT       | Strip lower level macros |
+| ULOG_BUILD_ASYNC                 | 0                          | ULOG_HAS_ASYNC            | Async queue slots        |
+| ULOG_BUILD_ASYNC_MESSAGE_SIZE    | 128                        | -                         | Async message size       |
+| ULOG_BUILD_KV_FIELDS             | 0                          | ULOG_HAS_KV               | Key-value fields / event |
+| ULOG_BUILD_BINARY_OUTPUT         | 0                          | ULOG_HAS_BINARY           | Binary dictionary size   |
+| ULOG_BUILD_FORMATTER             | 0                          | ULOG_HAS_FORMATTER        | Built-in formatter       |
+| ULOG_BUILD_SIGNAL_SAFE           | 0                          | ULOG_HAS_SIGNAL_SAFE      | Signal-safe descriptors  |
+| ULOG_BUILD_SIGNAL_SAFE_LINE_SIZE | 256                        | -                         | Signal-safe line size    |
+| ULOG_BUILD_RENDER_LINE_SIZE      | 0                          | ULOG_HAS_RENDER_CACHE     | Shared line size         |
 | ULOG_BUILD_DISABLED              | 0                          | -                         | Disable ulog completely  |
 
 ===================================================================================================================== */
@@ -53,44 +63,8 @@
    Optional Feature: Configuration Header
 ============================================================================ */
 
-#ifdef ULOG_BUILD_CONFIG_HEADER_ENABLED
-
-    // If ULOG_BUILD_CONFIG_HEADER_ENABLED is defined, no other ULOG_BUILD_* macros should be defined to avoid conflicts
-    #ifdef ULOG_BUILD_COLOR
-        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_COLOR"
-    #endif
-    #ifdef ULOG_BUILD_PREFIX_SIZE
-        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_PREFIX_SIZE"
-    #endif
-    #ifdef ULOG_BUILD_EXTRA_OUTPUTS
-        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_EXTRA_OUTPUTS"
-    #endif
-    #ifdef ULOG_BUILD_SOURCE_LOCATION
-        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_SOURCE_LOCATION"
-    #endif
-    #ifdef ULOG_BUILD_LEVEL_SHORT
-        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_LEVEL_SHORT"
-    #endif
-    #ifdef ULOG_BUILD_TIME
-        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_TIME"
-    #endif
-    #ifdef ULOG_BUILD_TOPICS_MODE
-        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_TOPICS_MODE"
-    #endif
-    #ifdef ULOG_BUILD_DYNAMIC_CONFIG
-        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_DYNAMIC_CONFIG"
-    #endif
-    #ifdef ULOG_BUILD_WARN_NOT_ENABLED
-        #error "ULOG_BUILD_CONFIG_HEADER_ENABLED cannot be used with ULOG_BUILD_WARN_NOT_ENABLED"
-    #endif
-
-    // The user provided configuration header
-    #ifndef ULOG_BUILD_CONFIG_HEADER_NAME
-        #define ULOG_BUILD_CONFIG_HEADER_NAME "ulog_config.h"
-    #endif
-
-    #include ULOG_BUILD_CONFIG_HEADER_NAME
-#endif // ULOG_BUILD_CONFIG_HEADER_ENABLED
+// The configuration header is included by ulog.h, so the build options are
+// visible both here and in the logging macros (see ULOG_BUILD_MIN_LEVEL).
 
 /* ============================================================================
     Core Feature: Static Configuration
@@ -146,6 +120,46 @@
     #define ULOG_HAS_WARN_NOT_ENABLED (ULOG_BUILD_WARN_NOT_ENABLED==1)
 #endif
 
+#ifndef ULOG_BUILD_ASYNC
+    #define ULOG_HAS_ASYNC 0
+#else
+    #define ULOG_HAS_ASYNC (ULOG_BUILD_ASYNC > 0)
+#endif
+
+#ifndef ULOG_BUILD_KV_FIELDS
+    #define ULOG_HAS_KV 0
+#else
+    #define ULOG_HAS_KV (ULOG_BUILD_KV_FIELDS > 0)
+#endif
+
+#ifndef ULOG_BUILD_BINARY_OUTPUT
+    #define ULOG_HAS_BINARY 0
+#else
+    #define ULOG_HAS_BINARY (ULOG_BUILD_BINARY_OUTPUT > 0)
+#endif
+
+#ifndef ULOG_BUILD_SIGNAL_SAFE
+    #define ULOG_HAS_SIGNAL_SAFE 0
+#else
+    #define ULOG_HAS_SIGNAL_SAFE (ULOG_BUILD_SIGNAL_SAFE > 0)
+#endif
+
+#ifndef ULOG_BUILD_FORMATTER
+    #define ULOG_HAS_FORMATTER 0
+#else
+    #define ULOG_HAS_FORMATTER (ULOG_BUILD_FORMATTER == 1)
+#endif
+
+#ifndef ULOG_BUILD_RENDER_LINE_SIZE
+    #define ULOG_HAS_RENDER_CACHE 0
+#else
+    #define ULOG_HAS_RENDER_CACHE (ULOG_BUILD_RENDER_LINE_SIZE > 0)
+#endif
+
+// Deferred formatting of captured arguments, used by the async mode and the
+// binary output
+#define ULOG_HAS_CAPTURE (ULOG_HAS_ASYNC || ULOG_HAS_BINARY)
+
 #ifndef ULOG_BUILD_TOPICS_MODE
     #define ULOG_HAS_TOPICS 0
 #else
@@ -164,10 +178,12 @@
 
     // Undef macros to avoid conflicts
     #undef ULOG_BUILD_EXTRA_OUTPUTS
+    #undef ULOG_BUILD_KV_FIELDS
     #undef ULOG_BUILD_PREFIX_SIZE
     #undef ULOG_BUILD_TOPICS_MODE
     #undef ULOG_HAS_COLOR
     #undef ULOG_HAS_EXTRA_OUTPUTS
+    #undef ULOG_HAS_KV
     #undef ULOG_HAS_LEVEL_LONG
     #undef ULOG_HAS_LEVEL_SHORT
     #undef ULOG_HAS_PREFIX
@@ -178,11 +194,13 @@
 
     // Configure features based on runtime config
     #define ULOG_BUILD_EXTRA_OUTPUTS 8
+    #define ULOG_BUILD_KV_FIELDS 8
     #define ULOG_BUILD_PREFIX_SIZE 64
     /* In dynamic configuration mode we enable dynamic topics */
     #define ULOG_BUILD_TOPICS_MODE ULOG_BUILD_TOPICS_MODE_DYNAMIC
     #define ULOG_HAS_COLOR 1
     #define ULOG_HAS_EXTRA_OUTPUTS 1
+    #define ULOG_HAS_KV 1
     #define ULOG_HAS_LEVEL_LONG 1
     #define ULOG_HAS_LEVEL_SHORT 1
     #define ULOG_HAS_PREFIX 1
@@ -211,6 +229,62 @@ static inline bool is_str_empty(const char *str) {
     return (str == NULL) || (str[0] == '\0');
 }
 
+/* ============================================================================
+   Core Feature: Atomics
+   (`atomics_*`, depends on: - )
+============================================================================ */
+
+// Values read outside of the lock (e.g. the level pre-filter) are published
+// through these helpers. C11 atomics are used when available; otherwise we
+// fall back to a volatile int, which is a single load/store on all supported
+// targets and is good enough for the "hint" values stored here.
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) &&              \
+    !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+
+typedef atomic_int atomics_int;
+typedef atomic_size_t atomics_size;
+
+#define atomics_load(ptr) atomic_load_explicit((ptr), memory_order_relaxed)
+#define atomics_store(ptr, value)                                              \
+    atomic_store_explicit((ptr), (value), memory_order_relaxed)
+#define atomics_fetch_add(ptr, value)                                          \
+    atomic_fetch_add_explicit((ptr), (value), memory_order_relaxed)
+
+// Ordered variants, used to hand data over between threads (Async)
+#define atomics_load_acquire(ptr)                                              \
+    atomic_load_explicit((ptr), memory_order_acquire)
+#define atomics_store_release(ptr, value)                                      \
+    atomic_store_explicit((ptr), (value), memory_order_release)
+#define atomics_compare_exchange(ptr, expected, desired)                       \
+    atomic_compare_exchange_weak_explicit((ptr), (expected), (desired),        \
+                                          memory_order_relaxed,                \
+                                          memory_order_relaxed)
+#define atomics_fence_acquire() atomic_thread_fence(memory_order_acquire)
+#define atomics_fence_release() atomic_thread_fence(memory_order_release)
+
+#else  // No C11 atomics
+
+#if ULOG_HAS_ASYNC
+#error "ULOG_BUILD_ASYNC requires C11 atomics"
+#endif
+
+typedef volatile int atomics_int;
+typedef volatile size_t atomics_size;
+
+#define atomics_load(ptr) (*(ptr))
+#define atomics_store(ptr, value) (void)(*(ptr) = (value))
+#define atomics_fetch_add(ptr, value) ((*(ptr) += (value)) - (value))
+
+// No ordering beyond volatile: values handed over between threads are only
+// hints here, e.g. a callsite read stale goes to the locked path
+#define atomics_load_acquire(ptr) (*(ptr))
+#define atomics_store_release(ptr, value) (void)(*(ptr) = (value))
+#define atomics_fence_acquire() ((void)0)
+#define atomics_fence_release() ((void)0)
+
+#endif  // C11 atomics
+
 /* ============================================================================
    Core Feature: Warn Not Enabled
    (`warn_not_enabled`, depends on: - )
@@ -234,6 +308,22 @@ static inline bool is_str_empty(const char *str) {
    (`print_*`, depends on: - )
 ============================================================================ */
 
+#include <stddef.h>
+
+// Conversion specs are parsed by the formatter, capture, signal safe logging
+// and the JSON output; the digit formatting is shared by the formatter and
+// signal safe logging, formatting one spec with the C library also by the
+// JSON output
+#define PRINT_HAS_SPEC                                                         \
+    (ULOG_HAS_FORMATTER || ULOG_HAS_CAPTURE || ULOG_HAS_SIGNAL_SAFE ||         \
+     ULOG_HAS_EXTRA_OUTPUTS)
+#define PRINT_HAS_DIGITS (ULOG_HAS_FORMATTER || ULOG_HAS_SIGNAL_SAFE)
+#define PRINT_HAS_LIBC_SPEC (PRINT_HAS_DIGITS || ULOG_HAS_EXTRA_OUTPUTS)
+
+#if PRINT_HAS_DIGITS
+#include <math.h>  // isfinite(), signbit() - macros, no libm needed
+#endif
+
 //  Private
 // ================
 
@@ -255,6 +345,620 @@ typedef struct {
     print_target_descriptor dsc;
 } print_target;
 
+/// @brief Output of the formatter, counts the full length like snprintf
+typedef struct {
+    char *data;
+    size_t size;  // Space including the terminating null
+    size_t len;   // Length of the whole output, may exceed the space
+} print_sink;
+
+static void print_sink_put(print_sink *sink, const char *src, size_t len) {
+    if (sink->len + 1 < sink->size) {
+        size_t room = sink->size - 1 - sink->len;
+        memcpy(sink->data + sink->len, src, len < room ? len : room);
+    }
+    sink->len += len;
+}
+
+#if PRINT_HAS_SPEC
+// Formatting
+// ----------------
+// With ULOG_BUILD_FORMATTER messages are formatted by a small formatter for
+// the common conversions: %d %i %u %x %X %c %s %p %f with the '-', '0', '+'
+// and ' ' flags and a numeric width. Other specs are formatted by snprintf one
+// at a time, and a format with a conversion of unknown argument type is
+// passed to vsnprintf as a whole. The output is the same as the one of the C
+// library. Without it, messages are formatted by vsnprintf and vfprintf.
+
+#define PRINT_SPEC_MAX_LEN 32     // Longest conversion spec, e.g. "%-+08.3lld"
+#define PRINT_STREAM_BUF_SIZE 256  // Longer stream output uses vfprintf
+#define PRINT_FLOAT_MAX_PRECISION 15
+#define PRINT_FLOAT_EXACT_LIMIT 4503599627370496.0  // 2^52
+#define PRINT_FLOAT_MAX_WHOLE 1e19  // Fits unsigned long long
+
+typedef enum {
+    PRINT_ARG_NONE,  // No argument: "%%"
+    PRINT_ARG_INT,
+    PRINT_ARG_LONG,
+    PRINT_ARG_LLONG,
+    PRINT_ARG_INTMAX,
+    PRINT_ARG_SIZE,
+    PRINT_ARG_PTRDIFF,
+    PRINT_ARG_DOUBLE,
+    PRINT_ARG_LDOUBLE,
+    PRINT_ARG_STRING,
+    PRINT_ARG_POINTER,
+    PRINT_ARG_UNSUPPORTED,  // %n, wide characters or unknown conversions
+} print_arg_type;
+
+typedef struct {
+    const char *start;    // Points to '%'
+    size_t len;           // Length of the spec including the conversion
+    bool star_width;      // Width is passed as an int argument
+    bool star_precision;  // Precision is passed as an int argument
+    bool left;            // '-'
+    bool zero;            // '0'
+    bool plus;            // '+'
+    bool space;           // ' '
+    bool other_flags;     // '#' or '\''
+    bool short_int;       // 'h' or 'hh'
+    int width;            // 0 if not set
+    int precision;        // -1 if not set
+    char conversion;
+    print_arg_type type;
+} print_spec;
+
+/// @brief Parses a conversion spec
+/// @param str - Points to '%'
+/// @param spec - (Output) parsed spec
+static void print_spec_parse(const char *str, print_spec *spec) {
+    const char *p = str + 1;
+    *spec         = (print_spec){
+                .start = str, .precision = -1, .type = PRINT_ARG_UNSUPPORTED};
+
+    for (;; p++) {
+        if (*p == '-') {
+            spec->left = true;
+        } else if (*p == '0') {
+            spec->zero = true;
+        } else if (*p == '+') {
+            spec->plus = true;
+        } else if (*p == ' ') {
+            spec->space = true;
+        } else if (*p == '#' || *p == '\'') {
+            spec->other_flags = true;
+        } else {
+            break;
+        }
+    }
+    if (*p == '*') {
+        spec->star_width = true;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+        spec->width = spec->width * 10 + (*p - '0');
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        spec->precision = 0;
+        if (*p == '*') {
+            spec->star_precision = true;
+            p++;
+        }
+        while (*p >= '0' && *p <= '9') {
+            spec->precision = spec->precision * 10 + (*p - '0');
+            p++;
+        }
+    }
+
+    // Length modifier selects the argument type of integer conversions
+    print_arg_type int_type = PRINT_ARG_INT;
+    bool long_double        = false;
+    bool wide               = false;
+    if (p[0] == 'h') {
+        spec->short_int = true;
+        p += (p[1] == 'h') ? 2 : 1;  // Promoted to int
+    } else if (p[0] == 'l' && p[1] == 'l') {
+        int_type = PRINT_ARG_LLONG;
+        p += 2;
+    } else if (p[0] == 'l') {
+        int_type = PRINT_ARG_LONG;
+        wide     = true;  // %lc and %ls
+        p++;
+    } else if (p[0] == 'j') {
+        int_type = PRINT_ARG_INTMAX;
+        p++;
+    } else if (p[0] == 'z') {
+        int_type = PRINT_ARG_SIZE;
+        p++;
+    } else if (p[0] == 't') {
+        int_type = PRINT_ARG_PTRDIFF;
+        p++;
+    } else if (p[0] == 'L') {
+        long_double = true;
+        p++;
+    }
+
+    char conversion = *p;
+    if (conversion == '\0') {
+        spec->len = (size_t)(p - str);
+        return;  // Truncated spec
+    }
+    spec->len        = (size_t)(p - str) + 1;
+    spec->conversion = conversion;
+
+    switch (conversion) {
+        case '%':
+            spec->type = PRINT_ARG_NONE;
+            break;
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            spec->type = int_type;
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            spec->type = long_double ? PRINT_ARG_LDOUBLE : PRINT_ARG_DOUBLE;
+            break;
+        case 'c':
+            spec->type = wide ? PRINT_ARG_UNSUPPORTED : PRINT_ARG_INT;
+            break;
+        case 's':
+            spec->type = wide ? PRINT_ARG_UNSUPPORTED : PRINT_ARG_STRING;
+            break;
+        case 'p':
+            spec->type = PRINT_ARG_POINTER;
+            break;
+        default:
+            break;
+    }
+
+    if (spec->len >= PRINT_SPEC_MAX_LEN) {
+        spec->type = PRINT_ARG_UNSUPPORTED;
+    }
+}
+#endif  // PRINT_HAS_SPEC
+
+#if PRINT_HAS_LIBC_SPEC
+/// @brief Puts the output of snprintf for one spec
+#define PRINT_SINK_SNPRINTF(sink, ...)                                         \
+    do {                                                                       \
+        bool has_room_ = (sink)->len + 1 < (sink)->size;                       \
+        int written_   = snprintf(                                             \
+            has_room_ ? (sink)->data + (sink)->len : NULL,                     \
+            has_room_ ? (sink)->size - (sink)->len : 0, __VA_ARGS__);          \
+        if (written_ > 0) {                                                    \
+            (sink)->len += (size_t)written_;                                   \
+        }                                                                      \
+    } while (0)
+
+/// @brief Formats one value with the spec and optional star arguments
+#define PRINT_SINK_SPEC(sink, fmt, spec, width, precision, value)              \
+    do {                                                                       \
+        if ((spec)->star_width && (spec)->star_precision) {                    \
+            PRINT_SINK_SNPRINTF(sink, fmt, width, precision, value);           \
+        } else if ((spec)->star_width) {                                       \
+            PRINT_SINK_SNPRINTF(sink, fmt, width, value);                      \
+        } else if ((spec)->star_precision) {                                   \
+            PRINT_SINK_SNPRINTF(sink, fmt, precision, value);                  \
+        } else {                                                               \
+            PRINT_SINK_SNPRINTF(sink, fmt, value);                             \
+        }                                                                      \
+    } while (0)
+
+/// @brief Formats one spec with the C library
+/// @return false if the argument type is unknown
+static bool print_format_libc(print_sink *sink, const print_spec *spec,
+                              va_list *args) {
+    if (spec->len >= PRINT_SPEC_MAX_LEN) {
+        return false;  // Does not fit the copy, format it with vsnprintf
+    }
+    char fmt[PRINT_SPEC_MAX_LEN];
+    memcpy(fmt, spec->start, spec->len);
+    fmt[spec->len] = '\0';
+
+    int width     = spec->star_width ? va_arg(*args, int) : 0;
+    int precision = spec->star_precision ? va_arg(*args, int) : 0;
+
+    switch (spec->type) {
+        case PRINT_ARG_NONE:
+            print_sink_put(sink, "%", 1);
+            return true;
+        case PRINT_ARG_INT:
+            PRINT_SINK_SPEC(sink, fmt, spec, width, precision,
+                            va_arg(*args, int));
+            return true;
+        case PRINT_ARG_LONG:
+            PRINT_SINK_SPEC(sink, fmt, spec, width, precision,
+                            va_arg(*args, long));
+            return true;
+        case PRINT_ARG_LLONG:
+            PRINT_SINK_SPEC(sink, fmt, spec, width, precision,
+                            va_arg(*args, long long));
+            return true;
+        case PRINT_ARG_INTMAX:
+            PRINT_SINK_SPEC(sink, fmt, spec, width, precision,
+                            va_arg(*args, intmax_t));
+            return true;
+        case PRINT_ARG_SIZE:
+            PRINT_SINK_SPEC(sink, fmt, spec, width, precision,
+                            va_arg(*args, size_t));
+            return true;
+        case PRINT_ARG_PTRDIFF:
+            PRINT_SINK_SPEC(sink, fmt, spec, width, precision,
+                            va_arg(*args, ptrdiff_t));
+            return true;
+        case PRINT_ARG_DOUBLE:
+            PRINT_SINK_SPEC(sink, fmt, spec, width, precision,
+                            va_arg(*args, double));
+            return true;
+        case PRINT_ARG_LDOUBLE:
+            PRINT_SINK_SPEC(sink, fmt, spec, width, precision,
+                            va_arg(*args, long double));
+            return true;
+        case PRINT_ARG_STRING:
+            PRINT_SINK_SPEC(sink, fmt, spec, width, precision,
+                            va_arg(*args, const char *));
+            return true;
+        case PRINT_ARG_POINTER:
+            PRINT_SINK_SPEC(sink, fmt, spec, width, precision,
+                            va_arg(*args, void *));
+            return true;
+        default:
+            return false;
+    }
+}
+#endif  // PRINT_HAS_LIBC_SPEC
+
+#if PRINT_HAS_DIGITS
+static const char print_digit_pairs[] = "00010203040506070809"
+                                        "10111213141516171819"
+                                        "20212223242526272829"
+                                        "30313233343536373839"
+                                        "40414243444546474849"
+                                        "50515253545556575859"
+                                        "60616263646566676869"
+                                        "70717273747576777879"
+                                        "80818283848586878889"
+                                        "90919293949596979899";
+
+static const double print_pow10[PRINT_FLOAT_MAX_PRECISION + 1] = {
+    1e0, 1e1, 1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+    1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+
+static void print_sink_fill(print_sink *sink, char c, size_t count) {
+    if (sink->len + 1 < sink->size) {
+        size_t room = sink->size - 1 - sink->len;
+        memset(sink->data + sink->len, c, count < room ? count : room);
+    }
+    sink->len += count;
+}
+
+/// @brief Puts the text padded to the spec width
+/// @param sign - Sign character or '\0'
+/// @param zero_pad - Pad with zeros after the sign
+static void print_format_padded(print_sink *sink, const print_spec *spec,
+                                char sign, const char *text, size_t len,
+                                bool zero_pad) {
+    size_t total = len + (sign != '\0' ? 1 : 0);
+    size_t pad   = (size_t)spec->width > total ? spec->width - total : 0;
+
+    if (!spec->left && !zero_pad) {
+        print_sink_fill(sink, ' ', pad);
+    }
+    if (sign != '\0') {
+        print_sink_put(sink, &sign, 1);
+    }
+    if (!spec->left && zero_pad) {
+        print_sink_fill(sink, '0', pad);
+    }
+    print_sink_put(sink, text, len);
+    if (spec->left) {
+        print_sink_fill(sink, ' ', pad);
+    }
+}
+
+/// @brief Writes decimal digits, two at a time, backwards from `end`
+/// @return First digit
+static char *print_format_decimal(char *end, unsigned long long value) {
+    while (value >= 100) {
+        size_t pair = (size_t)(value % 100) * 2;
+        value /= 100;
+        end -= 2;
+        memcpy(end, &print_digit_pairs[pair], 2);
+    }
+    if (value >= 10) {
+        end -= 2;
+        memcpy(end, &print_digit_pairs[value * 2], 2);
+    } else {
+        *--end = (char)('0' + value);
+    }
+    return end;
+}
+
+/// @brief Writes hexadecimal digits backwards from `end`
+/// @return First digit
+static char *print_format_hex(char *end, unsigned long long value,
+                              bool upper) {
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    do {
+        *--end = digits[value & 0xFu];
+        value >>= 4;
+    } while (value != 0);
+    return end;
+}
+
+static long long print_arg_signed(print_arg_type type, va_list *args) {
+    switch (type) {
+        case PRINT_ARG_LONG:
+            return va_arg(*args, long);
+        case PRINT_ARG_LLONG:
+            return va_arg(*args, long long);
+        case PRINT_ARG_INTMAX:
+            return (long long)va_arg(*args, intmax_t);
+        case PRINT_ARG_SIZE:
+            return (long long)(ptrdiff_t)va_arg(*args, size_t);
+        case PRINT_ARG_PTRDIFF:
+            return (long long)va_arg(*args, ptrdiff_t);
+        default:
+            return va_arg(*args, int);
+    }
+}
+
+static unsigned long long print_arg_unsigned(print_arg_type type,
+                                             va_list *args) {
+    switch (type) {
+        case PRINT_ARG_LONG:
+            return va_arg(*args, unsigned long);
+        case PRINT_ARG_LLONG:
+            return va_arg(*args, unsigned long long);
+        case PRINT_ARG_INTMAX:
+            return (unsigned long long)va_arg(*args, uintmax_t);
+        case PRINT_ARG_SIZE:
+            return va_arg(*args, size_t);
+        case PRINT_ARG_PTRDIFF:
+            return (unsigned long long)(size_t)va_arg(*args, ptrdiff_t);
+        default:
+            return va_arg(*args, unsigned int);
+    }
+}
+
+/// @brief Formats a double with a fixed precision. Exact: values whose digits
+/// depend on rounding beyond the double product are left to the C library.
+/// @param exact - false: round the product as it is, the last digit may differ
+/// from the C library (signal-safe formatting)
+/// @return false if not formatted
+static bool print_format_double(print_sink *sink, const print_spec *spec,
+                                double value, bool exact) {
+    int precision = spec->precision < 0 ? 6 : spec->precision;
+    if (precision > PRINT_FLOAT_MAX_PRECISION || !isfinite(value)) {
+        return false;
+    }
+
+    double scaled = (value < 0 ? -value : value) * print_pow10[precision];
+    if (!(scaled < (exact ? PRINT_FLOAT_EXACT_LIMIT : PRINT_FLOAT_MAX_WHOLE))) {
+        return false;  // No fraction bits left to round with
+    }
+    unsigned long long whole = (unsigned long long)scaled;
+    double fraction          = scaled - (double)whole;
+    double tie_distance      = fraction > 0.5 ? fraction - 0.5 : 0.5 - fraction;
+    if (exact && tie_distance <= scaled * 4.5e-16) {
+        return false;  // Near a tie: the product error may flip the rounding
+    }
+    whole += fraction > 0.5 || (fraction == 0.5 && (whole & 1u)) ? 1 : 0;
+
+    char buf[48];
+    char *end   = buf + sizeof(buf);
+    char *first = print_format_decimal(end, whole);
+    while (end - first < precision + 1) {
+        *--first = '0';  // At least one integer digit
+    }
+    if (precision > 0) {
+        // Move the integer digits left to make room for the point
+        size_t int_len = (size_t)(end - first) - (size_t)precision;
+        memmove(first - 1, first, int_len);
+        first--;
+        first[int_len] = '.';
+    }
+
+    char sign = signbit(value) ? '-' : spec->plus ? '+' : spec->space ? ' ' : 0;
+    print_format_padded(sink, spec, sign, first, (size_t)(end - first),
+                        spec->zero);
+    return true;
+}
+
+/// @brief Formats one spec
+/// @return false if the argument type is unknown
+static bool print_format_spec(print_sink *sink, const print_spec *spec,
+                              va_list *args) {
+    if (spec->type == PRINT_ARG_UNSUPPORTED) {
+        return false;  // Unknown argument type, or too long for the copy
+    }
+    bool plain = !spec->star_width && !spec->star_precision &&
+                 !spec->other_flags;
+    bool plain_int = plain && spec->precision < 0 && !spec->short_int;
+    char buf[24];
+    char *end = buf + sizeof(buf);
+
+    switch (plain ? spec->conversion : '\0') {
+        case 'd':
+        case 'i':
+            if (plain_int) {
+                long long value = print_arg_signed(spec->type, args);
+                unsigned long long magnitude =
+                    value < 0 ? (unsigned long long)(-(value + 1)) + 1
+                              : (unsigned long long)value;
+                char sign = value < 0     ? '-'
+                            : spec->plus  ? '+'
+                            : spec->space ? ' '
+                                          : '\0';
+                char *first = print_format_decimal(end, magnitude);
+                print_format_padded(sink, spec, sign, first,
+                                    (size_t)(end - first), spec->zero);
+                return true;
+            }
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+            if (plain_int) {
+                unsigned long long value = print_arg_unsigned(spec->type, args);
+                char *first = spec->conversion == 'u'
+                                  ? print_format_decimal(end, value)
+                                  : print_format_hex(end, value,
+                                                     spec->conversion == 'X');
+                print_format_padded(sink, spec, '\0', first,
+                                    (size_t)(end - first), spec->zero);
+                return true;
+            }
+            break;
+        case 'c':
+            if (!spec->zero && spec->precision < 0) {
+                char c = (char)va_arg(*args, int);
+                print_format_padded(sink, spec, '\0', &c, 1, false);
+                return true;
+            }
+            break;
+        case 's':
+            if (!spec->zero && spec->type == PRINT_ARG_STRING) {
+                const char *str = va_arg(*args, const char *);
+                if (str == NULL) {
+                    // Same as glibc: "(null)" unless cut by the precision
+                    str = spec->precision < 0 || spec->precision >= 6
+                              ? "(null)"
+                              : "";
+                }
+                size_t len = 0;
+                while ((spec->precision < 0 || len < (size_t)spec->precision) &&
+                       str[len] != '\0') {
+                    len++;
+                }
+                print_format_padded(sink, spec, '\0', str, len, false);
+                return true;
+            }
+            break;
+#if defined(__GLIBC__)
+        case 'p':
+            if (!spec->zero && !spec->plus && !spec->space &&
+                spec->precision < 0) {
+                void *ptr = va_arg(*args, void *);
+                if (ptr == NULL) {
+                    print_format_padded(sink, spec, '\0', "(nil)", 5, false);
+                    return true;
+                }
+                char *first = print_format_hex(end, (uintptr_t)ptr, false);
+                *--first    = 'x';
+                *--first    = '0';
+                print_format_padded(sink, spec, '\0', first,
+                                    (size_t)(end - first), false);
+                return true;
+            }
+            break;
+#endif  // __GLIBC__
+        case 'f':
+        case 'F':
+            if (spec->type == PRINT_ARG_DOUBLE) {
+                double value = va_arg(*args, double);
+                if (!print_format_double(sink, spec, value, true)) {
+                    char fmt[PRINT_SPEC_MAX_LEN];
+                    memcpy(fmt, spec->start, spec->len);
+                    fmt[spec->len] = '\0';
+                    PRINT_SINK_SNPRINTF(sink, fmt, value);
+                }
+                return true;
+            }
+            break;
+        default:
+            break;
+    }
+    return print_format_libc(sink, spec, args);
+}
+#endif  // PRINT_HAS_DIGITS
+
+#if ULOG_HAS_FORMATTER
+/// @brief Formats the message into the sink
+/// @return false if the format has a conversion of unknown argument type; the
+/// sink content is undefined then
+static bool print_format(print_sink *sink, const char *format, va_list args) {
+    va_list args_copy;
+    va_copy(args_copy, args);
+    bool ok       = true;
+    const char *p = format;
+    while (ok) {
+        const char *spec_start = strchr(p, '%');
+        if (spec_start == NULL) {
+            print_sink_put(sink, p, strlen(p));
+            break;
+        }
+        print_sink_put(sink, p, (size_t)(spec_start - p));
+
+        print_spec spec;
+        print_spec_parse(spec_start, &spec);
+        ok = print_format_spec(sink, &spec, &args_copy);
+        p  = spec_start + spec.len;
+    }
+    va_end(args_copy);
+
+    if (sink->size > 0) {
+        size_t end = sink->len < sink->size ? sink->len : sink->size - 1;
+        sink->data[end] = '\0';
+    }
+    return ok;
+}
+
+static void print_to_target_valist(print_target *tgt, const char *format,
+                                   va_list args) {
+    if (tgt->type == PRINT_TARGET_BUFFER) {
+        print_buffer *buf = &tgt->dsc.buffer;
+
+        if (buf->curr_pos >= buf->size) {
+            return;  // No space available
+        }
+
+        size_t remaining = buf->size - buf->curr_pos;
+        char *write_pos  = buf->data + buf->curr_pos;
+
+        size_t written = 0;
+        print_sink sink = {write_pos, remaining, 0};
+        if (print_format(&sink, format, args)) {
+            written = sink.len;
+        } else {
+            int libc_written = vsnprintf(write_pos, remaining, format, args);
+            if (libc_written < 0) {
+                return;  // Encoding error
+            }
+            written = (size_t)libc_written;
+        }
+
+        // Update position, capping at buffer end
+        if (written >= remaining) {
+            buf->curr_pos = buf->size;
+        } else {
+            buf->curr_pos += written;
+        }
+
+    } else if (tgt->type == PRINT_TARGET_STREAM) {
+        char line[PRINT_STREAM_BUF_SIZE];
+        print_sink sink = {line, sizeof(line), 0};
+        if (print_format(&sink, format, args) && sink.len < sizeof(line)) {
+            fwrite(line, 1, sink.len, tgt->dsc.stream);
+        } else {
+            vfprintf(tgt->dsc.stream, format, args);
+        }
+    }
+}
+
+#else
 static void print_to_target_valist(print_target *tgt, const char *format,
                                    va_list args) {
     if (tgt->type == PRINT_TARGET_BUFFER) {
@@ -283,6 +987,7 @@ static void print_to_target_valist(print_target *tgt, const char *format,
         vfprintf(tgt->dsc.stream, format, args);
     }
 }
+#endif  // ULOG_HAS_FORMATTER
 
 static void print_to_target(print_target *tgt, const char *format, ...) {
     va_list args;
@@ -291,27 +996,412 @@ static void print_to_target(print_target *tgt, const char *format, ...) {
     va_end(args);
 }
 
+/// @brief Prints text of a known length as is, without a format
+static void print_to_target_text(print_target *tgt, const char *text,
+                                 size_t len) {
+    if (tgt->type == PRINT_TARGET_BUFFER) {
+        print_buffer *buf = &tgt->dsc.buffer;
+
+        if (buf->curr_pos >= buf->size) {
+            return;  // No space available
+        }
+
+        print_sink sink = {buf->data + buf->curr_pos,
+                           buf->size - buf->curr_pos, 0};
+        print_sink_put(&sink, text, len);
+        sink.data[sink.len < sink.size ? sink.len : sink.size - 1] = '\0';
+
+        // Update position, capping at buffer end
+        if (sink.len >= sink.size) {
+            buf->curr_pos = buf->size;
+        } else {
+            buf->curr_pos += sink.len;
+        }
+
+    } else if (tgt->type == PRINT_TARGET_STREAM) {
+        fwrite(text, 1, len, tgt->dsc.stream);
+    }
+}
+
+/* ============================================================================
+   Optional Feature: Capture
+   (`capture_*`, depends on: Print)
+============================================================================ */
+#if ULOG_HAS_CAPTURE
+
+// Private
+// ================
+
+// A record is the format string followed by the argument values in native
+// representation, in the order they are consumed by the format:
+//   [format\0][value][value]...
+// `%s` strings are copied as NUL-terminated text. The record is walked with the
+// same format parser when it is printed, so it carries no type tags.
+
+/// @brief Appends data to the record
+/// @return false if it does not fit
+static bool capture_put(char *buf, size_t size, size_t *pos, const void *data,
+                        size_t data_size) {
+    if (data_size > size - *pos) {
+        return false;
+    }
+    memcpy(buf + *pos, data, data_size);
+    *pos += data_size;
+    return true;
+}
+
+#define CAPTURE_PUT_VALUE(buf, size, pos, args, type)                          \
+    do {                                                                       \
+        type value_ = va_arg(args, type);                                      \
+        if (!capture_put(buf, size, pos, &value_, sizeof(value_))) {           \
+            return false;                                                      \
+        }                                                                      \
+    } while (0)
+
+/// @brief Copies the argument of one spec into the record
+/// @param precision - Precision of the spec, negative if not set. Strings are
+/// read up to it, they need not be terminated then
+static bool capture_put_arg(char *buf, size_t size, size_t *pos,
+                            print_arg_type type, int precision,
+                            va_list *args) {
+    switch (type) {
+        case PRINT_ARG_NONE:
+            return true;
+        case PRINT_ARG_INT:
+            CAPTURE_PUT_VALUE(buf, size, pos, *args, int);
+            return true;
+        case PRINT_ARG_LONG:
+            CAPTURE_PUT_VALUE(buf, size, pos, *args, long);
+            return true;
+        case PRINT_ARG_LLONG:
+            CAPTURE_PUT_VALUE(buf, size, pos, *args, long long);
+            return true;
+        case PRINT_ARG_INTMAX:
+            CAPTURE_PUT_VALUE(buf, size, pos, *args, intmax_t);
+            return true;
+        case PRINT_ARG_SIZE:
+            CAPTURE_PUT_VALUE(buf, size, pos, *args, size_t);
+            return true;
+        case PRINT_ARG_PTRDIFF:
+            CAPTURE_PUT_VALUE(buf, size, pos, *args, ptrdiff_t);
+            return true;
+        case PRINT_ARG_DOUBLE:
+            CAPTURE_PUT_VALUE(buf, size, pos, *args, double);
+            return true;
+        case PRINT_ARG_LDOUBLE:
+            CAPTURE_PUT_VALUE(buf, size, pos, *args, long double);
+            return true;
+        case PRINT_ARG_POINTER:
+            CAPTURE_PUT_VALUE(buf, size, pos, *args, void *);
+            return true;
+        case PRINT_ARG_STRING: {
+            const char *str = va_arg(*args, const char *);
+            if (str == NULL) {
+                // Same as glibc: "(null)" unless cut by the precision
+                str = precision < 0 || precision >= 6 ? "(null)" : "";
+            }
+            size_t len = 0;
+            while ((precision < 0 || len < (size_t)precision) &&
+                   str[len] != '\0') {
+                len++;
+            }
+            return capture_put(buf, size, pos, str, len) &&
+                   capture_put(buf, size, pos, "", 1);
+        }
+        default:
+            return false;
+    }
+}
+
+/// @brief Captures the format and its arguments into a record
+/// @param buf - Record buffer
+/// @param size - Buffer size
+/// @param format - Format string, not empty
+/// @param args - Format arguments
+/// @return true on success, false if the record does not fit or the format
+/// is not supported
+static bool capture_args(char *buf, size_t size, const char *format,
+                         va_list args) {
+    size_t pos = 0;
+    if (!capture_put(buf, size, &pos, format, strlen(format) + 1)) {
+        return false;
+    }
+
+    va_list args_copy;
+    va_copy(args_copy, args);
+    bool ok       = true;
+    const char *p = strchr(format, '%');
+    while (ok && p != NULL) {
+        print_spec spec;
+        print_spec_parse(p, &spec);
+        if (spec.len >= PRINT_SPEC_MAX_LEN) {
+            ok = false;  // Does not fit the spec copy of capture_print_spec
+            break;
+        }
+        if (spec.star_width) {
+            ok = capture_put_arg(buf, size, &pos, PRINT_ARG_INT, -1,
+                                 &args_copy);
+        }
+        int precision = spec.precision;
+        if (ok && spec.star_precision) {
+            precision = va_arg(args_copy, int);
+            ok = capture_put(buf, size, &pos, &precision, sizeof(precision));
+        }
+        ok = ok && capture_put_arg(buf, size, &pos, spec.type, precision,
+                                   &args_copy);
+        p  = strchr(p + spec.len, '%');
+    }
+    va_end(args_copy);
+    return ok;
+}
+
+#if ULOG_HAS_BINARY  // Record sizes are only needed to write them out
+/// @brief Gets the size of a value of the type in the record
+/// @return Size or 0 for strings and unknown types
+static size_t capture_arg_size(print_arg_type type) {
+    switch (type) {
+        case PRINT_ARG_INT:
+            return sizeof(int);
+        case PRINT_ARG_LONG:
+            return sizeof(long);
+        case PRINT_ARG_LLONG:
+            return sizeof(long long);
+        case PRINT_ARG_INTMAX:
+            return sizeof(intmax_t);
+        case PRINT_ARG_SIZE:
+            return sizeof(size_t);
+        case PRINT_ARG_PTRDIFF:
+            return sizeof(ptrdiff_t);
+        case PRINT_ARG_DOUBLE:
+            return sizeof(double);
+        case PRINT_ARG_LDOUBLE:
+            return sizeof(long double);
+        case PRINT_ARG_POINTER:
+            return sizeof(void *);
+        default:
+            return 0;
+    }
+}
+
+/// @brief Gets the size of a record made by `capture_args`
+/// @param record - Record
+/// @param size - Bytes available at `record`
+/// @return Record size or 0 if the record is longer than `size`
+static size_t capture_size(const char *record, size_t size) {
+    const char *end = memchr(record, '\0', size);
+    if (end == NULL) {
+        return 0;  // No format
+    }
+    size_t pos = (size_t)(end - record) + 1;
+
+    const char *p = strchr(record, '%');
+    while (p != NULL) {
+        print_spec spec;
+        print_spec_parse(p, &spec);
+        if (spec.type == PRINT_ARG_UNSUPPORTED ||
+            spec.len >= PRINT_SPEC_MAX_LEN) {
+            return 0;  // Never captured
+        }
+        size_t value_size = (spec.star_width ? sizeof(int) : 0) +
+                            (spec.star_precision ? sizeof(int) : 0) +
+                            capture_arg_size(spec.type);
+        if (value_size > size - pos) {
+            return 0;
+        }
+        pos += value_size;
+        if (spec.type == PRINT_ARG_STRING) {
+            end = memchr(record + pos, '\0', size - pos);
+            if (end == NULL) {
+                return 0;
+            }
+            pos = (size_t)(end - record) + 1;
+        }
+        p = strchr(p + spec.len, '%');
+    }
+    return pos;
+}
+#endif  // ULOG_HAS_BINARY
+
+/// @brief Reads a value from the record
+#define CAPTURE_GET_VALUE(record, type, value)                                 \
+    type value;                                                                \
+    memcpy(&value, record, sizeof(value));                                     \
+    record += sizeof(value)
+
+/// @brief Prints the value with optional star width and precision
+#define CAPTURE_PRINT_VALUE(tgt, fmt, spec, width, precision, value)           \
+    do {                                                                       \
+        if ((spec)->star_width && (spec)->star_precision) {                    \
+            print_to_target(tgt, fmt, width, precision, value);                \
+        } else if ((spec)->star_width) {                                       \
+            print_to_target(tgt, fmt, width, value);                           \
+        } else if ((spec)->star_precision) {                                   \
+            print_to_target(tgt, fmt, precision, value);                       \
+        } else {                                                               \
+            print_to_target(tgt, fmt, value);                                  \
+        }                                                                      \
+    } while (0)
+
+/// @brief Prints one spec with its value from the record
+/// @return Position in the record after the value
+static const char *capture_print_spec(print_target *tgt, print_spec *spec,
+                                      const char *record) {
+    char fmt[PRINT_SPEC_MAX_LEN];
+    memcpy(fmt, spec->start, spec->len);
+    fmt[spec->len] = '\0';
+
+    int width     = 0;
+    int precision = 0;
+    if (spec->star_width) {
+        memcpy(&width, record, sizeof(width));
+        record += sizeof(width);
+    }
+    if (spec->star_precision) {
+        memcpy(&precision, record, sizeof(precision));
+        record += sizeof(precision);
+    }
+
+    switch (spec->type) {
+        case PRINT_ARG_NONE:
+            print_to_target(tgt, "%%");
+            break;
+        case PRINT_ARG_INT: {
+            CAPTURE_GET_VALUE(record, int, value);
+            CAPTURE_PRINT_VALUE(tgt, fmt, spec, width, precision, value);
+        } break;
+        case PRINT_ARG_LONG: {
+            CAPTURE_GET_VALUE(record, long, value);
+            CAPTURE_PRINT_VALUE(tgt, fmt, spec, width, precision, value);
+        } break;
+        case PRINT_ARG_LLONG: {
+            CAPTURE_GET_VALUE(record, long long, value);
+            CAPTURE_PRINT_VALUE(tgt, fmt, spec, width, precision, value);
+        } break;
+        case PRINT_ARG_INTMAX: {
+            CAPTURE_GET_VALUE(record, intmax_t, value);
+            CAPTURE_PRINT_VALUE(tgt, fmt, spec, width, precision, value);
+        } break;
+        case PRINT_ARG_SIZE: {
+            CAPTURE_GET_VALUE(record, size_t, value);
+            CAPTURE_PRINT_VALUE(tgt, fmt, spec, width, precision, value);
+        } break;
+        case PRINT_ARG_PTRDIFF: {
+            CAPTURE_GET_VALUE(record, ptrdiff_t, value);
+            CAPTURE_PRINT_VALUE(tgt, fmt, spec, width, precision, value);
+        } break;
+        case PRINT_ARG_DOUBLE: {
+            CAPTURE_GET_VALUE(record, double, value);
+            CAPTURE_PRINT_VALUE(tgt, fmt, spec, width, precision, value);
+        } break;
+        case PRINT_ARG_LDOUBLE: {
+            CAPTURE_GET_VALUE(record, long double, value);
+            CAPTURE_PRINT_VALUE(tgt, fmt, spec, width, precision, value);
+        } break;
+        case PRINT_ARG_POINTER: {
+            CAPTURE_GET_VALUE(record, void *, value);
+            CAPTURE_PRINT_VALUE(tgt, fmt, spec, width, precision, value);
+        } break;
+        case PRINT_ARG_STRING: {
+            const char *value = record;
+            record += strlen(value) + 1;
+            CAPTURE_PRINT_VALUE(tgt, fmt, spec, width, precision, value);
+        } break;
+        default:
+            break;  // Never captured
+    }
+    return record;
+}
+
+/// @brief Prints a record made by `capture_args`
+static void capture_print(print_target *tgt, const char *record) {
+    const char *format = record;
+    record += strlen(format) + 1;
+
+    const char *p          = format;
+    const char *spec_start = strchr(p, '%');
+    while (spec_start != NULL) {
+        if (spec_start > p) {
+            print_to_target(tgt, "%.*s", (int)(spec_start - p), p);
+        }
+        print_spec spec;
+        print_spec_parse(spec_start, &spec);
+        record     = capture_print_spec(tgt, &spec, record);
+        p          = spec_start + spec.len;
+        spec_start = strchr(p, '%');
+    }
+    if (*p != '\0') {
+        print_to_target(tgt, "%s", p);
+    }
+}
+
+#endif  // ULOG_HAS_CAPTURE
+
 /* ============================================================================
    Core Feature: Events
    (`event_*`, depends on: Print)
 ============================================================================ */
 
+#if ULOG_HAS_TIME
+#include <time.h>  // The event keeps its local time
+#endif
+
 // Private
 // ================
 
 static void log_print_message(print_target *tgt, ulog_event *ev);
+#if ULOG_HAS_TIME
+static struct tm *time_get_local(ulog_event *ev);
+#endif
+
+// Format of plain text messages (`ulog_log_message`), with the text and its
+// length as arguments. Recognized by address and copied without parsing; where
+// the event is copied as a format (async), it is a plain "%s".
+static const char log_text_format[] = "%s";
+
+#if ULOG_HAS_RENDER_CACHE
+#define EVENT_RENDER_CACHE_NUM 2  // Distinct styles cached per event
+#define EVENT_RENDER_BUF_SIZE ((size_t)ULOG_BUILD_RENDER_LINE_SIZE)
+
+/// @brief Event line rendered in one style (time, color, new line), shared by
+/// all outputs of the event that print in this style
+typedef struct {
+    unsigned int style;  // EVENT_STYLE_* bits, 0 - entry is free
+    bool complete;       // false if the line did not fit the buffer
+    size_t len;
+    char data[EVENT_RENDER_BUF_SIZE];
+} event_render;
+
+typedef struct {
+    event_render entries[EVENT_RENDER_CACHE_NUM];
+} event_render_cache;
+#endif  // ULOG_HAS_RENDER_CACHE
 
 /// @brief Event structure
 struct ulog_event {
     const char *message;          // Message format string
     va_list message_format_args;  // Format arguments
 
+#if ULOG_HAS_CAPTURE
+    const char *capture;  // Captured format and arguments, replaces the above
+#endif
+
+#if ULOG_HAS_RENDER_CACHE
+    event_render_cache *render;  // Lines rendered for the outputs or NULL
+#endif
+
+#if ULOG_HAS_KV
+    const ulog_kv *kv;  // Key-value fields, printed after the message
+    size_t kv_count;
+#endif
+
 #if ULOG_HAS_TOPICS
     ulog_topic_id topic;
 #endif
 
 #if ULOG_HAS_TIME
-    struct tm *time;
+    bool time_read;        // false - the clock has not been read yet
+    long long time_stamp;  // Clock value, see ulog_time_set_fn()
+    struct tm time;        // Local time, filled by ulog_event_get_time()
 #endif
 
 #if ULOG_HAS_SOURCE_LOCATION
@@ -357,7 +1447,7 @@ struct tm *ulog_event_get_time(ulog_event *ev) {
     if (ev == NULL) {
         return NULL;
     }
-    return ev->time;
+    return time_get_local(ev);
 }
 #endif  // ULOG_HAS_TIME
 
@@ -385,34 +1475,192 @@ ulog_level ulog_event_get_level(ulog_event *ev) {
 }
 
 /* ============================================================================
-   Core Functionality: Lock
-   (`lock_*`, depends on: - )
+   Optional Feature: Key-Value Fields
+   (`kv_*`, depends on: Print, Events)
 ============================================================================ */
 
+#if ULOG_HAS_KV
+
 // Private
 // ================
-typedef struct {
-    ulog_lock_fn function;  // Lock function
-    void *args;             // Argument for the lock function
-} lock_data_t;
 
-static lock_data_t lock_data = {
-    .function = NULL,  // No lock function by default
-    .args     = NULL,  // No lock argument by default
-};
+// Fields are printed after the message as ` key=value`. Keys and strings are
+// quoted when empty or when they contain spaces, quotes, '=' or control
+// characters, so the line splits back into fields unambiguously (logfmt). Doubles are
+// printed with the digits needed to read back the same value.
 
-static ulog_status lock_lock(void) {
-    if (lock_data.function != NULL) {
-        return lock_data.function(true, lock_data.args);
+#define KV_FIELDS_MAX ((size_t)ULOG_BUILD_KV_FIELDS)
+
+/// @brief Attaches the fields to the event
+static void kv_attach(ulog_event *ev, const ulog_kv *fields, size_t count) {
+    ev->kv       = fields;
+    ev->kv_count = count < KV_FIELDS_MAX ? count : KV_FIELDS_MAX;
+}
+
+static bool kv_str_needs_quotes(const char *str) {
+    if (str[0] == '\0') {
+        return true;
     }
-    return ULOG_STATUS_OK;
+    for (const char *p = str; *p != '\0'; p++) {
+        if (*p == ' ' || *p == '"' || *p == '=' || *p == '\\' ||
+            (unsigned char)*p < 0x20 || *p == 0x7F) {
+            return true;
+        }
+    }
+    return false;
 }
 
-static ulog_status lock_unlock(void) {
-    if (lock_data.function != NULL) {
-        return lock_data.function(false, lock_data.args);
+/// @brief Prints a key or a string value, quoted and escaped if needed
+static void kv_print_str(print_target *tgt, const char *str) {
+    if (str == NULL) {
+        print_to_target_text(tgt, "NULL", 4);
+        return;
+    }
+    if (!kv_str_needs_quotes(str)) {
+        print_to_target_text(tgt, str, strlen(str));
+        return;
+    }
+
+    print_to_target_text(tgt, "\"", 1);
+    const char *run = str;  // Characters printed as they are
+    for (const char *p = str; *p != '\0'; p++) {
+        char escape = *p == '"'    ? '"'
+                      : *p == '\\' ? '\\'
+                      : *p == '\n'  ? 'n'
+                      : *p == '\r'  ? 'r'
+                      : *p == '\t'  ? 't'
+                                    : '\0';
+        unsigned char c = (unsigned char)*p;
+        if (escape != '\0') {
+            print_to_target_text(tgt, run, (size_t)(p - run));
+            char seq[2] = {'\\', escape};
+            print_to_target_text(tgt, seq, sizeof(seq));
+            run = p + 1;
+        } else if (c < 0x20 || c == 0x7F) {
+            // Other control characters as \xNN
+            static const char hex[] = "0123456789abcdef";
+            print_to_target_text(tgt, run, (size_t)(p - run));
+            char seq[4] = {'\\', 'x', hex[c >> 4], hex[c & 0xF]};
+            print_to_target_text(tgt, seq, sizeof(seq));
+            run = p + 1;
+        }
+    }
+    print_to_target_text(tgt, run, strlen(run));
+    print_to_target_text(tgt, "\"", 1);
+}
+
+/// @brief Prints a double with the fewest of 15 or 17 significant digits
+/// that read back to the same value
+static void kv_print_double(print_target *tgt, double value) {
+    char buf[32];
+    (void)snprintf(buf, sizeof(buf), "%.15g", value);
+    if (strtod(buf, NULL) != value) {
+        (void)snprintf(buf, sizeof(buf), "%.17g", value);
+    }
+    print_to_target_text(tgt, buf, strlen(buf));
+}
+
+/// @brief Prints the fields of the event after the message
+static void kv_print(print_target *tgt, ulog_event *ev) {
+    for (size_t i = 0; i < ev->kv_count; i++) {
+        const ulog_kv *kv = &ev->kv[i];
+        print_to_target_text(tgt, " ", 1);
+        kv_print_str(tgt, kv->key);
+        print_to_target_text(tgt, "=", 1);
+        switch (kv->type) {
+            case ULOG_KV_TYPE_INT:
+                print_to_target(tgt, "%lld", kv->value.i);
+                break;
+            case ULOG_KV_TYPE_UINT:
+                print_to_target(tgt, "%llu", kv->value.u);
+                break;
+            case ULOG_KV_TYPE_DOUBLE:
+                kv_print_double(tgt, kv->value.d);
+                break;
+            case ULOG_KV_TYPE_BOOL:
+                kv->value.b ? print_to_target_text(tgt, "true", 4)
+                            : print_to_target_text(tgt, "false", 5);
+                break;
+            case ULOG_KV_TYPE_STR:
+                kv_print_str(tgt, kv->value.s);
+                break;
+            default:
+                print_to_target_text(tgt, "?", 1);
+                break;
+        }
     }
-    return ULOG_STATUS_OK;
+}
+
+// Public
+// ================
+
+size_t ulog_event_get_kv_count(ulog_event *ev) {
+    if (ev == NULL) {
+        return 0;
+    }
+    return ev->kv_count;
+}
+
+const ulog_kv *ulog_event_get_kv(ulog_event *ev, size_t index) {
+    if (ev == NULL || index >= ev->kv_count) {
+        return NULL;
+    }
+    return &ev->kv[index];
+}
+
+#else  // ULOG_HAS_KV
+
+// Disabled Private
+// ================
+
+#define kv_attach(ev, fields, count) ((void)(ev), (void)(fields), (void)(count))
+#define kv_print(tgt, ev) ((void)(tgt), (void)(ev))
+
+// Disabled Public
+// ================
+
+size_t ulog_event_get_kv_count(ulog_event *ev) {
+    (void)(ev);
+    return 0;
+}
+
+const ulog_kv *ulog_event_get_kv(ulog_event *ev, size_t index) {
+    (void)(ev);
+    (void)(index);
+    return NULL;
+}
+
+#endif  // ULOG_HAS_KV
+
+/* ============================================================================
+   Core Functionality: Lock
+   (`lock_*`, depends on: - )
+============================================================================ */
+
+// Private
+// ================
+typedef struct {
+    ulog_lock_fn function;  // Lock function
+    void *args;             // Argument for the lock function
+} lock_data_t;
+
+static lock_data_t lock_data = {
+    .function = NULL,  // No lock function by default
+    .args     = NULL,  // No lock argument by default
+};
+
+static ulog_status lock_lock(void) {
+    if (lock_data.function != NULL) {
+        return lock_data.function(true, lock_data.args);
+    }
+    return ULOG_STATUS_OK;
+}
+
+static ulog_status lock_unlock(void) {
+    if (lock_data.function != NULL) {
+        return lock_data.function(false, lock_data.args);
+    }
+    return ULOG_STATUS_OK;
 }
 
 // Public
@@ -427,6 +1675,34 @@ ulog_status ulog_lock_set_fn(ulog_lock_fn function, void *lock_arg) {
     lock_data.args     = lock_arg;
     return ULOG_STATUS_OK;
 }
+
+/* ============================================================================
+   Core Feature: Generation
+   (`generation_*`, depends on: Atomics)
+============================================================================ */
+
+// Private
+// ================
+
+// Counter bumped on every configuration change (levels, outputs, topics,
+// dynamic config). Cached decisions (see Callsite) are valid only while the
+// generation they were computed for is current.
+typedef struct {
+    atomics_int value;
+} generation_data_t;
+
+static generation_data_t generation_data = {
+    .value = 0,
+};
+
+/// @brief Invalidates all cached decisions. Call with the lock held.
+static void generation_bump(void) {
+    (void)atomics_fetch_add(&generation_data.value, 1);
+}
+
+static unsigned int generation_get(void) {
+    return (unsigned int)atomics_load(&generation_data.value);
+}
 /* ============================================================================
    Optional Feature: Dynamic Configuration - Color
    (`color_config_*`, depends on: - )
@@ -456,6 +1732,7 @@ ulog_status ulog_color_config(bool enabled) {
         return ULOG_STATUS_BUSY;  // Failed to acquire lock
     }
     color_cfg.enabled = enabled;
+    generation_bump();
     return lock_unlock();
 }
 
@@ -556,6 +1833,7 @@ ulog_status ulog_prefix_config(bool enabled) {
         return ULOG_STATUS_BUSY;
     }
     prefix_cfg.enabled = enabled;
+    generation_bump();
     return lock_unlock();
 }
 
@@ -673,6 +1951,7 @@ ulog_status ulog_time_config(bool enabled) {
         return ULOG_STATUS_BUSY;
     }
     time_cfg.enabled = enabled;
+    generation_bump();
     return lock_unlock();
 }
 
@@ -703,62 +1982,265 @@ ulog_status ulog_time_config(bool enabled) {
 
 #include <time.h>
 
-#define TIME_SHORT_BUF_SIZE 10  // HH:MM:SS(8) + 1 space + null
-#define TIME_FULL_BUF_SIZE 21   // YYYY-MM-DD HH:MM:SS(19) + 1 space + null
+#ifndef ULOG_BUILD_TIME_PRECISION
+#define ULOG_BUILD_TIME_PRECISION 0
+#endif
+
+#if ULOG_BUILD_TIME_PRECISION != 0 && ULOG_BUILD_TIME_PRECISION != 3 &&       \
+    ULOG_BUILD_TIME_PRECISION != 6 && ULOG_BUILD_TIME_PRECISION != 9
+#error "ULOG_BUILD_TIME_PRECISION must be 0, 3, 6 or 9"
+#endif
+
+#define TIME_TEXT_LEN 19        // YYYY-MM-DD HH:MM:SS
+#define TIME_SHORT_OFFSET 11    // HH:MM:SS part of the text
+#define TIME_BUF_SIZE 32        // Text + "." + fraction + 1 space + null
+#define TIME_NS_PER_SEC 1000000000LL
 
 // Private
 // ================
-static bool time_print_if_invalid(print_target *tgt, ulog_event *ev) {
-    if (ev->time == NULL) {
-        print_to_target(tgt, "INVALID_TIME");
-        return true;  // Time is invalid, print error message
+
+// The broken-down time and its text change once per second, so they are
+// cached and shared by all events of that second. Each thread keeps its own
+// cache where thread-local storage is available, so it is consistent without
+// a lock; elsewhere the cache is shared and updated under the lock.
+#if defined(_MSC_VER)
+#define TIME_CACHE_LOCAL __declspec(thread)
+#elif (defined(__unix__) || defined(__APPLE__) || defined(_WIN32)) &&         \
+    defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define TIME_CACHE_LOCAL _Thread_local
+#elif (defined(__unix__) || defined(__APPLE__)) && defined(__GNUC__)
+#define TIME_CACHE_LOCAL __thread
+#else
+#define TIME_CACHE_LOCAL
+#endif
+
+typedef struct {
+    time_t sec;                     // Second of the cached values
+    bool valid;                     // false - nothing cached yet
+    struct tm tm;                   // Local time of `sec`
+    char text[TIME_TEXT_LEN + 1];   // Pre-rendered local time
+} time_cache;
+
+static TIME_CACHE_LOCAL time_cache time_data = {0};
+
+typedef struct {
+    ulog_time_fn function;     // NULL - wall clock, see time_now()
+    ulog_time_to_ns_fn to_ns;  // NULL - the function returns ns
+    void *arg;
+} time_source;
+
+static time_source time_src = {0};
+
+/// @brief Writes a zero-padded decimal number
+/// @param dst - Destination, `digits` characters are written
+static void time_put_digits(char *dst, long value, int digits) {
+    for (int i = digits - 1; i >= 0; i--) {
+        dst[i] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/// @brief Reads the wall clock
+/// @return Nanoseconds since the epoch
+static long long time_now(void) {
+#ifdef TIME_UTC
+    struct timespec ts;
+    if (timespec_get(&ts, TIME_UTC) == TIME_UTC) {
+        return (long long)ts.tv_sec * TIME_NS_PER_SEC + ts.tv_nsec;
+    }
+#endif
+    return (long long)time(NULL) * TIME_NS_PER_SEC;
+}
+
+/// @brief Converts to local time without the shared buffer of localtime()
+static bool time_to_local(const time_t *sec, struct tm *tm) {
+#if defined(_WIN32)
+    return localtime_s(tm, sec) == 0;
+#elif (defined(__unix__) || defined(__APPLE__)) && !defined(__STRICT_ANSI__)
+    return localtime_r(sec, tm) != NULL;
+#else
+    struct tm *local = localtime(sec);
+    if (local == NULL) {
+        return false;
+    }
+    *tm = *local;
+    return true;
+#endif
+}
+
+/// @brief Refreshes the cache for a new second
+/// @return false if the time cannot be converted
+static bool time_cache_update(time_t sec) {
+    if (time_data.valid && time_data.sec == sec) {
+        return true;  // Same second, nothing to do
+    }
+    time_data.valid = false;
+    if (!time_to_local(&sec, &time_data.tm)) {
+        return false;
+    }
+
+    const struct tm *tm = &time_data.tm;
+    char *text          = time_data.text;
+    time_put_digits(text, (long)tm->tm_year + 1900, 4);
+    text[4] = '-';
+    time_put_digits(text + 5, tm->tm_mon + 1, 2);
+    text[7] = '-';
+    time_put_digits(text + 8, tm->tm_mday, 2);
+    text[10] = ' ';
+    time_put_digits(text + 11, tm->tm_hour, 2);
+    text[13] = ':';
+    time_put_digits(text + 14, tm->tm_min, 2);
+    text[16] = ':';
+    time_put_digits(text + 17, tm->tm_sec, 2);
+    text[TIME_TEXT_LEN] = '\0';
+
+    time_data.sec   = sec;
+    time_data.valid = true;
+    return true;
+}
+
+/// @brief Reads the configured clock
+static long long time_read(void) {
+    if (time_src.function != NULL) {
+        return time_src.function(time_src.arg);
+    }
+    return time_now();
+}
+
+/// @brief Reads the clock on the first use of the event time, so filtered
+/// events and outputs without time never read it
+/// @param ev - Event. Assumed not NULL
+static void time_capture(ulog_event *ev) {
+    if (!ev->time_read) {
+        ev->time_stamp = time_read();
+        ev->time_read  = true;
+    }
+}
+
+/// @brief Converts the event time to seconds since the epoch, caching the
+/// local time of that second
+/// @param nsec - (Out) nanoseconds of the second
+/// @return false if the time cannot be converted
+static bool time_resolve(ulog_event *ev, long *nsec) {
+    time_capture(ev);
+    long long ns = ev->time_stamp;
+    if (time_src.to_ns != NULL) {
+        ns = time_src.to_ns(ns, time_src.arg);  // Ticks converted only here
+    }
+    long long sec = ns / TIME_NS_PER_SEC;
+    long long rem = ns % TIME_NS_PER_SEC;
+    if (rem < 0) {
+        sec -= 1;  // Before the epoch: round down
+        rem += TIME_NS_PER_SEC;
     }
-    return false;  // Time is valid
+    *nsec = (long)rem;
+    return time_cache_update((time_t)sec);
 }
 
-/// @brief Fills the event time with the current local time
-/// @param ev - Event to fill. Assumed not NULL
-static void time_fill_current_time(ulog_event *ev) {
-    time_t current_time = time(NULL);  // Get current time
-    // Use localtime because existing tests inspect local clock fields.
-    ev->time = localtime(&current_time);
+/// @brief Captures the event time if it is printed. Call before copying the
+/// event, so all copies print the same time.
+static void time_capture_printed(ulog_event *ev) {
+    if (time_config_is_enabled()) {
+        time_capture(ev);
+    }
+}
+
+/// @brief Converts the event time to local time, kept in the event
+/// @return Local time or NULL if it cannot be converted
+static struct tm *time_get_local(ulog_event *ev) {
+    long nsec = 0;
+    if (!time_resolve(ev, &nsec)) {
+        return NULL;
+    }
+    ev->time = time_data.tm;
+    return &ev->time;
+}
+
+/// @brief Prints the cached text from `offset`, with the configured fraction
+static void time_print_text(print_target *tgt, ulog_event *ev, size_t offset,
+                            bool append_space) {
+    long nsec = 0;
+    if (!time_resolve(ev, &nsec)) {
+        print_to_target(tgt, "INVALID_TIME");
+        return;
+    }
+
+    char buf[TIME_BUF_SIZE];
+    size_t len = TIME_TEXT_LEN - offset;
+    memcpy(buf, time_data.text + offset, len);
+#if ULOG_BUILD_TIME_PRECISION > 0
+    long fraction = nsec;
+    for (int i = ULOG_BUILD_TIME_PRECISION; i < 9; i++) {
+        fraction /= 10;
+    }
+    buf[len++] = '.';
+    time_put_digits(buf + len, fraction, ULOG_BUILD_TIME_PRECISION);
+    len += ULOG_BUILD_TIME_PRECISION;
+#endif
+    if (append_space) {
+        buf[len++] = ' ';
+    }
+    buf[len] = '\0';
+    print_to_target(tgt, "%s", buf);
 }
 
 static void time_print_short(print_target *tgt, ulog_event *ev,
                              bool append_space) {
-    if (!time_config_is_enabled() || time_print_if_invalid(tgt, ev)) {
-        return;  // If time is not valid or disabled, stop printing
+    if (!time_config_is_enabled()) {
+        return;  // Time is disabled, stop printing
     }
-    char buf[TIME_SHORT_BUF_SIZE] = {0};
-    const char *format            = append_space ? "%H:%M:%S " : "%H:%M:%S";
-    strftime(buf, TIME_SHORT_BUF_SIZE, format, ev->time);
-    print_to_target(tgt, "%s", buf);
+    time_print_text(tgt, ev, TIME_SHORT_OFFSET, append_space);
 }
 
 #if ULOG_HAS_EXTRA_OUTPUTS
 static void time_print_full(print_target *tgt, ulog_event *ev,
                             bool append_space) {
-    if (!time_config_is_enabled() || time_print_if_invalid(tgt, ev)) {
-        return;  // If time is not valid or disabled, stop printing
+    if (!time_config_is_enabled()) {
+        return;  // Time is disabled, stop printing
     }
-    char buf[TIME_FULL_BUF_SIZE] = {0};
-    const char *format =
-        append_space ? "%Y-%m-%d %H:%M:%S " : "%Y-%m-%d %H:%M:%S";
-    strftime(buf, TIME_FULL_BUF_SIZE, format, ev->time);
-    print_to_target(tgt, "%s", buf);
+    time_print_text(tgt, ev, 0, append_space);
 }
 #else
 #define time_print_full(tgt, ev, append_space) (void)(0)
 #endif  // ULOG_HAS_EXTRA_OUTPUTS
 
+// Public
+// ================
+
+ulog_status ulog_time_set_fn(ulog_time_fn function, ulog_time_to_ns_fn to_ns,
+                             void *arg) {
+    if (function == NULL && to_ns != NULL) {
+        return ULOG_STATUS_INVALID_ARGUMENT;  // Wall clock is already in ns
+    }
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return ULOG_STATUS_BUSY;
+    }
+    time_src.function = function;
+    time_src.to_ns    = to_ns;
+    time_src.arg      = arg;
+    return lock_unlock();
+}
+
 #else  // ULOG_HAS_TIME
 
+// Disabled Public
+// ================
+
+#if ULOG_HAS_WARN_NOT_ENABLED
+ulog_status ulog_time_set_fn(ulog_time_fn function, ulog_time_to_ns_fn to_ns,
+                             void *arg) {
+    (void)(function), (void)(to_ns), (void)(arg);
+    warn_not_enabled("ULOG_BUILD_TIME");
+    return ULOG_STATUS_DISABLED;
+}
+#endif  // ULOG_HAS_WARN_NOT_ENABLED
+
 // Disabled Private
 // ================
 
 #define time_print_short(tgt, ev, append_space) (void)(0)
 #define time_print_full(tgt, ev, append_space) (void)(0)
-#define time_fill_current_time(ev) (void)(ev)
+#define time_capture_printed(ev) (void)(ev)
 #endif  // ULOG_HAS_TIME
 
 /* ============================================================================
@@ -832,6 +2314,7 @@ ulog_status ulog_level_set_new_levels(const ulog_level_descriptor *new_levels) {
     }
 
     level_data.dsc = new_levels;
+    generation_bump();
     return lock_unlock();
 }
 
@@ -841,6 +2324,7 @@ ulog_status ulog_level_reset_levels(void) {
     }
 
     level_data.dsc = &level_names_default;
+    generation_bump();
     return lock_unlock();
 }
 
@@ -883,6 +2367,7 @@ ulog_status ulog_level_config(ulog_level_config_style style) {
     } else {
         level_data.dsc = &level_names_default;
     }
+    generation_bump();
     return lock_unlock();
 }
 
@@ -926,6 +2411,9 @@ ulog_status ulog_level_config(ulog_level_config_style style) {
 static void output_stdout_handler(ulog_event *ev, void *arg);
 static void log_print_event(print_target *tgt, ulog_event *ev, bool full_time,
                             bool color, bool new_line);
+#if ULOG_HAS_EXTRA_OUTPUTS
+static void log_print_json(print_target *tgt, ulog_event *ev);
+#endif
 
 typedef struct {
     ulog_output_handler_fn handler;
@@ -935,10 +2423,51 @@ typedef struct {
 
 typedef struct {
     output outputs[OUTPUT_TOTAL_NUM];  // order num = id. 0 is for stdout
+    atomics_int level_floor;  // Lowest level any output accepts, read unlocked
 } output_data_t;
 
 static output_data_t output_data = {
-    .outputs = {{output_stdout_handler, NULL, OUTPUT_STDOUT_DEFAULT_LEVEL}}};
+    .outputs     = {{output_stdout_handler, NULL, OUTPUT_STDOUT_DEFAULT_LEVEL}},
+    .level_floor = OUTPUT_STDOUT_DEFAULT_LEVEL,
+};
+
+/// @brief Recomputes the lowest level accepted by any registered output
+/// @note Must be called after every change of output levels or handlers,
+/// it also invalidates cached callsite decisions.
+/// Topics can only narrow what an output accepts, so they never lower it.
+static void output_level_floor_update(void) {
+    int floor = ULOG_LEVEL_TOTAL;  // No outputs - nothing passes
+    for (int i = 0; i < OUTPUT_TOTAL_NUM; i++) {
+        output *out = &output_data.outputs[i];
+        if (out->handler != NULL && (int)out->level < floor) {
+            floor = (int)out->level;
+        }
+    }
+    atomics_store(&output_data.level_floor, floor);
+    generation_bump();
+}
+
+/// @brief Lock-free check whether at least one output may accept the level
+/// @param level - Level to check
+/// @return true if the event can be accepted by some output
+static bool output_level_floor_allows(ulog_level level) {
+    return (int)level >= atomics_load(&output_data.level_floor);
+}
+
+/// @brief Checks if the output (or any output) accepts the level
+/// @param level - Level to check
+/// @param output_id - Output ID or ULOG_OUTPUT_ALL
+/// @return true if the event would be handled by at least one output
+static bool output_accepts(ulog_level level, ulog_output_id output_id) {
+    if (output_id == ULOG_OUTPUT_ALL) {
+        return output_level_floor_allows(level);
+    }
+    if (output_id < 0 || output_id >= OUTPUT_TOTAL_NUM) {
+        return false;  // Invalid output ID
+    }
+    output *out = &output_data.outputs[output_id];
+    return out->handler != NULL && level_is_allowed(level, out->level);
+}
 
 static void output_handle_single(ulog_event *ev, output *output) {
     if (output->handler == NULL) {
@@ -958,6 +2487,12 @@ static void output_handle_single(ulog_event *ev, output *output) {
         va_copy(ev_copy.message_format_args, ev->message_format_args);
         output->handler(&ev_copy, output->arg);
         va_end(ev_copy.message_format_args);
+
+#if ULOG_HAS_TIME
+        // The next outputs print the time read by this one
+        ev->time_read  = ev_copy.time_read;
+        ev->time_stamp = ev_copy.time_stamp;
+#endif
     }
 }
 
@@ -993,22 +2528,33 @@ ulog_status ulog_output_level_set(ulog_output_id output, ulog_level level) {
         return ULOG_STATUS_INVALID_ARGUMENT;
     }
 
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return ULOG_STATUS_BUSY;
+    }
     if (output_data.outputs[output].handler == NULL) {
+        if (lock_unlock() != ULOG_STATUS_OK) {
+            return ULOG_STATUS_BUSY;
+        }
         return ULOG_STATUS_NOT_FOUND;  // Output exists but no handler assigned
     }
     output_data.outputs[output].level = level;
-    return ULOG_STATUS_OK;
+    output_level_floor_update();
+    return lock_unlock();
 }
 
 ulog_status ulog_output_level_set_all(ulog_level level) {
     if (!level_is_valid(level)) {
         return ULOG_STATUS_INVALID_ARGUMENT;
     }
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return ULOG_STATUS_BUSY;
+    }
 
     for (int i = 0; i < OUTPUT_TOTAL_NUM; i++) {
         output_data.outputs[i].level = level;
     }
-    return ULOG_STATUS_OK;
+    output_level_floor_update();
+    return lock_unlock();
 }
 
 /* ============================================================================
@@ -1024,6 +2570,11 @@ static void output_file_handler(ulog_event *ev, void *arg) {
     log_print_event(&tgt, ev, true, false, true);
 }
 
+static void output_json_file_handler(ulog_event *ev, void *arg) {
+    print_target tgt = {.type = PRINT_TARGET_STREAM, .dsc.stream = (FILE *)arg};
+    log_print_json(&tgt, ev);
+}
+
 // Public
 // ================
 
@@ -1035,6 +2586,7 @@ ulog_output_id ulog_output_add(ulog_output_handler_fn handler, void *arg,
     for (int i = 0; i < OUTPUT_TOTAL_NUM; i++) {
         if (output_data.outputs[i].handler == NULL) {
             output_data.outputs[i] = (output){handler, arg, level};
+            output_level_floor_update();
             (void)lock_unlock();
             return i;
         }
@@ -1048,6 +2600,36 @@ ulog_output_id ulog_output_add_file(FILE *file, ulog_level level) {
     return ulog_output_add(output_file_handler, file, level);
 }
 
+ulog_output_id ulog_output_add_json_file(FILE *file, ulog_level level) {
+    return ulog_output_add(output_json_file_handler, file, level);
+}
+
+ulog_status ulog_event_to_line(ulog_event *ev, char *out, size_t out_size,
+                               size_t *len) {
+    if (ev == NULL || out == NULL || out_size == 0) {
+        return ULOG_STATUS_INVALID_ARGUMENT;
+    }
+    print_target tgt = {.type       = PRINT_TARGET_BUFFER,
+                        .dsc.buffer = {out, 0, out_size}};
+
+    time_capture_printed(ev);  // Same time as the other outputs of the event
+
+    ulog_event ev_copy;
+    memcpy(&ev_copy, ev, sizeof(ulog_event));
+    va_copy(ev_copy.message_format_args, ev->message_format_args);
+
+    log_print_event(&tgt, &ev_copy, true, false, true);  // As the file output
+
+    va_end(ev_copy.message_format_args);
+
+    // The position is capped at the buffer size if the line was truncated
+    bool complete = tgt.dsc.buffer.curr_pos < out_size;
+    if (len != NULL) {
+        *len = complete ? tgt.dsc.buffer.curr_pos : out_size - 1;
+    }
+    return complete ? ULOG_STATUS_OK : ULOG_STATUS_ERROR;
+}
+
 /// @brief Remove an output from the logging system
 ulog_status ulog_output_remove(ulog_output_id output) {
     if (output < 0 || output >= OUTPUT_TOTAL_NUM) {
@@ -1072,6 +2654,7 @@ ulog_status ulog_output_remove(ulog_output_id output) {
     output_data.outputs[output].handler = NULL;
     output_data.outputs[output].arg     = NULL;
     output_data.outputs[output].level   = ULOG_LEVEL_TRACE;
+    output_level_floor_update();
 
     return lock_unlock();
 }
@@ -1099,6 +2682,23 @@ ulog_output_id ulog_output_add_file(FILE *file, ulog_level level) {
     return ULOG_OUTPUT_INVALID;
 }
 
+ulog_output_id ulog_output_add_json_file(FILE *file, ulog_level level) {
+    (void)(file);
+    (void)(level);
+    warn_not_enabled("ULOG_BUILD_EXTRA_OUTPUTS");
+    return ULOG_OUTPUT_INVALID;
+}
+
+ulog_status ulog_event_to_line(ulog_event *ev, char *out, size_t out_size,
+                               size_t *len) {
+    (void)(ev);
+    (void)(out);
+    (void)(out_size);
+    (void)(len);
+    warn_not_enabled("ULOG_BUILD_EXTRA_OUTPUTS");
+    return ULOG_STATUS_DISABLED;
+}
+
 ulog_status ulog_output_remove(ulog_output_id output) {
     (void)(output);
     warn_not_enabled("ULOG_BUILD_EXTRA_OUTPUTS");
@@ -1138,6 +2738,7 @@ ulog_status ulog_topic_config(bool enabled) {
         return ULOG_STATUS_BUSY;
     }
     topic_cfg.enabled = enabled;
+    generation_bump();
     return lock_unlock();
 }
 
@@ -1182,13 +2783,13 @@ ulog_status ulog_topic_config(bool enabled) {
 #define TOPIC_LEVEL_DEFAULT ULOG_LEVEL_TRACE
 
 typedef struct topic_t {
-    ulog_topic_id id;
+    ulog_topic_id id;  // Dynamic: next free ID when the slot is free
     const char *name;
     ulog_level level;
     ulog_output_id output;
 
 #if TOPIC_IS_DYNAMIC
-    struct topic_t *next;  // Pointer to the next topic
+    uint32_t hash;  // Precomputed name hash
 #endif
 
 } topic_t;
@@ -1197,7 +2798,13 @@ typedef struct {
     bool new_topic_enabled;  // Whether new topics are enabled by default
 
 #if TOPIC_IS_DYNAMIC
-    topic_t *topics;
+    topic_t *topics;        // Topics indexed by ID, free slots have no name
+    int topics_num;         // Number of IDs ever handed out
+    int topics_capacity;    // Number of allocated topic slots
+    ulog_topic_id free_id;  // Head of the free slot list, chained by `id`
+    int *index;             // Open-addressing name index: IDs or TOPIC_INDEX_*
+    size_t index_capacity;  // Number of index slots, power of two
+    size_t index_filled;    // Index slots holding an ID or a tombstone
 #else
     topic_t topics[TOPIC_STATIC_NUM];
 #endif
@@ -1208,13 +2815,20 @@ static topic_data_t topic_data = {
     .new_topic_enabled = false,  // New topics are disabled by default
 
 #if TOPIC_IS_DYNAMIC
-    .topics = NULL,  // No topics allocated by default
+    .topics          = NULL,  // No topics allocated by default
+    .topics_num      = 0,
+    .topics_capacity = 0,
+    .free_id         = ULOG_TOPIC_ID_INVALID,
+    .index           = NULL,
+    .index_capacity  = 0,
+    .index_filled    = 0,
 #else
     .topics = {{0}},  // Initialize static topics array to zero
 #endif
 };
 
 // === Implementation specific functions for topics ===========================
+// All of them must be called with the lock held.
 
 /// @brief Converts a topic string to its ID
 /// @param str - Topic string
@@ -1226,11 +2840,14 @@ static ulog_topic_id topic_str_to_id(const char *str);
 /// @return Pointer to the topic if found, NULL otherwise
 static topic_t *topic_get(ulog_topic_id topic);
 
-/// @brief Add a new topic
+/// @brief Add a new topic or get the ID of the existing one
 /// @param topic_name - Topic name
 /// @param output - Output id
 static ulog_topic_id topic_add(const char *topic_name, ulog_output_id output);
 
+/// @brief Remove all topics and free their resources
+static void topic_remove_all(void);
+
 /// @brief Remove a topic by name
 /// @param topic_name - Topic name
 /// @return ulog_status
@@ -1249,6 +2866,19 @@ static void topic_print(print_target *tgt, ulog_event *ev) {
     }
 }
 
+#if ULOG_HAS_EXTRA_OUTPUTS
+/// @brief Gets the topic name of the event
+/// @return Topic name or NULL if the event has no topic
+static const char *topic_get_name(ulog_event *ev) {
+    if (!topic_config_is_enabled()) {
+        return NULL;  // Topics are disabled
+    }
+
+    topic_t *t = topic_get(ev->topic);
+    return t != NULL ? t->name : NULL;
+}
+#endif  // ULOG_HAS_EXTRA_OUTPUTS
+
 /// @brief Sets the topic level
 /// @param topic - Topic ID
 /// @param level - Log level to set
@@ -1260,6 +2890,7 @@ static ulog_status topic_set_level(int topic, ulog_level level) {
     topic_t *t = topic_get(topic);
     if (t != NULL) {
         t->level = level;
+        generation_bump();
         return ULOG_STATUS_OK;
     }
     return ULOG_STATUS_NOT_FOUND;
@@ -1279,6 +2910,26 @@ static bool topic_is_loggable(topic_t *t, ulog_level level) {
     return true;
 }
 
+/// @brief Processes the topic by ID
+/// @param topic_id - Topic ID
+/// @param level - Log level
+/// @param is_log_allowed - (Output) log allowed
+/// @param output - (Output) topic output ID
+static void topic_process_id(ulog_topic_id topic_id, ulog_level level,
+                             bool *is_log_allowed, ulog_output_id *output) {
+    if (is_log_allowed == NULL || output == NULL) {
+        return;  // Invalid arguments, do nothing
+    }
+
+    topic_t *t = topic_get(topic_id);
+
+    *is_log_allowed = topic_is_loggable(t, level);
+    if (!*is_log_allowed) {
+        return;  // Topic is not loggable, stop processing
+    }
+    *output = t->output;  // Set topic output
+}
+
 /// @brief Processes the topic
 /// @param topic - Topic name
 /// @param level - Log level
@@ -1288,33 +2939,48 @@ static bool topic_is_loggable(topic_t *t, ulog_level level) {
 static void topic_process(const char *topic, ulog_level level,
                           bool *is_log_allowed, int *topic_id,
                           ulog_output_id *output) {
-    if (is_log_allowed == NULL || topic_id == NULL || output == NULL) {
+    if (topic_id == NULL) {
         return;  // Invalid arguments, do nothing
     }
 
-    topic_t *t = topic_get(topic_str_to_id(topic));
-
-    *is_log_allowed = topic_is_loggable(t, level);
-    if (!*is_log_allowed) {
-        return;  // Topic is not loggable, stop processing
+    ulog_topic_id id = topic_str_to_id(topic);
+    topic_process_id(id, level, is_log_allowed, output);
+    if (is_log_allowed != NULL && *is_log_allowed) {
+        *topic_id = id;  // Set topic ID
     }
-    *topic_id = t->id;      // Set topic ID
-    *output   = t->output;  // Set topic output
 }
 
 // Public
 // ================
 
 ulog_status ulog_topic_level_set(const char *topic_name, ulog_level level) {
-    ulog_topic_id topic_id = ulog_topic_get_id(topic_name);
-    if (topic_id == ULOG_TOPIC_ID_INVALID) {
+    if (is_str_empty(topic_name)) {
         return ULOG_STATUS_NOT_FOUND;  // Topic not found, do nothing
     }
-    return topic_set_level(topic_id, level);
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return ULOG_STATUS_BUSY;
+    }
+    ulog_status status     = ULOG_STATUS_NOT_FOUND;
+    ulog_topic_id topic_id = topic_str_to_id(topic_name);
+    if (topic_id != ULOG_TOPIC_ID_INVALID) {
+        status = topic_set_level(topic_id, level);
+    }
+    if (lock_unlock() != ULOG_STATUS_OK) {
+        return ULOG_STATUS_BUSY;
+    }
+    return status;
 }
 
 ulog_topic_id ulog_topic_get_id(const char *topic_name) {
-    return topic_str_to_id(topic_name);
+    if (is_str_empty(topic_name)) {
+        return ULOG_TOPIC_ID_INVALID;
+    }
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return ULOG_TOPIC_ID_INVALID;
+    }
+    ulog_topic_id id = topic_str_to_id(topic_name);
+    (void)lock_unlock();
+    return id;
 }
 
 ulog_topic_id ulog_topic_add(const char *topic_name, ulog_output_id output,
@@ -1322,10 +2988,14 @@ ulog_topic_id ulog_topic_add(const char *topic_name, ulog_output_id output,
     if (is_str_empty(topic_name)) {
         return ULOG_TOPIC_ID_INVALID;  // Invalid topic name, do nothing
     }
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return ULOG_TOPIC_ID_INVALID;
+    }
     ulog_topic_id id = topic_add(topic_name, output);
     if (id != ULOG_TOPIC_ID_INVALID) {
         topic_set_level(id, level);
     }
+    (void)lock_unlock();
     return id;
 }
 
@@ -1333,7 +3003,14 @@ ulog_status ulog_topic_remove(const char *topic_name) {
     if (is_str_empty(topic_name)) {
         return ULOG_STATUS_INVALID_ARGUMENT;  // Invalid topic name, do nothing
     }
-    return topic_remove(topic_name);
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return ULOG_STATUS_BUSY;
+    }
+    ulog_status status = topic_remove(topic_name);
+    if (lock_unlock() != ULOG_STATUS_OK) {
+        return ULOG_STATUS_BUSY;
+    }
+    return status;
 }
 
 #else  // ULOG_HAS_TOPICS
@@ -1377,9 +3054,13 @@ ulog_status ulog_topic_remove(const char *topic_name) {
 // ================
 
 #define topic_print(tgt, ev) (void)(tgt), (void)(ev)
+#define topic_get_name(ev) ((void)(ev), (const char *)NULL)
+#define topic_remove_all() (void)(0)
 #define topic_process(topic, level, is_log_allowed, topic_id, output)          \
     (void)(topic), (void)(level), (void)(is_log_allowed), (void)(topic_id),    \
         (void)(output)
+#define topic_process_id(topic_id, level, is_log_allowed, output)              \
+    (void)(topic_id), (void)(level), (void)(is_log_allowed), (void)(output)
 
 #endif  // ULOG_HAS_TOPICS
 
@@ -1404,19 +3085,17 @@ ulog_topic_id topic_str_to_id(const char *str) {
 }
 
 static topic_t *topic_get(ulog_topic_id topic) {
-    if (topic < TOPIC_STATIC_NUM && topic >= 0) {
-        return &topic_data.topics[topic];
+    if (topic < 0 || topic >= TOPIC_STATIC_NUM) {
+        return NULL;  // Invalid topic ID
     }
-    return NULL;
+    topic_t *t = &topic_data.topics[topic];
+    return is_str_empty(t->name) ? NULL : t;  // Empty slot
 }
 
 static ulog_topic_id topic_add(const char *topic_name, ulog_output_id output) {
     if (is_str_empty(topic_name)) {
         return ULOG_TOPIC_ID_INVALID;
     }
-    if (lock_lock() != ULOG_STATUS_OK) {  // Lock the configuration
-        return ULOG_TOPIC_ID_INVALID;
-    }
     for (int i = 0; i < TOPIC_STATIC_NUM; i++) {
         // If there is an empty slot
         if (is_str_empty(topic_data.topics[i].name)) {
@@ -1424,16 +3103,14 @@ static ulog_topic_id topic_add(const char *topic_name, ulog_output_id output) {
             topic_data.topics[i].name   = topic_name;
             topic_data.topics[i].level  = TOPIC_LEVEL_DEFAULT;
             topic_data.topics[i].output = output;
-            (void)lock_unlock();  // Unlock the configuration
+            generation_bump();
             return i;
         }
         // If the topic already exists
         else if (strcmp(topic_data.topics[i].name, topic_name) == 0) {
-            (void)lock_unlock();  // Unlock the configuration
             return i;
         }
     }
-    (void)lock_unlock();           // Unlock the configuration
     return ULOG_TOPIC_ID_INVALID;  // No space for new topics
 }
 
@@ -1441,9 +3118,6 @@ static ulog_status topic_remove(const char *topic_name) {
     if (is_str_empty(topic_name)) {
         return ULOG_STATUS_INVALID_ARGUMENT;  // Invalid topic name, do nothing
     }
-    if (lock_lock() != ULOG_STATUS_OK) {  // Lock the configuration
-        return ULOG_STATUS_BUSY;
-    }
     for (int i = 0; i < TOPIC_STATIC_NUM; i++) {
         if (is_str_empty(topic_data.topics[i].name)) {
             continue;  // Skip empty slot; continue search
@@ -1451,14 +3125,17 @@ static ulog_status topic_remove(const char *topic_name) {
         if (strcmp(topic_data.topics[i].name, topic_name) == 0) {
             // Clear the topic entry
             topic_data.topics[i] = (topic_t){0};
-            return lock_unlock();
+            generation_bump();
+            return ULOG_STATUS_OK;
         }
     }
-    if (lock_unlock() != ULOG_STATUS_OK) {  // Unlock the configuration
-        return ULOG_STATUS_BUSY;
-    }
     return ULOG_STATUS_NOT_FOUND;  // Topic not found
 }
+
+static void topic_remove_all(void) {
+    // Zero out statically allocated topic array
+    memset(topic_data.topics, 0, sizeof(topic_data.topics));
+}
 #endif  // ULOG_HAS_TOPICS && TOPIC_IS_DYNAMIC == false
 
 /* ============================================================================
@@ -1470,72 +3147,128 @@ static ulog_status topic_remove(const char *topic_name) {
 // Private
 // ================
 
-static topic_t *topic_get_first(void) {
-    return topic_data.topics;
+#define TOPIC_INDEX_EMPTY (-1)          // Index slot was never used
+#define TOPIC_INDEX_DELETED (-2)        // Index slot of a removed topic
+#define TOPIC_INDEX_MIN_CAPACITY 16     // Power of two
+#define TOPIC_TOPICS_MIN_CAPACITY 8
+
+/// @brief FNV-1a hash of a topic name
+static uint32_t topic_hash(const char *str) {
+    uint32_t hash = 2166136261u;
+    while (*str != '\0') {
+        hash ^= (uint8_t)*str++;
+        hash *= 16777619u;
+    }
+    return hash;
 }
 
-static topic_t *topic_get_next(topic_t *t) {
-    return t->next;
+static topic_t *topic_get(int topic) {
+    if (topic < 0 || topic >= topic_data.topics_num) {
+        return NULL;  // Invalid topic ID
+    }
+    topic_t *t = &topic_data.topics[topic];
+    return is_str_empty(t->name) ? NULL : t;
 }
 
-static topic_t *topic_get_last(void) {
-    topic_t *last = topic_data.topics;
-    if (last == NULL) {
-        return NULL;  // No topics
-    }
-    while (last->next != NULL) {
-        last = last->next;
+/// @brief Finds the index slot of a topic
+/// @param str - Topic name
+/// @param hash - Hash of the topic name
+/// @return Slot position, or -1 if the topic is not indexed
+static long topic_index_find(const char *str, uint32_t hash) {
+    size_t mask = topic_data.index_capacity - 1;
+    for (size_t n = 0, i = hash & mask; n < topic_data.index_capacity;
+         n++, i = (i + 1) & mask) {
+        int id = topic_data.index[i];
+        if (id == TOPIC_INDEX_EMPTY) {
+            return -1;  // End of the probe sequence
+        }
+        if (id >= 0 && topic_data.topics[id].hash == hash &&
+            strcmp(topic_data.topics[id].name, str) == 0) {
+            return (long)i;
+        }
     }
-    return last;
+    return -1;
 }
 
-ulog_topic_id topic_str_to_id(const char *str) {
-    for (topic_t *t = topic_get_first(); t != NULL; t = topic_get_next(t)) {
-        if (!is_str_empty(t->name) && strcmp(t->name, str) == 0) {
-            return t->id;
-        }
+/// @brief Puts the topic ID into the index, there must be a free slot
+static void topic_index_insert(ulog_topic_id id) {
+    size_t mask = topic_data.index_capacity - 1;
+    size_t i    = topic_data.topics[id].hash & mask;
+    while (topic_data.index[i] >= 0) {
+        i = (i + 1) & mask;
     }
-    return ULOG_TOPIC_ID_INVALID;
+    if (topic_data.index[i] == TOPIC_INDEX_EMPTY) {
+        topic_data.index_filled++;  // Reused tombstones are already counted
+    }
+    topic_data.index[i] = id;
 }
 
-static topic_t *topic_get(int topic) {
-    if (topic < 0) {
-        return NULL;  // Invalid topic ID
+/// @brief Makes sure one more topic can be indexed, rebuilding the index
+/// (and dropping tombstones) when it is 3/4 full
+/// @return true on success, false on allocation failure
+static bool topic_index_reserve(void) {
+    if ((topic_data.index_filled + 1) * 4 <= topic_data.index_capacity * 3) {
+        return true;
+    }
+
+    size_t live = 1;  // Including the one being added
+    for (int id = 0; id < topic_data.topics_num; id++) {
+        live += is_str_empty(topic_data.topics[id].name) ? 0 : 1;
+    }
+    size_t capacity = TOPIC_INDEX_MIN_CAPACITY;
+    while (capacity < live * 2) {
+        capacity *= 2;  // Keep the load below 1/2 after a rebuild
     }
-    for (topic_t *t = topic_get_first(); t != NULL; t = topic_get_next(t)) {
-        if (t->id == topic) {
-            return t;
+
+    int *index = malloc(capacity * sizeof(int));
+    if (index == NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < capacity; i++) {
+        index[i] = TOPIC_INDEX_EMPTY;
+    }
+    free(topic_data.index);
+    topic_data.index          = index;
+    topic_data.index_capacity = capacity;
+    topic_data.index_filled   = 0;
+    for (int id = 0; id < topic_data.topics_num; id++) {
+        if (!is_str_empty(topic_data.topics[id].name)) {
+            topic_index_insert(id);
         }
     }
-    return NULL;
+    return true;
 }
 
-static topic_t *topic_allocate(int id, const char *topic_name,
-                               ulog_output_id output) {
-    if (is_str_empty(topic_name)) {
-        return NULL;  // Invalid topic name, do not allocate
+/// @brief Makes sure there is a slot for one more topic ID
+/// @return true on success, false on allocation failure
+static bool topic_topics_reserve(void) {
+    if (topic_data.free_id != ULOG_TOPIC_ID_INVALID ||
+        topic_data.topics_num < topic_data.topics_capacity) {
+        return true;
     }
-    if (id < 0) {
-        return NULL;  // Invalid ID, do not allocate
+    int capacity = topic_data.topics_capacity * 2;
+    if (capacity < TOPIC_TOPICS_MIN_CAPACITY) {
+        capacity = TOPIC_TOPICS_MIN_CAPACITY;
     }
-    topic_t *t = malloc(sizeof(topic_t));
-    if (t != NULL) {
-        // Allocate memory for the topic name and copy it
-        size_t name_len = strlen(topic_name) + 1;
-        char *name_copy = malloc(name_len);
-        if (name_copy == NULL) {
-            free(t);
-            return NULL;  // Failed to allocate memory for name
-        }
-        strcpy(name_copy, topic_name);
+    topic_t *topics =
+        realloc(topic_data.topics, (size_t)capacity * sizeof(topic_t));
+    if (topics == NULL) {
+        return false;
+    }
+    topic_data.topics          = topics;
+    topic_data.topics_capacity = capacity;
+    return true;
+}
 
-        t->id     = id;
-        t->name   = name_copy;
-        t->level  = TOPIC_LEVEL_DEFAULT;
-        t->output = output;
-        t->next   = NULL;
+ulog_topic_id topic_str_to_id(const char *str) {
+    if (is_str_empty(str) || topic_data.index_capacity == 0) {
+        return ULOG_TOPIC_ID_INVALID;
+    }
+    long slot = topic_index_find(str, topic_hash(str));
+    if (slot < 0) {
+        return ULOG_TOPIC_ID_INVALID;
     }
-    return t;
+    return topic_data.index[slot];
 }
 
 static ulog_topic_id topic_add(const char *topic_name, ulog_output_id output) {
@@ -1544,69 +3277,72 @@ static ulog_topic_id topic_add(const char *topic_name, ulog_output_id output) {
     }
 
     // if exists
-    for (topic_t *t = topic_get_first(); t != NULL; t = topic_get_next(t)) {
-        if (!is_str_empty(t->name) && strcmp(t->name, topic_name) == 0) {
-            return t->id;
-        }
+    ulog_topic_id id = topic_str_to_id(topic_name);
+    if (id != ULOG_TOPIC_ID_INVALID) {
+        return id;
     }
 
-    // If the beginning is empty
-    if (lock_lock() != ULOG_STATUS_OK) {
-        return ULOG_TOPIC_ID_INVALID;
+    if (!topic_topics_reserve() || !topic_index_reserve()) {
+        return ULOG_TOPIC_ID_INVALID;  // Failed to allocate memory
     }
-    topic_t *t = topic_get_last();
-    if (t == NULL) {
-        topic_data.topics = topic_allocate(0, topic_name, output);
-        if (topic_data.topics != NULL) {
-            (void)lock_unlock();
-            return 0;
-        }
-        (void)lock_unlock();
-        return ULOG_TOPIC_ID_INVALID;
+
+    // Allocate memory for the topic name and copy it
+    size_t name_len = strlen(topic_name) + 1;
+    char *name_copy = malloc(name_len);
+    if (name_copy == NULL) {
+        return ULOG_TOPIC_ID_INVALID;  // Failed to allocate memory for name
     }
+    memcpy(name_copy, topic_name, name_len);
 
-    // If the beginning is not empty
-    t->next = topic_allocate(t->id + 1, topic_name, output);
-    if (t->next) {
-        (void)lock_unlock();
-        return t->id + 1;
+    if (topic_data.free_id != ULOG_TOPIC_ID_INVALID) {
+        id                 = topic_data.free_id;  // Reuse a removed slot
+        topic_data.free_id = topic_data.topics[id].id;
+    } else {
+        id = topic_data.topics_num++;
     }
-    (void)lock_unlock();
-    return ULOG_TOPIC_ID_INVALID;
+    topic_t *t = &topic_data.topics[id];
+    t->id      = id;
+    t->name    = name_copy;
+    t->level   = TOPIC_LEVEL_DEFAULT;
+    t->output  = output;
+    t->hash    = topic_hash(topic_name);
+    topic_index_insert(id);
+    generation_bump();
+    return id;
 }
 
 static ulog_status topic_remove(const char *topic_name) {
-    if (is_str_empty(topic_name)) {
-        return ULOG_STATUS_INVALID_ARGUMENT;  // Invalid topic name, do nothing
+    if (is_str_empty(topic_name) || topic_data.index_capacity == 0) {
+        return ULOG_STATUS_NOT_FOUND;
     }
-    if (lock_lock() != ULOG_STATUS_OK) {  // Lock the configuration
-        return ULOG_STATUS_BUSY;
+    long slot = topic_index_find(topic_name, topic_hash(topic_name));
+    if (slot < 0) {
+        return ULOG_STATUS_NOT_FOUND;  // Topic not found
     }
 
-    topic_t *t      = topic_get_first();
-    topic_t *t_prev = NULL;
-
-    while (t != NULL) {
-        if (!is_str_empty(t->name) && strcmp(t->name, topic_name) == 0) {
-            // Found the topic to remove
-            if (t_prev == NULL) {
-                // Removing the first topic
-                topic_data.topics = t->next;
-            } else {
-                t_prev->next = t->next;
-            }
-            free((void *)t->name);  // Free the allocated topic name
-            free(t);                // Free the topic memory
-            return lock_unlock();
-        }
-        t_prev = t;
-        t      = t->next;
-    }
+    ulog_topic_id id = topic_data.index[slot];
+    topic_t *t       = &topic_data.topics[id];
+    free((void *)t->name);  // Free the allocated topic name
+    *t                     = (topic_t){.id = topic_data.free_id};
+    topic_data.free_id     = id;  // The slot becomes the head of free list
+    topic_data.index[slot] = TOPIC_INDEX_DELETED;
+    generation_bump();
+    return ULOG_STATUS_OK;
+}
 
-    if (lock_unlock() != ULOG_STATUS_OK) {  // Unlock the configuration
-        return ULOG_STATUS_BUSY;
+static void topic_remove_all(void) {
+    for (int id = 0; id < topic_data.topics_num; id++) {
+        free((void *)topic_data.topics[id].name);
     }
-    return ULOG_STATUS_NOT_FOUND;  // Topic not found
+    free(topic_data.topics);
+    free(topic_data.index);
+    topic_data.topics          = NULL;
+    topic_data.topics_num      = 0;
+    topic_data.topics_capacity = 0;
+    topic_data.free_id         = ULOG_TOPIC_ID_INVALID;
+    topic_data.index           = NULL;
+    topic_data.index_capacity  = 0;
+    topic_data.index_filled    = 0;
 }
 
 #endif  // ULOG_HAS_TOPICS && TOPIC_IS_DYNAMIC == true
@@ -1640,6 +3376,7 @@ ulog_status ulog_source_location_config(bool enabled) {
         return ULOG_STATUS_BUSY;
     }
     src_loc_cfg.enabled = enabled;
+    generation_bump();
     return lock_unlock();
 }
 
@@ -1664,6 +3401,396 @@ ulog_status ulog_source_location_config(bool enabled) {
 #define src_loc_config_is_enabled() (ULOG_HAS_SOURCE_LOCATION)
 #endif  // ULOG_HAS_DYNAMIC_CONFIG
 
+/* ============================================================================
+   Optional Feature: JSON Output
+   (`json_*`, depends on: Print, Events, Levels, Time, Topics, Key-Value
+                          Fields, Source Location, Extra Outputs)
+============================================================================ */
+#if ULOG_HAS_EXTRA_OUTPUTS
+
+#include <math.h>  // isfinite() - macro, no libm needed
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#define JSON_SCAN_SSE2 1
+#elif defined(__GNUC__) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define JSON_SCAN_NEON 1
+#endif
+
+// Private
+// ================
+
+// Each event is one JSON object on its own line (JSON Lines):
+//
+// {"time":"...","level":"INFO","topic":"net","file":"main.c","line":12,
+//  "message":"...","<key>":<value>,...}
+//
+// Fields of disabled features are left out. The message is formatted into
+// JSON_TEXT_BUF_SIZE first. A longer one is escaped straight to the target a
+// piece at a time: literal text and plain %s strings as they are, other
+// conversions formatted one by one; only a format with a conversion of
+// unknown argument type is truncated at a character boundary. Strings are
+// scanned 16 bytes at a time for characters to escape
+// (quote, backslash and control characters), the runs between them are
+// copied as they are. Stream outputs get the line assembled in
+// JSON_LINE_BUF_SIZE with a single write; longer lines (escape-heavy messages
+// or long key-value strings) are rendered again straight to the stream.
+
+#define JSON_TEXT_BUF_SIZE 512   // Formatted message, before escaping
+#define JSON_LINE_BUF_SIZE 1024  // Whole line, written at once
+
+static void log_print_text(print_target *tgt, ulog_event *ev);
+
+/// @brief Gets the length of the leading run that needs no escaping
+/// @param str - String
+/// @param len - String length
+/// @return Index of the first character to escape or `len` if none
+static size_t json_plain_len(const char *str, size_t len) {
+    size_t i = 0;
+
+#if defined(JSON_SCAN_SSE2)
+    const __m128i quote     = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control   = _mm_set1_epi8(0x1f);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(const void *)(str + i));
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                         _mm_cmpeq_epi8(v, backslash)),
+            _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));  // v <= 0x1f
+        unsigned int bits = (unsigned int)_mm_movemask_epi8(m);
+        if (bits != 0) {
+            return i + (size_t)__builtin_ctz(bits);
+        }
+    }
+#elif defined(JSON_SCAN_NEON)
+    const uint8x16_t quote     = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t control   = vdupq_n_u8(0x20);
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8((const uint8_t *)str + i);
+        uint8x16_t m = vorrq_u8(
+            vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)),
+            vcltq_u8(v, control));
+        // 4 bits per byte: narrow each 16-bit lane by 4
+        uint64_t bits = vget_lane_u64(
+            vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+        if (bits != 0) {
+            return i + (size_t)(__builtin_ctzll(bits) >> 2);
+        }
+    }
+#endif
+
+    for (; i < len; i++) {
+        unsigned char c = (unsigned char)str[i];
+        if (c == '"' || c == '\\' || c < 0x20) {
+            return i;
+        }
+    }
+    return len;
+}
+
+/// @brief Shortens a truncated UTF-8 string so that it does not end in the
+/// middle of a multi-byte sequence
+/// @return The new length
+static size_t json_utf8_cut(const char *str, size_t len) {
+    size_t lead = len;
+    while (lead > 0 && len - lead < 4 &&
+           ((unsigned char)str[lead - 1] & 0xc0) == 0x80) {
+        lead--;  // Continuation byte
+    }
+    if (lead == 0) {
+        return len;  // No lead byte, not UTF-8
+    }
+    unsigned char c = (unsigned char)str[lead - 1];
+    size_t need     = c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : c >= 0xc0 ? 2 : 1;
+    return len - (lead - 1) < need ? lead - 1 : len;
+}
+
+/// @brief Prints the escape sequence of a character
+static void json_print_escape(print_target *tgt, unsigned char c) {
+    char seq[6] = {'\\', '\0', '0', '0', '0', '0'};
+    size_t len  = 2;
+    switch (c) {
+        case '"':
+            seq[1] = '"';
+            break;
+        case '\\':
+            seq[1] = '\\';
+            break;
+        case '\n':
+            seq[1] = 'n';
+            break;
+        case '\r':
+            seq[1] = 'r';
+            break;
+        case '\t':
+            seq[1] = 't';
+            break;
+        default:
+            seq[1] = 'u';  // \u00XX
+            seq[4] = "0123456789abcdef"[c >> 4];
+            seq[5] = "0123456789abcdef"[c & 0xf];
+            len    = sizeof(seq);
+            break;
+    }
+    print_to_target_text(tgt, seq, len);
+}
+
+/// @brief Prints the string escaped, without quotes
+static void json_print_escaped(print_target *tgt, const char *str,
+                               size_t len) {
+    while (len > 0) {
+        size_t run = json_plain_len(str, len);
+        print_to_target_text(tgt, str, run);
+        if (run == len) {
+            break;
+        }
+        json_print_escape(tgt, (unsigned char)str[run]);
+        str += run + 1;
+        len -= run + 1;
+    }
+}
+
+/// @brief Prints a quoted and escaped JSON string
+static void json_print_str(print_target *tgt, const char *str, size_t len) {
+    print_to_target_text(tgt, "\"", 1);
+    json_print_escaped(tgt, str, len);
+    print_to_target_text(tgt, "\"", 1);
+}
+
+/// @brief Prints `,"key":` followed by the string value
+static void json_print_field(print_target *tgt, const char *key,
+                             const char *str, size_t len) {
+    print_to_target(tgt, ",\"%s\":", key);
+    json_print_str(tgt, str, len);
+}
+
+#if ULOG_HAS_KV
+/// @brief Prints the key-value fields of the event as members of the object
+static void json_print_kv(print_target *tgt, ulog_event *ev) {
+    for (size_t i = 0; i < ev->kv_count; i++) {
+        const ulog_kv *kv = &ev->kv[i];
+        const char *key   = kv->key != NULL ? kv->key : "NULL";
+        print_to_target_text(tgt, ",", 1);
+        json_print_str(tgt, key, strlen(key));
+        print_to_target_text(tgt, ":", 1);
+        switch (kv->type) {
+            case ULOG_KV_TYPE_INT:
+                print_to_target(tgt, "%lld", kv->value.i);
+                break;
+            case ULOG_KV_TYPE_UINT:
+                print_to_target(tgt, "%llu", kv->value.u);
+                break;
+            case ULOG_KV_TYPE_DOUBLE:
+                isfinite(kv->value.d)
+                    ? kv_print_double(tgt, kv->value.d)
+                    : print_to_target_text(tgt, "null", 4);  // No NaN in JSON
+                break;
+            case ULOG_KV_TYPE_BOOL:
+                kv->value.b ? print_to_target_text(tgt, "true", 4)
+                            : print_to_target_text(tgt, "false", 5);
+                break;
+            case ULOG_KV_TYPE_STR:
+                kv->value.s != NULL
+                    ? json_print_str(tgt, kv->value.s, strlen(kv->value.s))
+                    : print_to_target_text(tgt, "null", 4);
+                break;
+            default:
+                print_to_target_text(tgt, "null", 4);
+                break;
+        }
+    }
+}
+#else
+#define json_print_kv(tgt, ev) ((void)(tgt), (void)(ev))
+#endif  // ULOG_HAS_KV
+
+/// @brief Checks for a `%s` without width or precision, printed as it is
+static bool json_spec_is_plain_str(const print_spec *spec) {
+    return spec->type == PRINT_ARG_STRING && spec->width == 0 &&
+           spec->precision < 0 && !spec->star_width && !spec->star_precision;
+}
+
+/// @brief Checks that every conversion has a known argument type, so the
+/// arguments can be taken one at a time
+static bool json_format_is_walkable(const char *format) {
+    const char *spec_start = strchr(format, '%');
+    while (spec_start != NULL) {
+        print_spec spec;
+        print_spec_parse(spec_start, &spec);
+        if (spec.type == PRINT_ARG_UNSUPPORTED) {
+            return false;
+        }
+        spec_start = strchr(spec_start + spec.len, '%');
+    }
+    return true;
+}
+
+/// @brief Prints the formatted message escaped, one conversion at a time
+/// @param text - Buffer for a conversion other than a plain `%s`
+static void json_print_format(print_target *tgt, char *text, size_t size,
+                              const char *format, va_list args) {
+    va_list args_copy;
+    va_copy(args_copy, args);
+    const char *p          = format;
+    const char *spec_start = strchr(p, '%');
+    while (spec_start != NULL) {
+        json_print_escaped(tgt, p, (size_t)(spec_start - p));
+        print_spec spec;
+        print_spec_parse(spec_start, &spec);
+        if (json_spec_is_plain_str(&spec)) {
+            const char *str = va_arg(args_copy, const char *);
+            str             = str != NULL ? str : "(null)";
+            json_print_escaped(tgt, str, strlen(str));
+        } else {
+            print_sink sink = {text, size, 0};
+            (void)print_format_libc(&sink, &spec, &args_copy);
+            json_print_escaped(tgt, text, sink.len < size ? sink.len : size - 1);
+        }
+        p          = spec_start + spec.len;
+        spec_start = strchr(p, '%');
+    }
+    json_print_escaped(tgt, p, strlen(p));
+    va_end(args_copy);
+}
+
+#if ULOG_HAS_CAPTURE
+/// @brief Prints a record made by `capture_args` escaped, one conversion at a
+/// time
+/// @param text - Buffer for a conversion other than a plain `%s`
+static void json_print_capture(print_target *tgt, char *text, size_t size,
+                               const char *record) {
+    const char *format = record;
+    record += strlen(format) + 1;
+
+    const char *p          = format;
+    const char *spec_start = strchr(p, '%');
+    while (spec_start != NULL) {
+        json_print_escaped(tgt, p, (size_t)(spec_start - p));
+        print_spec spec;
+        print_spec_parse(spec_start, &spec);
+        if (json_spec_is_plain_str(&spec)) {
+            size_t len = strlen(record);
+            json_print_escaped(tgt, record, len);
+            record += len + 1;
+        } else {
+            print_target buf = {.type       = PRINT_TARGET_BUFFER,
+                                .dsc.buffer = {text, 0, size}};
+            record           = capture_print_spec(&buf, &spec, record);
+            size_t len       = buf.dsc.buffer.curr_pos;
+            json_print_escaped(tgt, text, len < size ? len : size - 1);
+        }
+        p          = spec_start + spec.len;
+        spec_start = strchr(p, '%');
+    }
+    json_print_escaped(tgt, p, strlen(p));
+}
+#endif  // ULOG_HAS_CAPTURE
+
+/// @brief Prints the message field of an event longer than the text buffer,
+/// escaped a piece at a time straight to the target
+/// @param text - Buffer for one conversion
+/// @return false if the format has a conversion of unknown argument type,
+/// nothing is printed then
+static bool json_print_long_message(print_target *tgt, ulog_event *ev,
+                                    char *text, size_t size) {
+#if ULOG_HAS_CAPTURE
+    if (ev->capture != NULL) {
+        print_to_target_text(tgt, ",\"message\":\"", 12);
+        json_print_capture(tgt, text, size, ev->capture);
+        print_to_target_text(tgt, "\"", 1);
+        return true;
+    }
+#endif  // ULOG_HAS_CAPTURE
+
+    if (ev->message == log_text_format) {
+        va_list args;
+        va_copy(args, ev->message_format_args);
+        const char *str = va_arg(args, const char *);
+        size_t len      = va_arg(args, size_t);
+        va_end(args);
+        json_print_field(tgt, "message", str, len);
+        return true;
+    }
+    if (!json_format_is_walkable(ev->message)) {
+        return false;
+    }
+    print_to_target_text(tgt, ",\"message\":\"", 12);
+    json_print_format(tgt, text, size, ev->message, ev->message_format_args);
+    print_to_target_text(tgt, "\"", 1);
+    return true;
+}
+
+/// @brief Writes the event as a JSON object
+/// @param tgt - Target
+/// @param ev - Event
+/// @param new_line - New line in the end or no new line
+static void json_render_event(print_target *tgt, ulog_event *ev,
+                              bool new_line) {
+    char text[JSON_TEXT_BUF_SIZE];
+    print_target buf = {.type       = PRINT_TARGET_BUFFER,
+                        .dsc.buffer = {text, 0, sizeof(text)}};
+
+    print_to_target_text(tgt, "{", 1);
+
+    time_print_full(&buf, ev, false);
+    if (buf.dsc.buffer.curr_pos > 0) {
+        print_to_target(tgt, "\"time\":\"%s\",", text);  // Digits only
+    }
+
+    const char *level = level_data.dsc->names[ev->level];
+    size_t level_len  = strlen(level);
+    while (level_len > 0 && level[level_len - 1] == ' ') {
+        level_len--;  // Names are padded for the text output
+    }
+    print_to_target_text(tgt, "\"level\":", 8);
+    json_print_str(tgt, level, level_len);
+
+    const char *topic = topic_get_name(ev);
+    if (topic != NULL) {
+        json_print_field(tgt, "topic", topic, strlen(topic));
+    }
+
+#if ULOG_HAS_SOURCE_LOCATION
+    if (src_loc_config_is_enabled() && ev->file != NULL) {
+        json_print_field(tgt, "file", ev->file, strlen(ev->file));
+        print_to_target(tgt, ",\"line\":%d", ev->line);
+    }
+#endif  // ULOG_HAS_SOURCE_LOCATION
+
+    // Format from a copy, a long message needs the va_list again
+    ulog_event ev_copy;
+    memcpy(&ev_copy, ev, sizeof(ulog_event));
+    va_copy(ev_copy.message_format_args, ev->message_format_args);
+    buf.dsc.buffer.curr_pos = 0;
+    log_print_text(&buf, &ev_copy);
+    va_end(ev_copy.message_format_args);
+    size_t text_len = buf.dsc.buffer.curr_pos;
+    if (text_len < sizeof(text)) {
+        json_print_field(tgt, "message", text, text_len);
+    } else if (!json_print_long_message(tgt, ev, text, sizeof(text))) {
+        text_len = json_utf8_cut(text, sizeof(text) - 1);  // Truncated
+        json_print_field(tgt, "message", text, text_len);
+    }
+
+    json_print_kv(tgt, ev);
+
+    print_to_target_text(tgt, "}", 1);
+    new_line ? print_to_target_text(tgt, "\n", 1) : (void)0;
+}
+
+#else  // ULOG_HAS_EXTRA_OUTPUTS
+
+// Disabled Private
+// ================
+
+#define json_render_event(tgt, ev, new_line)                                   \
+    ((void)(tgt), (void)(ev), (void)(new_line))
+
+#endif  // ULOG_HAS_EXTRA_OUTPUTS
+
 /* ============================================================================
    Core Feature: Log
    (`log_*`, depends on: Print, Level, Outputs, Extra Outputs, Prefix, Topics,
@@ -1672,6 +3799,45 @@ ulog_status ulog_source_location_config(bool enabled) {
 
 // Private
 // ================
+
+#if ULOG_HAS_ASYNC
+static void async_push(ulog_level level, const char *file, int line,
+                       int topic_id, ulog_output_id output, const ulog_kv *kv,
+                       size_t kv_count, const char *message, va_list args);
+
+// Without a topic the event is filtered by the lock-free level floor alone
+#define async_is_lock_free(topic) is_str_empty(topic)
+
+// Queueing does not need the lock and may wait for the writer, which takes it
+#define LOG_DISPATCH_IS_LOCK_FREE true
+#else
+#define async_is_lock_free(topic) ((void)(topic), false)
+#define LOG_DISPATCH_IS_LOCK_FREE false
+#endif  // ULOG_HAS_ASYNC
+
+/// @brief Prints the message text alone, without the location and fields
+/// @param tgt - Target
+/// @param ev - Event
+static void log_print_text(print_target *tgt, ulog_event *ev) {
+#if ULOG_HAS_CAPTURE
+    if (ev->capture != NULL) {
+        capture_print(tgt, ev->capture);  // Deferred formatting
+        return;
+    }
+#endif  // ULOG_HAS_CAPTURE
+
+    if (ev->message == log_text_format) {
+        const char *text = va_arg(ev->message_format_args, const char *);
+        size_t len       = va_arg(ev->message_format_args, size_t);
+        print_to_target_text(tgt, text, len);  // message, as is
+    } else if (!is_str_empty(ev->message)) {
+        print_to_target_valist(tgt, ev->message,
+                               ev->message_format_args);  // message
+    } else {
+        print_to_target(tgt, "NULL");  // message
+    }
+}
+
 /// @brief Prints the message
 /// @param tgt - Target
 /// @param ev - Event
@@ -1683,12 +3849,8 @@ static void log_print_message(print_target *tgt, ulog_event *ev) {
     }
 #endif  // ULOG_HAS_SOURCE_LOCATION
 
-    if (!is_str_empty(ev->message)) {
-        print_to_target_valist(tgt, ev->message,
-                               ev->message_format_args);  // message
-    } else {
-        print_to_target(tgt, "NULL");  // message
-    }
+    log_print_text(tgt, ev);
+    kv_print(tgt, ev);  // key-value fields
 }
 
 /// @brief Writes a formatted message
@@ -1705,8 +3867,8 @@ static void log_print_message(print_target *tgt, ulog_event *ev) {
 /// @param full_time - Full time or short time
 /// @param color - Color or no color
 /// @param new_line - New line in the end or no new line
-static void log_print_event(print_target *tgt, ulog_event *ev, bool full_time,
-                            bool color, bool new_line) {
+static void log_render_event(print_target *tgt, ulog_event *ev, bool full_time,
+                             bool color, bool new_line) {
 
     color ? color_print_start(tgt, ev) : (void)0;
 
@@ -1730,95 +3892,1839 @@ static void log_print_event(print_target *tgt, ulog_event *ev, bool full_time,
     new_line ? print_to_target(tgt, "\n") : (void)0;
 }
 
-void log_fill_event(ulog_event *ev, const char *message, ulog_level level,
-                    const char *file, int line, int topic_id) {
-    if (ev == NULL) {
-        return;  // Invalid event, do nothing
-    }
-
-    ev->message = message;
-    ev->level   = level;
-
-#if ULOG_HAS_SOURCE_LOCATION
-    ev->file = file;
-    ev->line = line;
-#else
-    (void)(file), (void)(line);  // Unused if file string is disabled
-#endif  // ULOG_HAS_SOURCE_LOCATION
-
-#if ULOG_HAS_TOPICS
-    ev->topic = topic_id;
-#else
-    (void)(topic_id);  // Unused if topics are disabled
-#endif
+#define EVENT_STYLE_USED 0x1u
+#define EVENT_STYLE_FULL_TIME 0x2u
+#define EVENT_STYLE_COLOR 0x4u
+#define EVENT_STYLE_NEW_LINE 0x8u
+#define EVENT_STYLE_JSON 0x10u  // JSON object instead of the text line
 
-#if ULOG_HAS_TIME
-    ev->time = NULL;  // Time will be filled later
-#endif
+#define LOG_LINE_BUF_SIZE 256  // Text line of a stream, written at once
 
-    time_fill_current_time(ev);  // Fill time with current value
+/// @brief Writes the event in the style
+/// @param tgt - Target
+/// @param ev - Event
+/// @param style - EVENT_STYLE_* bits
+static void log_render_styled(print_target *tgt, ulog_event *ev,
+                              unsigned int style) {
+    if ((style & EVENT_STYLE_JSON) != 0) {
+        json_render_event(tgt, ev, (style & EVENT_STYLE_NEW_LINE) != 0);
+        return;
+    }
+    log_render_event(tgt, ev, (style & EVENT_STYLE_FULL_TIME) != 0,
+                     (style & EVENT_STYLE_COLOR) != 0,
+                     (style & EVENT_STYLE_NEW_LINE) != 0);
 }
 
-// Public
-// ================
-
-ulog_status ulog_event_to_cstr(ulog_event *ev, char *out, size_t out_size) {
-    if (ev == NULL || out == NULL || out_size == 0) {
-        return ULOG_STATUS_INVALID_ARGUMENT;
-    }
+/// @brief Renders the event line into the buffer
+/// @param data - Buffer
+/// @param size - Buffer size
+/// @param ev - Event, its va_list is not consumed
+/// @param style - EVENT_STYLE_* bits
+/// @return Line length, `size` or more if the line did not fit
+static size_t log_render_buffer(char *data, size_t size, ulog_event *ev,
+                                unsigned int style) {
     print_target tgt = {.type       = PRINT_TARGET_BUFFER,
-                        .dsc.buffer = {out, 0, out_size}};
+                        .dsc.buffer = {data, 0, size}};
 
-    // Create a copy of the event to avoid va_list issues.
-    // memcpy cost is negligible (~4-10 word moves); vsnprintf below dominates.
+    // Render from a copy, the caller may need the va_list if it does not fit
     ulog_event ev_copy;
     memcpy(&ev_copy, ev, sizeof(ulog_event));
     va_copy(ev_copy.message_format_args, ev->message_format_args);
-
-    log_print_event(&tgt, &ev_copy, false, false, false);
-
+    log_render_styled(&tgt, &ev_copy, style);
     va_end(ev_copy.message_format_args);
-    return ULOG_STATUS_OK;
+    return tgt.dsc.buffer.curr_pos;
 }
 
-void ulog_log(ulog_level level, const char *file, int line, const char *topic,
-              const char *message, ...) {
-    if (lock_lock() != ULOG_STATUS_OK) {
-        return;  // Failed to acquire lock, drop log
+#if ULOG_HAS_RENDER_CACHE
+
+/// @brief Renders the event line into the entry buffer
+/// @param entry - Entry to fill
+/// @param ev - Event, its va_list is not consumed
+/// @param style - EVENT_STYLE_* bits
+static void log_render_line(event_render *entry, ulog_event *ev,
+                            unsigned int style) {
+    entry->style = style;
+    entry->len = log_render_buffer(entry->data, sizeof(entry->data), ev, style);
+    entry->complete = entry->len < sizeof(entry->data);
+}
+
+/// @brief Finds the line rendered in the style, rendering it on first use
+/// @return The line, possibly incomplete, or NULL if the event has no cache or
+/// the cache is full
+static event_render *log_render_get(ulog_event *ev, unsigned int style) {
+    if (ev->render == NULL) {
+        return NULL;
     }
 
-    // Try to get topic ID, outputs and check if logging is allowed for this
-    // topic
-    ulog_output_id output = ULOG_OUTPUT_ALL;
-    int topic_id          = -1;
-    if (!is_str_empty(topic)) {
-        bool is_log_allowed = false;
-        topic_process(topic, level, &is_log_allowed, &topic_id, &output);
-        if (!is_log_allowed) {
-            (void)lock_unlock();
-            return;  // Topic is not enabled or level is lower than topic level
+    event_render *entry = NULL;
+    for (int i = 0; i < EVENT_RENDER_CACHE_NUM && entry == NULL; i++) {
+        event_render *e = &ev->render->entries[i];
+        if (e->style == style || e->style == 0) {
+            entry = e;
+        }
+    }
+    if (entry == NULL) {
+        return NULL;  // All entries hold other styles
+    }
+
+    if (entry->style == 0) {
+        log_render_line(entry, ev, style);
+    }
+    return entry;
+}
+
+#endif  // ULOG_HAS_RENDER_CACHE
+
+/// @brief Prints the event. With the cache the line already rendered in the
+/// same style for another output of this event is reused. Streams get the
+/// line with a single write, from the cache or from a buffer of their own;
+/// lines of LOG_LINE_BUF_SIZE or more are printed piece by piece.
+/// @param tgt - Target
+/// @param ev - Event
+/// @param style - EVENT_STYLE_* bits, EVENT_STYLE_USED included
+static void log_print_styled(print_target *tgt, ulog_event *ev,
+                             unsigned int style) {
+    time_capture_printed(ev);  // Before the line is rendered from a copy
+#if ULOG_HAS_RENDER_CACHE
+    event_render *cached = log_render_get(ev, style);
+    if (cached != NULL && cached->complete) {
+        if (tgt->type == PRINT_TARGET_STREAM) {
+            fwrite(cached->data, 1, cached->len, tgt->dsc.stream);
+        } else {
+            print_to_target_text(tgt, cached->data, cached->len);
+        }
+        return;
+    }
+    if (cached != NULL && EVENT_RENDER_BUF_SIZE >= LOG_LINE_BUF_SIZE) {
+        log_render_styled(tgt, ev, style);  // Does not fit the buffer either
+        return;
+    }
+#endif
+    if (tgt->type == PRINT_TARGET_STREAM) {
+        char line[LOG_LINE_BUF_SIZE];
+        size_t len = log_render_buffer(line, sizeof(line), ev, style);
+        if (len < sizeof(line)) {
+            fwrite(line, 1, len, tgt->dsc.stream);
+            return;
+        }
+    }
+    log_render_styled(tgt, ev, style);
+}
+
+/// @brief Prints the event as a text line, see log_print_styled()
+/// @param tgt - Target
+/// @param ev - Event
+/// @param full_time - Full time or short time
+/// @param color - Color or no color
+/// @param new_line - New line in the end or no new line
+static void log_print_event(print_target *tgt, ulog_event *ev, bool full_time,
+                            bool color, bool new_line) {
+    log_print_styled(tgt, ev,
+                     EVENT_STYLE_USED |
+                         (full_time ? EVENT_STYLE_FULL_TIME : 0u) |
+                         (color ? EVENT_STYLE_COLOR : 0u) |
+                         (new_line ? EVENT_STYLE_NEW_LINE : 0u));
+}
+
+#if ULOG_HAS_EXTRA_OUTPUTS
+/// @brief Prints the event as a JSON line. JSON lines rarely fit the shared
+/// cache, streams get them from a buffer of their own with a single write.
+static void log_print_json(print_target *tgt, ulog_event *ev) {
+    unsigned int style =
+        EVENT_STYLE_USED | EVENT_STYLE_JSON | EVENT_STYLE_NEW_LINE;
+    time_capture_printed(ev);
+    if (tgt->type == PRINT_TARGET_STREAM) {
+        char line[JSON_LINE_BUF_SIZE];
+        size_t len = log_render_buffer(line, sizeof(line), ev, style);
+        if (len < sizeof(line)) {
+            fwrite(line, 1, len, tgt->dsc.stream);
+            return;
+        }
+    }
+    log_render_styled(tgt, ev, style);
+}
+#endif  // ULOG_HAS_EXTRA_OUTPUTS
+
+void log_fill_event(ulog_event *ev, const char *message, ulog_level level,
+                    const char *file, int line, int topic_id) {
+    if (ev == NULL) {
+        return;  // Invalid event, do nothing
+    }
+
+    ev->message = message;
+    ev->level   = level;
+
+#if ULOG_HAS_SOURCE_LOCATION
+    ev->file = file;
+    ev->line = line;
+#else
+    (void)(file), (void)(line);  // Unused if file string is disabled
+#endif  // ULOG_HAS_SOURCE_LOCATION
+
+#if ULOG_HAS_TOPICS
+    ev->topic = topic_id;
+#else
+    (void)(topic_id);  // Unused if topics are disabled
+#endif
+
+#if ULOG_HAS_TIME
+    ev->time_read = false;  // Read on first use, see time_capture()
+#endif
+}
+
+/// @brief Checks topic and output filters for the event. Call with the lock
+/// held.
+/// @param level - Log level
+/// @param topic - Topic name or NULL
+/// @param topic_id - (Output) topic ID
+/// @param output - (Output) output ID the event is routed to
+/// @return true if at least one output would handle the event
+static bool log_is_enabled(ulog_level level, const char *topic, int *topic_id,
+                           ulog_output_id *output) {
+    *topic_id = -1;
+    *output   = ULOG_OUTPUT_ALL;
+    if (!is_str_empty(topic)) {
+        bool is_log_allowed = false;
+        topic_process(topic, level, &is_log_allowed, topic_id, output);
+        if (!is_log_allowed) {
+            return false;  // Topic is not enabled or level is lower
+        }
+    }
+    return output_accepts(level, *output);
+}
+
+/// @brief Checks topic and output filters for the event with a known topic
+/// ID. Call with the lock held.
+/// @param level - Log level
+/// @param topic_id - Topic ID
+/// @param output - (Output) output ID the event is routed to
+/// @return true if at least one output would handle the event
+static bool log_topic_id_is_enabled(ulog_level level, ulog_topic_id topic_id,
+                                    ulog_output_id *output) {
+    bool is_log_allowed = false;
+    *output             = ULOG_OUTPUT_ALL;
+    topic_process_id(topic_id, level, &is_log_allowed, output);
+    if (!is_log_allowed) {
+        return false;  // Topic is not enabled or level is lower
+    }
+    return output_accepts(level, *output);
+}
+
+/// @brief Passes a filled event to the outputs. Call with the lock held.
+/// @param ev - Event
+/// @param output - Output ID or ULOG_OUTPUT_ALL
+static void log_output_event(ulog_event *ev, ulog_output_id output) {
+    prefix_update(ev);
+
+#if ULOG_HAS_RENDER_CACHE
+    // Outputs sharing a style get the same rendered line
+    event_render_cache render;
+    for (int i = 0; i < EVENT_RENDER_CACHE_NUM; i++) {
+        render.entries[i].style = 0;  // Lines are rendered on first use
+    }
+    ev->render = &render;
+#endif
+
+    // Handle output routing
+    if (output == ULOG_OUTPUT_ALL) {
+        output_handle_all(ev);
+    } else {
+        output_handle_by_id(ev, output);
+    }
+
+#if ULOG_HAS_RENDER_CACHE
+    ev->render = NULL;  // The cache goes out of scope
+#endif
+}
+
+/// @brief Builds the event and passes it to the outputs, or queues it in
+/// async mode. Call with the lock held, unless LOG_DISPATCH_IS_LOCK_FREE.
+static void log_dispatch(ulog_level level, const char *file, int line,
+                         int topic_id, ulog_output_id output,
+                         const ulog_kv *kv, size_t kv_count,
+                         const char *message, va_list args) {
+#if ULOG_HAS_ASYNC
+    async_push(level, file, line, topic_id, output, kv, kv_count, message,
+               args);
+#else
+    ulog_event ev = {0};
+    va_copy(ev.message_format_args, args);
+    log_fill_event(&ev, message, level, file, line, topic_id);
+    kv_attach(&ev, kv, kv_count);
+    log_output_event(&ev, output);
+    va_end(ev.message_format_args);
+#endif  // ULOG_HAS_ASYNC
+}
+
+// Public
+// ================
+
+ulog_status ulog_event_to_cstr(ulog_event *ev, char *out, size_t out_size) {
+    if (ev == NULL || out == NULL || out_size == 0) {
+        return ULOG_STATUS_INVALID_ARGUMENT;
+    }
+    print_target tgt = {.type       = PRINT_TARGET_BUFFER,
+                        .dsc.buffer = {out, 0, out_size}};
+
+    time_capture_printed(ev);  // Same time for every call on this event
+
+    // Create a copy of the event to avoid va_list issues.
+    // memcpy cost is negligible (~4-10 word moves); vsnprintf below dominates.
+    ulog_event ev_copy;
+    memcpy(&ev_copy, ev, sizeof(ulog_event));
+    va_copy(ev_copy.message_format_args, ev->message_format_args);
+
+    log_print_event(&tgt, &ev_copy, false, false, false);
+
+    va_end(ev_copy.message_format_args);
+    return ULOG_STATUS_OK;
+}
+
+void ulog_log(ulog_level level, const char *file, int line, const char *topic,
+              const char *message, ...) {
+    if (!ULOG_LEVEL_IS_BUILT(level) || !output_level_floor_allows(level)) {
+        return;  // No output accepts this level, skip the lock entirely
+    }
+    bool locked = !async_is_lock_free(topic);
+    if (locked && lock_lock() != ULOG_STATUS_OK) {
+        return;  // Failed to acquire lock, drop log
+    }
+
+    // Try to get topic ID, outputs and check if logging is allowed for this
+    // topic
+    ulog_output_id output = ULOG_OUTPUT_ALL;
+    int topic_id          = -1;
+    bool enabled = log_is_enabled(level, topic, &topic_id, &output);
+    if (locked && LOG_DISPATCH_IS_LOCK_FREE) {
+        locked = false;
+        (void)lock_unlock();
+    }
+    if (enabled) {
+        va_list args;
+        va_start(args, message);
+        log_dispatch(level, file, line, topic_id, output, NULL, 0, message,
+                     args);
+        va_end(args);
+    }
+
+    if (locked) {
+        (void)lock_unlock();
+    }
+}
+
+void ulog_log_tid(ulog_level level, const char *file, int line,
+                  ulog_topic_id topic, const char *message, ...) {
+    if (!ULOG_LEVEL_IS_BUILT(level) || !output_level_floor_allows(level)) {
+        return;  // No output accepts this level, skip the lock entirely
+    }
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return;  // Failed to acquire lock, drop log
+    }
+
+    ulog_output_id output = ULOG_OUTPUT_ALL;
+    bool enabled          = log_topic_id_is_enabled(level, topic, &output);
+    if (LOG_DISPATCH_IS_LOCK_FREE) {
+        (void)lock_unlock();
+    }
+    if (enabled) {
+        va_list args;
+        va_start(args, message);
+        log_dispatch(level, file, line, topic, output, NULL, 0, message,
+                     args);
+        va_end(args);
+    }
+
+    if (!LOG_DISPATCH_IS_LOCK_FREE) {
+        (void)lock_unlock();
+    }
+}
+
+/* ============================================================================
+   Optional Feature: Binary Output
+   (`binary_*`, depends on: Capture, Events, Levels, Time, Prefix, Topics,
+                            Key-Value Fields, Source Location, Extra Outputs,
+                            Log)
+============================================================================ */
+#if ULOG_HAS_BINARY
+
+#if !ULOG_HAS_EXTRA_OUTPUTS
+#error "ULOG_BUILD_BINARY_OUTPUT requires ULOG_BUILD_EXTRA_OUTPUTS > 0"
+#endif
+
+// Private
+// ================
+
+// A binary log is a header followed by records. Integers are LEB128 varints,
+// signed ones zigzag-encoded first.
+//
+// Header: "ULOGBIN", version, sizes of the argument types, 0x01020304 in the
+//         native byte order, time precision
+// Clock:  'C' utc_offset - UTC offset of the local time in seconds
+// Event:  'E' flags level str(level name)
+//         [time - time of the previous event of the file, ns] [str(prefix)]
+//         [str(topic)] [str(file) line] str(format) args_len args
+//         [count {str(key) type value}...]
+//
+// `str` starts with a tag: 0 - inline string (length, bytes), 1 - new
+// dictionary string (length, bytes) that takes the next id, from 2, or the
+// id of a string already in the dictionary. Strings are looked up by a hash
+// of their content and compared with a copy kept in the dictionary, so formats
+// in reused buffers are still told apart. Once the dictionary or its text is
+// full, new strings are inline.
+//
+// `args` are the argument values of a Capture record, in native types: a
+// log is decoded where the type sizes and byte order are the same. Messages
+// that cannot be captured (too long or unsupported conversions) and plain
+// text messages are written as "%s" with the text.
+
+#define BINARY_VERSION 1
+#define BINARY_OUTPUT_NUM 2  // Binary outputs at a time
+#define BINARY_DICT_SIZE ((size_t)ULOG_BUILD_BINARY_OUTPUT)  // Strings / file
+#define BINARY_DICT_SLOTS (2 * BINARY_DICT_SIZE)  // Hash table, half full
+#define BINARY_DICT_TEXT_SIZE (32 * BINARY_DICT_SIZE)  // Copies of strings
+#define BINARY_DICT_FIRST_ID 2
+#define BINARY_STR_INLINE 0
+#define BINARY_STR_NEW 1
+#define BINARY_RECORD_CLOCK 'C'
+#define BINARY_RECORD_EVENT 'E'
+#define BINARY_WRITE_BUF_SIZE 256  // Larger events are written in parts
+#define BINARY_RECORD_BUF_SIZE 512  // Larger messages are formatted
+#define BINARY_NS_PER_SEC 1000000000LL
+
+#define BINARY_EVENT_TIME 0x01u
+#define BINARY_EVENT_TIME_SPACE 0x02u    // Space after the time
+#define BINARY_EVENT_TIME_INVALID 0x04u  // Time printed as INVALID_TIME
+#define BINARY_EVENT_PREFIX 0x08u
+#define BINARY_EVENT_TOPIC 0x10u
+#define BINARY_EVENT_LOCATION 0x20u
+#define BINARY_EVENT_KV 0x40u
+
+#ifdef ULOG_BUILD_TIME_PRECISION
+#define BINARY_TIME_PRECISION ULOG_BUILD_TIME_PRECISION
+#else
+#define BINARY_TIME_PRECISION 0
+#endif
+
+#define BINARY_HEADER_CHECK_LEN 21  // Magic, version, sizes and byte order
+#define BINARY_HEADER_LEN (BINARY_HEADER_CHECK_LEN + 1)
+
+/// @brief State of one binary output
+typedef struct {
+    FILE *file;
+    bool reserved;        // Being added, not registered as an output yet
+    bool clock_written;   // utc_offset was written
+    long utc_offset;      // Last written UTC offset
+    long long last_ns;    // Time of the previous event with time
+    size_t dict_count;    // Strings in the dictionary
+    size_t dict_text_len; // Used part of dict_text
+    unsigned long long dict_hash[BINARY_DICT_SLOTS];  // 0 - free slot
+    unsigned int dict_id[BINARY_DICT_SLOTS];
+    unsigned int dict_offset[BINARY_DICT_SLOTS];  // Copy in dict_text
+    unsigned int dict_len[BINARY_DICT_SLOTS];
+    char dict_text[BINARY_DICT_TEXT_SIZE];
+} binary_output;
+
+static binary_output binary_outputs[BINARY_OUTPUT_NUM];
+
+/// @brief Buffers an event, so it is usually written with a single fwrite
+typedef struct {
+    FILE *file;
+    size_t len;
+    unsigned char data[BINARY_WRITE_BUF_SIZE];
+} binary_writer;
+
+/// @brief Fills the header of this build
+static void binary_header(unsigned char header[BINARY_HEADER_LEN]) {
+    static const char magic[] = "ULOGBIN";
+    const unsigned char sizes[] = {
+        sizeof(int),       sizeof(long),    sizeof(long long),
+        sizeof(intmax_t),  sizeof(size_t),  sizeof(ptrdiff_t),
+        sizeof(double),    sizeof(long double),
+        sizeof(void *)};
+    const uint32_t byte_order = 0x01020304u;
+
+    unsigned char *p = header;
+    memcpy(p, magic, sizeof(magic) - 1);
+    p += sizeof(magic) - 1;
+    *p++ = BINARY_VERSION;
+    memcpy(p, sizes, sizeof(sizes));
+    p += sizeof(sizes);
+    memcpy(p, &byte_order, sizeof(byte_order));
+    p += sizeof(byte_order);
+    *p = BINARY_TIME_PRECISION;  // At BINARY_HEADER_CHECK_LEN
+}
+
+/// @brief FNV-1a hash of the string, never 0
+static unsigned long long binary_hash(const char *str, size_t len) {
+    unsigned long long hash = 14695981039346656037ull;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 1099511628211ull;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+// === Writing =================================================================
+
+static void binary_flush(binary_writer *w) {
+    if (w->len > 0) {
+        fwrite(w->data, 1, w->len, w->file);
+        w->len = 0;
+    }
+}
+
+static void binary_put(binary_writer *w, const void *data, size_t len) {
+    if (len > sizeof(w->data) - w->len) {
+        binary_flush(w);
+        if (len > sizeof(w->data)) {
+            fwrite(data, 1, len, w->file);
+            return;
+        }
+    }
+    memcpy(w->data + w->len, data, len);
+    w->len += len;
+}
+
+static void binary_put_byte(binary_writer *w, unsigned char value) {
+    binary_put(w, &value, 1);
+}
+
+static void binary_put_varint(binary_writer *w, unsigned long long value) {
+    unsigned char buf[10];
+    size_t len = 0;
+    do {
+        buf[len] = (unsigned char)(value & 0x7f);
+        value >>= 7;
+        buf[len++] |= value != 0 ? 0x80 : 0;
+    } while (value != 0);
+    binary_put(w, buf, len);
+}
+
+static void binary_put_svarint(binary_writer *w, long long value) {
+    unsigned long long u = (unsigned long long)value;
+    binary_put_varint(w, value < 0 ? ~(u << 1) : u << 1);
+}
+
+/// @brief Writes an inline string
+static void binary_put_inline(binary_writer *w, const char *str, size_t len) {
+    binary_put_varint(w, BINARY_STR_INLINE);
+    binary_put_varint(w, len);
+    binary_put(w, str, len);
+}
+
+/// @brief Writes a string by its dictionary id, adding it on first use
+static void binary_put_str(binary_output *out, binary_writer *w,
+                           const char *str, size_t len) {
+    unsigned long long hash = binary_hash(str, len);
+    size_t slot             = (size_t)(hash % BINARY_DICT_SLOTS);
+    for (; out->dict_hash[slot] != 0; slot = (slot + 1) % BINARY_DICT_SLOTS) {
+        if (out->dict_hash[slot] == hash && out->dict_len[slot] == len &&
+            memcmp(out->dict_text + out->dict_offset[slot], str, len) == 0) {
+            binary_put_varint(w, out->dict_id[slot]);
+            return;
+        }
+    }
+    if (out->dict_count == BINARY_DICT_SIZE ||
+        len > BINARY_DICT_TEXT_SIZE - out->dict_text_len) {
+        binary_put_inline(w, str, len);  // Dictionary is full
+        return;
+    }
+
+    memcpy(out->dict_text + out->dict_text_len, str, len);
+    out->dict_hash[slot]   = hash;
+    out->dict_offset[slot] = (unsigned int)out->dict_text_len;
+    out->dict_len[slot]    = (unsigned int)len;
+    out->dict_id[slot] = (unsigned int)(BINARY_DICT_FIRST_ID + out->dict_count);
+    out->dict_count++;
+    out->dict_text_len += len;
+    binary_put_varint(w, BINARY_STR_NEW);
+    binary_put_varint(w, len);
+    binary_put(w, str, len);
+}
+
+/// @brief Writes the message format and argument values
+static void binary_put_message(binary_output *out, binary_writer *w,
+                               ulog_event *ev) {
+    if (ev->capture != NULL) {
+        size_t format_len = strlen(ev->capture);
+        size_t args_len   = capture_size(ev->capture, SIZE_MAX) - format_len - 1;
+        binary_put_str(out, w, ev->capture, format_len);
+        binary_put_varint(w, args_len);
+        binary_put(w, ev->capture + format_len + 1, args_len);
+        return;
+    }
+
+    char record[BINARY_RECORD_BUF_SIZE];
+    va_list args;
+    va_copy(args, ev->message_format_args);
+    if (ev->message == log_text_format) {
+        const char *text = va_arg(args, const char *);
+        size_t len       = va_arg(args, size_t);
+        binary_put_str(out, w, log_text_format, sizeof(log_text_format) - 1);
+        binary_put_varint(w, len + 1);
+        binary_put(w, text, len);
+        binary_put_byte(w, '\0');
+    } else if (is_str_empty(ev->message)) {
+        binary_put_str(out, w, "NULL", 4);  // As printed, without arguments
+        binary_put_varint(w, 0);
+    } else if (capture_args(record, sizeof(record), ev->message, args)) {
+        size_t format_len = strlen(record);
+        size_t args_len =
+            capture_size(record, sizeof(record)) - format_len - 1;
+        binary_put_str(out, w, record, format_len);
+        binary_put_varint(w, args_len);
+        binary_put(w, record + format_len + 1, args_len);
+    } else {
+        // Not captured: formatted straight into the file, as "%s" text
+        va_list len_args;
+        va_copy(len_args, args);
+        int len = vsnprintf(NULL, 0, ev->message, len_args);
+        va_end(len_args);
+        binary_put_str(out, w, log_text_format, sizeof(log_text_format) - 1);
+        binary_put_varint(w, len > 0 ? (size_t)len + 1 : 1);
+        binary_flush(w);
+        if (len > 0) {
+            vfprintf(w->file, ev->message, args);
+        }
+        binary_put_byte(w, '\0');
+    }
+    va_end(args);
+}
+
+#if ULOG_HAS_KV
+/// @brief Writes the key-value fields
+static void binary_put_kv(binary_output *out, binary_writer *w,
+                          ulog_event *ev) {
+    binary_put_varint(w, ev->kv_count);
+    for (size_t i = 0; i < ev->kv_count; i++) {
+        const ulog_kv *kv = &ev->kv[i];
+        const char *key   = kv->key != NULL ? kv->key : "NULL";
+        binary_put_str(out, w, key, strlen(key));
+        binary_put_byte(w, (unsigned char)kv->type);
+        switch (kv->type) {
+            case ULOG_KV_TYPE_INT:
+                binary_put_svarint(w, kv->value.i);
+                break;
+            case ULOG_KV_TYPE_UINT:
+                binary_put_varint(w, kv->value.u);
+                break;
+            case ULOG_KV_TYPE_DOUBLE:
+                binary_put(w, &kv->value.d, sizeof(kv->value.d));
+                break;
+            case ULOG_KV_TYPE_BOOL:
+                binary_put_byte(w, kv->value.b ? 1 : 0);
+                break;
+            case ULOG_KV_TYPE_STR: {
+                const char *str = kv->value.s != NULL ? kv->value.s : "NULL";
+                binary_put_inline(w, str, strlen(str));
+            } break;
+            default:
+                break;  // Printed as "?", no value
+        }
+    }
+}
+#endif  // ULOG_HAS_KV
+
+#if ULOG_HAS_TIME
+/// @brief Days since 1970-01-01 of a date in the proleptic Gregorian calendar
+static long long binary_days_from_civil(long long y, unsigned int m,
+                                        unsigned int d) {
+    y -= m <= 2;
+    long long era    = (y >= 0 ? y : y - 399) / 400;
+    unsigned int yoe = (unsigned int)(y - era * 400);
+    unsigned int doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    unsigned int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (long long)doe - 719468;
+}
+
+/// @brief Reads the event time and writes the clock record if the UTC offset
+/// has changed
+/// @return BINARY_EVENT_TIME* flags
+static unsigned int binary_put_clock(binary_output *out, binary_writer *w,
+                                     ulog_event *ev, long long *ns) {
+    if (!time_config_is_enabled()) {
+        return 0;
+    }
+    unsigned int flags = 0;
+#if ULOG_HAS_PREFIX
+    flags |= prefix_data.function == NULL ? BINARY_EVENT_TIME_SPACE : 0;
+#else
+    flags |= BINARY_EVENT_TIME_SPACE;
+#endif
+    long nsec = 0;
+    if (!time_resolve(ev, &nsec)) {
+        return BINARY_EVENT_TIME_INVALID;
+    }
+    *ns = (long long)time_data.sec * TIME_NS_PER_SEC + nsec;
+
+    const struct tm *tm = &time_data.tm;
+    long long local     = binary_days_from_civil((long long)tm->tm_year + 1900,
+                                                 (unsigned int)tm->tm_mon + 1,
+                                                 (unsigned int)tm->tm_mday) *
+                          86400LL +
+                      tm->tm_hour * 3600LL + tm->tm_min * 60LL + tm->tm_sec;
+    long offset = (long)(local - (long long)time_data.sec);
+    if (!out->clock_written || offset != out->utc_offset) {
+        binary_put_byte(w, BINARY_RECORD_CLOCK);
+        binary_put_svarint(w, offset);
+        out->clock_written = true;
+        out->utc_offset    = offset;
+    }
+    return flags | BINARY_EVENT_TIME;
+}
+#else
+#define binary_put_clock(out, w, ev, ns)                                       \
+    ((void)(out), (void)(w), (void)(ev), (void)(ns), 0u)
+#endif  // ULOG_HAS_TIME
+
+static void binary_output_handler(ulog_event *ev, void *arg) {
+    binary_output *out = (binary_output *)arg;
+    binary_writer w;
+    w.file = out->file;
+    w.len  = 0;
+
+    long long ns       = 0;
+    unsigned int flags = binary_put_clock(out, &w, ev, &ns);
+#if ULOG_HAS_PREFIX
+    if (prefix_data.function != NULL && prefix_config_is_enabled()) {
+        flags |= BINARY_EVENT_PREFIX;
+    }
+#endif
+    const char *topic = topic_get_name(ev);
+    flags |= topic != NULL ? BINARY_EVENT_TOPIC : 0;
+#if ULOG_HAS_SOURCE_LOCATION
+    if (src_loc_config_is_enabled() && ev->file != NULL) {
+        flags |= BINARY_EVENT_LOCATION;
+    }
+#endif
+#if ULOG_HAS_KV
+    flags |= ev->kv_count > 0 ? BINARY_EVENT_KV : 0;
+#endif
+
+    const char *level = level_data.dsc->names[ev->level];
+    binary_put_byte(&w, BINARY_RECORD_EVENT);
+    binary_put_byte(&w, (unsigned char)flags);
+    binary_put_byte(&w, (unsigned char)ev->level);
+    binary_put_str(out, &w, level, strlen(level));
+    if ((flags & BINARY_EVENT_TIME) != 0) {
+        binary_put_svarint(&w, ns - out->last_ns);
+        out->last_ns = ns;
+    }
+#if ULOG_HAS_PREFIX
+    if ((flags & BINARY_EVENT_PREFIX) != 0) {
+        binary_put_inline(&w, prefix_data.prefix, strlen(prefix_data.prefix));
+    }
+#endif
+    if (topic != NULL) {
+        binary_put_str(out, &w, topic, strlen(topic));
+    }
+#if ULOG_HAS_SOURCE_LOCATION
+    if ((flags & BINARY_EVENT_LOCATION) != 0) {
+        binary_put_str(out, &w, ev->file, strlen(ev->file));
+        binary_put_svarint(&w, ev->line);
+    }
+#endif
+    binary_put_message(out, &w, ev);
+#if ULOG_HAS_KV
+    if ((flags & BINARY_EVENT_KV) != 0) {
+        binary_put_kv(out, &w, ev);
+    }
+#endif
+    binary_flush(&w);
+}
+
+/// @brief Checks if the state is not used by an output. Call with the lock
+/// held.
+static bool binary_output_is_free(binary_output *out) {
+    if (out->reserved) {
+        return false;
+    }
+    for (int i = 0; i < OUTPUT_TOTAL_NUM; i++) {
+        if (output_data.outputs[i].handler == binary_output_handler &&
+            output_data.outputs[i].arg == out) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Public
+// ================
+
+ulog_output_id ulog_output_add_binary_file(FILE *file, ulog_level level) {
+    if (file == NULL) {
+        return ULOG_OUTPUT_INVALID;
+    }
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return ULOG_OUTPUT_INVALID;
+    }
+    binary_output *out = NULL;
+    for (int i = 0; i < BINARY_OUTPUT_NUM && out == NULL; i++) {
+        if (binary_output_is_free(&binary_outputs[i])) {
+            out = &binary_outputs[i];
+        }
+    }
+    if (out != NULL) {
+        memset(out, 0, sizeof(*out));
+        out->file     = file;
+        out->reserved = true;
+
+        unsigned char header[BINARY_HEADER_LEN];
+        binary_header(header);
+        fwrite(header, 1, sizeof(header), file);
+    }
+    (void)lock_unlock();
+    if (out == NULL) {
+        return ULOG_OUTPUT_INVALID;  // All binary outputs are in use
+    }
+
+    ulog_output_id output = ulog_output_add(binary_output_handler, out, level);
+    if (lock_lock() == ULOG_STATUS_OK) {
+        out->reserved = false;  // Registered or free again
+        (void)lock_unlock();
+    }
+    return output;
+}
+
+#else  // ULOG_HAS_BINARY
+
+// Disabled Public
+// ================
+
+#if ULOG_HAS_WARN_NOT_ENABLED
+
+ulog_output_id ulog_output_add_binary_file(FILE *file, ulog_level level) {
+    (void)(file);
+    (void)(level);
+    warn_not_enabled("ULOG_BUILD_BINARY_OUTPUT");
+    return ULOG_OUTPUT_INVALID;
+}
+
+#endif  // ULOG_HAS_WARN_NOT_ENABLED
+
+#endif  // ULOG_HAS_BINARY
+
+/* ============================================================================
+   Optional Feature: Async
+   (`async_*`, depends on: Atomics, Capture, Lock, Log, Time)
+============================================================================ */
+#if ULOG_HAS_ASYNC
+
+#include <time.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif (defined(__unix__) || defined(__APPLE__)) && !defined(__STRICT_ANSI__)
+#include <sched.h>
+#endif
+
+// Private
+// ================
+
+#ifndef ULOG_BUILD_ASYNC_MESSAGE_SIZE
+#define ULOG_BUILD_ASYNC_MESSAGE_SIZE 128
+#endif
+
+#if (ULOG_BUILD_ASYNC & (ULOG_BUILD_ASYNC - 1)) != 0
+#error "ULOG_BUILD_ASYNC must be a power of two"
+#endif
+
+#define ASYNC_SLOTS_NUM ((size_t)ULOG_BUILD_ASYNC)
+#define ASYNC_SLOTS_MASK (ASYNC_SLOTS_NUM - 1)
+#define ASYNC_DROP_REPORT_LEVEL ULOG_LEVEL_WARN
+
+// Bounded multi-producer ring (D. Vyukov). Producers claim a position with a
+// CAS on `head`, capture the message into the slot and publish it through the
+// slot's `lap`. Published slots are claimed with a CAS on `tail`, either by
+// the single consumer (`ulog_async_flush`), which passes them to the outputs
+// under the lock, or by a producer dropping the oldest event. The owner hands
+// the slot back to the producers.
+//
+// `lap` stores the slot sequence minus the slot index, so a zeroed (static)
+// ring is ready to use:
+//   lap == pos - index      - free for the producer of `pos`
+//   lap == pos - index + 1  - published, ready to be claimed from `tail`
+typedef struct {
+    atomics_size lap;
+    ulog_level level;
+    const char *file;
+    int line;
+    int topic_id;
+    ulog_output_id output;
+#if ULOG_HAS_TIME
+    long long time_stamp;
+#endif
+    bool captured;  // `message` holds a capture record, not formatted text
+    char message[ULOG_BUILD_ASYNC_MESSAGE_SIZE];
+#if ULOG_HAS_KV
+    size_t kv_count;
+    ulog_kv kv[KV_FIELDS_MAX];
+    char kv_text[ULOG_BUILD_ASYNC_MESSAGE_SIZE];  // Copied keys and strings
+#endif
+} async_slot;
+
+typedef struct {
+    async_slot slots[ASYNC_SLOTS_NUM];
+    atomics_size head;  // Next position to claim, producers
+    atomics_size tail;  // Next position to flush or drop
+    atomics_size dropped[ULOG_LEVEL_TOTAL];  // Dropped events per level
+    size_t dropped_reported;  // Dropped events already reported, consumer
+    atomics_int policy;       // ulog_async_policy
+    atomics_int timeout_ms;   // For ULOG_ASYNC_POLICY_BLOCK_TIMEOUT
+    atomics_int drop_report;  // Log the number of dropped events
+} async_data_t;
+
+static async_data_t async_data = {0};  // Policy: ULOG_ASYNC_POLICY_DROP_NEWEST
+
+/// @brief Returns the position of the slot in its lap, see `lap`
+static size_t async_base(size_t pos) {
+    return pos - (pos & ASYNC_SLOTS_MASK);
+}
+
+static size_t async_dropped_total(void) {
+    size_t total = 0;
+    for (int i = 0; i < ULOG_LEVEL_TOTAL; i++) {
+        total += atomics_load(&async_data.dropped[i]);
+    }
+    return total;
+}
+
+static void async_count_drop(ulog_level level) {
+    atomics_fetch_add(&async_data.dropped[level], 1);
+}
+
+/// @brief Claims the oldest published slot before `end`
+/// @param end - Position to stop at, e.g. the head at the start of a flush
+/// @return The slot position, the caller owns it until `async_release`
+static bool async_claim_oldest(size_t end, size_t *pos) {
+    size_t tail = atomics_load(&async_data.tail);
+    for (;;) {
+        if ((ptrdiff_t)(tail - end) >= 0) {
+            return false;  // Reached the end, later events wait for the next
+        }
+        async_slot *slot = &async_data.slots[tail & ASYNC_SLOTS_MASK];
+        if (atomics_load_acquire(&slot->lap) != async_base(tail) + 1) {
+            return false;  // Empty, or the oldest event is still being written
+        }
+        if (atomics_compare_exchange(&async_data.tail, &tail, tail + 1)) {
+            *pos = tail;
+            return true;
+        }
+    }
+}
+
+/// @brief Hands the claimed slot back to the producers
+static void async_release(size_t pos) {
+    async_slot *slot = &async_data.slots[pos & ASYNC_SLOTS_MASK];
+    atomics_store_release(&slot->lap, async_base(pos) + ASYNC_SLOTS_NUM);
+}
+
+/// @brief Drops the oldest event if it holds the slot the producer of `pos`
+/// waits for, and it is published and not claimed by the writer
+/// @return true if the slot was freed
+static bool async_drop_oldest(size_t pos) {
+    size_t tail      = pos - ASYNC_SLOTS_NUM;
+    async_slot *slot = &async_data.slots[tail & ASYNC_SLOTS_MASK];
+    if (atomics_load_acquire(&slot->lap) != async_base(tail) + 1 ||
+        !atomics_compare_exchange(&async_data.tail, &tail, tail + 1)) {
+        return false;  // Still being written, or flushed or dropped already
+    }
+    async_count_drop(slot->level);
+    async_release(tail);
+    return true;
+}
+
+/// @brief Monotonic-enough milliseconds for the blocking timeout
+static long long async_time_ms(void) {
+#ifdef TIME_UTC
+    struct timespec ts;
+    if (timespec_get(&ts, TIME_UTC) == TIME_UTC) {
+        return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    }
+#endif
+    return (long long)time(NULL) * 1000;
+}
+
+/// @brief Lets the writer run while a producer waits for a slot
+static void async_yield(void) {
+#if defined(_WIN32)
+    SwitchToThread();
+#elif (defined(__unix__) || defined(__APPLE__)) && !defined(__STRICT_ANSI__)
+    sched_yield();
+#endif
+}
+
+// Waiting producers spin this many times before they yield, and read the
+// clock for the timeout once per this many retries
+#define ASYNC_SPIN_LIMIT 64u
+#define ASYNC_CLOCK_INTERVAL 16u
+
+/// @brief State of a producer waiting on a full ring
+typedef struct {
+    long long deadline;  // Timeout deadline, 0 if not started
+    unsigned int spins;  // Retries so far
+    bool dropped;        // An old event was dropped for this one
+} async_wait;
+
+/// @brief Applies the overflow policy to a full ring
+/// @param pos - Position the producer waits for
+/// @param wait - (In/Out) wait state of the producer
+/// @return true to retry, false to drop the new event
+static bool async_on_full(size_t pos, async_wait *wait) {
+    switch ((ulog_async_policy)atomics_load(&async_data.policy)) {
+        case ULOG_ASYNC_POLICY_DROP_OLDEST:
+            // One old event at most, the new one is dropped if the oldest
+            // cannot be taken
+            if (wait->dropped || !async_drop_oldest(pos)) {
+                return false;
+            }
+            wait->dropped = true;
+            return true;
+        case ULOG_ASYNC_POLICY_BLOCK:
+            break;  // Wait until the writer frees a slot
+        case ULOG_ASYNC_POLICY_BLOCK_TIMEOUT:
+            if (wait->spins % ASYNC_CLOCK_INTERVAL == 0) {
+                long long now = async_time_ms();
+                if (wait->deadline == 0) {
+                    wait->deadline =
+                        now + atomics_load(&async_data.timeout_ms);
+                }
+                if (now >= wait->deadline) {
+                    return false;
+                }
+            }
+            break;
+        default:
+            return false;
+    }
+    if (++wait->spins > ASYNC_SPIN_LIMIT) {
+        async_yield();
+    }
+    return true;
+}
+
+#if ULOG_HAS_KV
+
+/// @brief Copies a key or string value into the text of the slot, truncated
+/// if the text is full
+/// @param used - (In/Out) bytes of the text in use
+static const char *async_kv_copy_str(async_slot *slot, size_t *used,
+                                     const char *str) {
+    if (str == NULL) {
+        return NULL;
+    }
+    size_t room = sizeof(slot->kv_text) - *used;
+    if (room == 0) {
+        return "";  // Text is full
+    }
+    char *copy = slot->kv_text + *used;
+    size_t len = strlen(str);
+    len        = len < room - 1 ? len : room - 1;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    *used += len + 1;
+    return copy;
+}
+
+/// @brief Copies the fields into the slot, they outlive the logging call
+static void async_kv_copy(async_slot *slot, const ulog_kv *kv,
+                          size_t kv_count) {
+    size_t used    = 0;
+    slot->kv_count = kv_count < KV_FIELDS_MAX ? kv_count : KV_FIELDS_MAX;
+    for (size_t i = 0; i < slot->kv_count; i++) {
+        slot->kv[i]     = kv[i];
+        slot->kv[i].key = async_kv_copy_str(slot, &used, kv[i].key);
+        if (kv[i].type == ULOG_KV_TYPE_STR) {
+            slot->kv[i].value.s = async_kv_copy_str(slot, &used, kv[i].value.s);
+        }
+    }
+}
+
+#else
+#define async_kv_copy(slot, kv, kv_count)                                      \
+    ((void)(slot), (void)(kv), (void)(kv_count))
+#endif  // ULOG_HAS_KV
+
+/// @brief Captures the event into a free slot and publishes it. Must be
+/// called without the lock, as the overflow policy may wait for the writer.
+static void async_push(ulog_level level, const char *file, int line,
+                       int topic_id, ulog_output_id output, const ulog_kv *kv,
+                       size_t kv_count, const char *message, va_list args) {
+    async_wait wait = {0};
+    size_t pos      = atomics_load(&async_data.head);
+    async_slot *slot;
+    for (;;) {
+        slot       = &async_data.slots[pos & ASYNC_SLOTS_MASK];
+        size_t lap = atomics_load_acquire(&slot->lap);
+        if (lap == async_base(pos)) {
+            if (atomics_compare_exchange(&async_data.head, &pos, pos + 1)) {
+                break;  // Slot claimed
+            }
+        } else if (lap < async_base(pos)) {
+            // Slot not flushed yet, the ring is full
+            if (!async_on_full(pos, &wait)) {
+                async_count_drop(level);
+                return;
+            }
+            pos = atomics_load(&async_data.head);
+        } else {
+            pos = atomics_load(&async_data.head);  // Taken by another producer
+        }
+    }
+
+    slot->level    = level;
+    slot->file     = file;
+    slot->line     = line;
+    slot->topic_id = topic_id;
+    slot->output   = output;
+#if ULOG_HAS_TIME
+    slot->time_stamp = time_read();  // The call time, the outputs run later
+#endif
+    async_kv_copy(slot, kv, kv_count);
+    slot->captured = false;
+    if (is_str_empty(message)) {
+        slot->message[0] = '\0';  // Printed as "NULL", same as sync mode
+    } else if (capture_args(slot->message, sizeof(slot->message), message,
+                            args)) {
+        slot->captured = true;  // Formatted by the writer thread
+    } else {
+        // Unsupported format or too long record: format here, truncated
+        va_list args_copy;
+        va_copy(args_copy, args);
+        vsnprintf(slot->message, sizeof(slot->message), message, args_copy);
+        va_end(args_copy);
+    }
+
+    atomics_store_release(&slot->lap, async_base(pos) + 1);
+}
+
+/// @brief Passes a queued event to the outputs. The formatted message is
+/// passed as the only argument of `format` ("%s"), a captured one is
+/// formatted by the outputs.
+static void async_output(async_slot *slot, const char *format, ...) {
+    ulog_event ev = {0};
+    va_start(ev.message_format_args, format);
+    log_fill_event(&ev, slot->message[0] == '\0' ? NULL : format, slot->level,
+                   slot->file, slot->line, slot->topic_id);
+    ev.capture = slot->captured ? slot->message : NULL;
+#if ULOG_HAS_KV
+    kv_attach(&ev, slot->kv, slot->kv_count);
+#endif
+#if ULOG_HAS_TIME
+    ev.time_stamp = slot->time_stamp;
+    ev.time_read  = true;
+#endif
+    log_output_event(&ev, slot->output);
+    va_end(ev.message_format_args);
+}
+
+/// @brief Passes a synthetic event to all outputs
+static void async_output_report(ulog_level level, const char *format, ...) {
+    ulog_event ev = {0};
+    va_start(ev.message_format_args, format);
+    log_fill_event(&ev, format, level, NULL, 0, -1);
+    log_output_event(&ev, ULOG_OUTPUT_ALL);
+    va_end(ev.message_format_args);
+}
+
+/// @brief Reports events dropped since the last report, once the queue has
+/// been drained. Call with the lock held.
+static void async_report_drops(void) {
+    size_t dropped = async_dropped_total();
+    if (dropped == async_data.dropped_reported) {
+        return;  // Nothing new
+    }
+    if (atomics_load(&async_data.drop_report) &&
+        output_level_floor_allows(ASYNC_DROP_REPORT_LEVEL)) {
+        async_output_report(ASYNC_DROP_REPORT_LEVEL,
+                            "ulog: %lu messages dropped",
+                            (unsigned long)(dropped -
+                                            async_data.dropped_reported));
+    }
+    async_data.dropped_reported = dropped;
+}
+
+/// @brief Flushes the published events queued before `end`. Events queued
+/// meanwhile are left to the next flush, so the lock is held for one ring at
+/// most. Call with the lock held.
+/// @param end - Head position at the start of the flush
+static void async_flush_locked(size_t end) {
+    size_t pos;
+    while (async_claim_oldest(end, &pos)) {
+        async_output(&async_data.slots[pos & ASYNC_SLOTS_MASK], "%s",
+                     async_data.slots[pos & ASYNC_SLOTS_MASK].message);
+        async_release(pos);
+    }
+    async_report_drops();
+}
+
+/// @brief Flushes queued events and resets the drop counters. Call with the
+/// lock held.
+static void async_cleanup(void) {
+    async_flush_locked(atomics_load(&async_data.head));
+    for (int i = 0; i < ULOG_LEVEL_TOTAL; i++) {
+        atomics_store(&async_data.dropped[i], 0);
+    }
+    async_data.dropped_reported = 0;
+    atomics_store(&async_data.policy, ULOG_ASYNC_POLICY_DROP_NEWEST);
+    atomics_store(&async_data.timeout_ms, 0);
+    atomics_store(&async_data.drop_report, false);
+}
+
+// Public
+// ================
+
+ulog_status ulog_async_flush(void) {
+    size_t end = atomics_load(&async_data.head);
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return ULOG_STATUS_BUSY;
+    }
+    async_flush_locked(end);
+    return lock_unlock();
+}
+
+size_t ulog_async_pending(void) {
+    size_t tail = atomics_load(&async_data.tail);
+    size_t head = atomics_load(&async_data.head);
+    return head - tail;  // Includes claimed slots not published yet
+}
+
+size_t ulog_async_dropped(void) {
+    return async_dropped_total();
+}
+
+size_t ulog_async_dropped_by_level(ulog_level level) {
+    if ((int)level < 0 || (int)level >= ULOG_LEVEL_TOTAL) {
+        return 0;
+    }
+    return atomics_load(&async_data.dropped[level]);
+}
+
+ulog_status ulog_async_policy_set(ulog_async_policy policy,
+                                  unsigned int timeout_ms) {
+    if ((int)policy < ULOG_ASYNC_POLICY_DROP_NEWEST ||
+        (int)policy > ULOG_ASYNC_POLICY_BLOCK_TIMEOUT ||
+        timeout_ms > INT32_MAX) {
+        return ULOG_STATUS_INVALID_ARGUMENT;
+    }
+    atomics_store(&async_data.timeout_ms, (int)timeout_ms);
+    atomics_store(&async_data.policy, (int)policy);
+    return ULOG_STATUS_OK;
+}
+
+ulog_status ulog_async_drop_report_set(bool enabled) {
+    atomics_store(&async_data.drop_report, enabled);
+    return ULOG_STATUS_OK;
+}
+
+#else  // ULOG_HAS_ASYNC
+
+// Disabled Private
+// ================
+
+#define async_cleanup() (void)(0)
+
+// Disabled Public
+// ================
+
+#if ULOG_HAS_WARN_NOT_ENABLED
+
+ulog_status ulog_async_flush(void) {
+    warn_not_enabled("ULOG_BUILD_ASYNC");
+    return ULOG_STATUS_DISABLED;
+}
+
+size_t ulog_async_pending(void) {
+    warn_not_enabled("ULOG_BUILD_ASYNC");
+    return 0;
+}
+
+size_t ulog_async_dropped(void) {
+    warn_not_enabled("ULOG_BUILD_ASYNC");
+    return 0;
+}
+
+size_t ulog_async_dropped_by_level(ulog_level level) {
+    (void)(level);
+    warn_not_enabled("ULOG_BUILD_ASYNC");
+    return 0;
+}
+
+ulog_status ulog_async_policy_set(ulog_async_policy policy,
+                                  unsigned int timeout_ms) {
+    (void)(policy);
+    (void)(timeout_ms);
+    warn_not_enabled("ULOG_BUILD_ASYNC");
+    return ULOG_STATUS_DISABLED;
+}
+
+ulog_status ulog_async_drop_report_set(bool enabled) {
+    (void)(enabled);
+    warn_not_enabled("ULOG_BUILD_ASYNC");
+    return ULOG_STATUS_DISABLED;
+}
+
+#endif  // ULOG_HAS_WARN_NOT_ENABLED
+
+#endif  // ULOG_HAS_ASYNC
+
+/* ============================================================================
+   Optional Feature: Signal Safe
+   (`signal_safe_*`, depends on: Atomics, Print, Level, Source Location)
+============================================================================ */
+#if ULOG_HAS_SIGNAL_SAFE
+
+#include <errno.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#define signal_safe_write(fd, data, len) _write((fd), (data), (unsigned)(len))
+#else
+#include <unistd.h>
+#define signal_safe_write(fd, data, len) write((fd), (data), (len))
+#endif
+
+// Private
+// ================
+
+#ifndef ULOG_BUILD_SIGNAL_SAFE_LINE_SIZE
+#define ULOG_BUILD_SIGNAL_SAFE_LINE_SIZE 256
+#endif
+
+#if ULOG_BUILD_SIGNAL_SAFE_LINE_SIZE < 16
+#error "ULOG_BUILD_SIGNAL_SAFE_LINE_SIZE must be at least 16"
+#endif
+
+#define SIGNAL_SAFE_FDS_NUM ((int)ULOG_BUILD_SIGNAL_SAFE)
+
+// Registered file descriptors. Changed under the lock, read by logging calls
+// without it: `fd` holds the descriptor plus one, 0 - free slot.
+typedef struct {
+    atomics_int fd;
+    atomics_int level;
+} signal_safe_fd;
+
+static signal_safe_fd signal_safe_fds[SIGNAL_SAFE_FDS_NUM];
+
+/// @brief Formats one spec without the C library
+/// @return false if the argument type is unknown
+static bool signal_safe_format_spec(print_sink *sink, const print_spec *spec,
+                                    va_list *args) {
+    bool plain = !spec->star_width && !spec->star_precision &&
+                 !spec->other_flags;
+    bool supported = false;
+    switch (plain ? spec->conversion : '\0') {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+            supported = spec->precision < 0 && !spec->short_int;
+            break;
+        case 'c':
+            supported = !spec->zero && spec->precision < 0;
+            break;
+        case 's':
+            supported = !spec->zero && spec->type == PRINT_ARG_STRING;
+            break;
+        case '%':
+            print_sink_put(sink, "%", 1);
+            return true;
+        case 'p':
+            if (!spec->zero && !spec->plus && !spec->space &&
+                spec->precision < 0) {
+                char buf[24];
+                char *end = buf + sizeof(buf);
+                void *ptr = va_arg(*args, void *);
+                char *first =
+                    print_format_hex(end, (unsigned long long)(uintptr_t)ptr,
+                                     false);
+                *--first = 'x';
+                *--first = '0';
+                print_format_padded(sink, spec, '\0', first,
+                                    (size_t)(end - first), false);
+                return true;
+            }
+            break;
+        case 'f':
+        case 'F':
+            if (spec->type == PRINT_ARG_DOUBLE) {
+                double value = va_arg(*args, double);
+                if (print_format_double(sink, spec, value, false)) {
+                    return true;
+                }
+                if (!isfinite(value)) {
+                    char sign = signbit(value) ? '-' : '\0';
+                    const char *text = isnan(value) ? "nan" : "inf";
+                    print_format_padded(sink, spec, sign, text, 3, false);
+                } else {
+                    print_sink_put(sink, spec->start, spec->len);
+                }
+                return true;
+            }
+            break;
+        default:
+            break;
+    }
+    if (supported) {
+        return print_format_spec(sink, spec, args);  // No libc for these
+    }
+
+    // Known argument type: skip the value and keep the spec as text
+    if (spec->type == PRINT_ARG_UNSUPPORTED) {
+        return false;
+    }
+    if (spec->star_width) {
+        (void)va_arg(*args, int);
+    }
+    if (spec->star_precision) {
+        (void)va_arg(*args, int);
+    }
+    switch (spec->type) {
+        case PRINT_ARG_DOUBLE:
+            (void)va_arg(*args, double);
+            break;
+        case PRINT_ARG_LDOUBLE:
+            (void)va_arg(*args, long double);
+            break;
+        case PRINT_ARG_STRING:
+        case PRINT_ARG_POINTER:
+            (void)va_arg(*args, void *);
+            break;
+        case PRINT_ARG_NONE:
+            break;
+        default:
+            (void)print_arg_unsigned(spec->type, args);
+            break;
+    }
+    print_sink_put(sink, spec->start, spec->len);
+    return true;
+}
+
+/// @brief Formats the message without the C library. After a conversion of
+/// unknown argument type the rest of the format is copied as it is.
+static void signal_safe_format(print_sink *sink, const char *format,
+                               va_list args) {
+    va_list args_copy;
+    va_copy(args_copy, args);
+    const char *p = format;
+    for (;;) {
+        const char *spec_start = strchr(p, '%');
+        if (spec_start == NULL) {
+            print_sink_put(sink, p, strlen(p));
+            break;
+        }
+        print_sink_put(sink, p, (size_t)(spec_start - p));
+
+        print_spec spec;
+        print_spec_parse(spec_start, &spec);
+        if (!signal_safe_format_spec(sink, &spec, &args_copy)) {
+            print_sink_put(sink, spec_start, strlen(spec_start));
+            break;
         }
+        p = spec_start + spec.len;
     }
+    va_end(args_copy);
+}
 
-    ulog_event ev = {0};
+/// @brief Writes the whole line, retrying interrupted writes
+static void signal_safe_write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        long written = (long)signal_safe_write(fd, data, len);
+#if !defined(_WIN32)
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (written <= 0) {
+            return;
+        }
+        data += written;
+        len -= (size_t)written;
+    }
+}
+
+/// @brief Renders the line: Level [Topic ][File:Line: ]Message
+/// @return Length of the line, with the new line and without the NUL
+static size_t signal_safe_render(char *line, size_t size, ulog_level level,
+                                 const char *file, int line_num,
+                                 const char *topic, const char *message,
+                                 va_list args) {
+    print_sink sink = {line, size, 0};
+    const char *name = level <= level_data.dsc->max_level
+                           ? level_data.dsc->names[level]
+                           : "?";
+    print_sink_put(&sink, name, strlen(name));
+    print_sink_put(&sink, " ", 1);
+    if (!is_str_empty(topic)) {
+        print_sink_put(&sink, "[", 1);
+        print_sink_put(&sink, topic, strlen(topic));
+        print_sink_put(&sink, "] ", 2);
+    }
+#if ULOG_HAS_SOURCE_LOCATION
+    if (file != NULL) {
+        char buf[24];
+        char *end   = buf + sizeof(buf);
+        char *first = print_format_decimal(
+            end, line_num > 0 ? (unsigned long long)line_num : 0);
+        print_sink_put(&sink, file, strlen(file));
+        print_sink_put(&sink, ":", 1);
+        print_sink_put(&sink, first, (size_t)(end - first));
+        print_sink_put(&sink, ": ", 2);
+    }
+#else
+    (void)file;
+    (void)line_num;
+#endif
+    if (!is_str_empty(message)) {
+        signal_safe_format(&sink, message, args);
+    } else {
+        print_sink_put(&sink, "NULL", 4);
+    }
+
+    // Keep the new line of truncated lines
+    size_t len = sink.len < size - 1 ? sink.len : size - 2;
+    line[len++] = '\n';
+    return len;
+}
+
+/// @brief Frees all descriptor slots. Locked.
+static void signal_safe_cleanup(void) {
+    for (int i = 0; i < SIGNAL_SAFE_FDS_NUM; i++) {
+        atomics_store(&signal_safe_fds[i].fd, 0);
+    }
+}
+
+/// @brief Writes the message to the registered descriptors, see
+/// `ulog_log_signal_safe`
+static void signal_safe_log(ulog_level level, const char *file, int line,
+                            const char *topic, const char *message,
+                            va_list args) {
+    if (level < LEVEL_MIN_VALUE || level >= ULOG_LEVEL_TOTAL) {
+        return;
+    }
+    bool wanted = false;
+    for (int i = 0; i < SIGNAL_SAFE_FDS_NUM; i++) {
+        wanted |= atomics_load(&signal_safe_fds[i].fd) != 0 &&
+                  (int)level >= atomics_load(&signal_safe_fds[i].level);
+    }
+    if (!wanted) {
+        return;  // Nothing is formatted for filtered messages
+    }
+
+    char text[ULOG_BUILD_SIGNAL_SAFE_LINE_SIZE];
+    size_t len = signal_safe_render(text, sizeof(text), level, file, line,
+                                    topic, message, args);
+
+    for (int i = 0; i < SIGNAL_SAFE_FDS_NUM; i++) {
+        int fd = atomics_load(&signal_safe_fds[i].fd) - 1;
+        if (fd >= 0 && (int)level >= atomics_load(&signal_safe_fds[i].level)) {
+            signal_safe_write_all(fd, text, len);
+        }
+    }
+}
+
+// Public
+// ================
+
+ulog_status ulog_signal_safe_fd_add(int fd, ulog_level level) {
+    if (fd < 0 || !level_is_valid(level)) {
+        return ULOG_STATUS_INVALID_ARGUMENT;
+    }
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return ULOG_STATUS_BUSY;
+    }
+    int free_slot = -1;
+    int slot      = -1;
+    for (int i = 0; i < SIGNAL_SAFE_FDS_NUM && slot < 0; i++) {
+        int stored = atomics_load(&signal_safe_fds[i].fd);
+        if (stored == fd + 1) {
+            slot = i;  // Registered, update the level
+        } else if (stored == 0 && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    slot = slot >= 0 ? slot : free_slot;
+    if (slot < 0) {
+        lock_unlock();
+        return ULOG_STATUS_ERROR;  // All slots are taken
+    }
+    atomics_store(&signal_safe_fds[slot].level, (int)level);
+    atomics_store(&signal_safe_fds[slot].fd, fd + 1);
+    return lock_unlock();
+}
+
+ulog_status ulog_signal_safe_fd_remove(int fd) {
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return ULOG_STATUS_BUSY;
+    }
+    ulog_status status = ULOG_STATUS_NOT_FOUND;
+    for (int i = 0; i < SIGNAL_SAFE_FDS_NUM && fd >= 0; i++) {
+        if (atomics_load(&signal_safe_fds[i].fd) == fd + 1) {
+            atomics_store(&signal_safe_fds[i].fd, 0);
+            status = ULOG_STATUS_OK;
+        }
+    }
+    ulog_status unlock_status = lock_unlock();
+    return status == ULOG_STATUS_OK ? unlock_status : status;
+}
+
+void ulog_log_signal_safe(ulog_level level, const char *file, int line,
+                          const char *topic, const char *message, ...) {
+    int saved_errno = errno;  // The interrupted code may be reading errno
     va_list args;
     va_start(args, message);
-    va_copy(ev.message_format_args, args);
+    signal_safe_log(level, file, line, topic, message, args);
     va_end(args);
-    log_fill_event(&ev, message, level, file, line, topic_id);
+    errno = saved_errno;
+}
 
-    prefix_update(&ev);
+#else  // ULOG_HAS_SIGNAL_SAFE
 
-    // Handle output routing
-    if (output == ULOG_OUTPUT_ALL) {
-        output_handle_all(&ev);
-    } else {
-        output_handle_by_id(&ev, output);
+// Disabled Private
+// ================
+
+#define signal_safe_cleanup() (void)(0)
+
+// Disabled Public
+// ================
+
+// Never warns: a warning would log through the unsafe path
+void ulog_log_signal_safe(ulog_level level, const char *file, int line,
+                          const char *topic, const char *message, ...) {
+    (void)(level);
+    (void)(file);
+    (void)(line);
+    (void)(topic);
+    (void)(message);
+}
+
+#if ULOG_HAS_WARN_NOT_ENABLED
+
+ulog_status ulog_signal_safe_fd_add(int fd, ulog_level level) {
+    (void)(fd);
+    (void)(level);
+    warn_not_enabled("ULOG_BUILD_SIGNAL_SAFE");
+    return ULOG_STATUS_DISABLED;
+}
+
+ulog_status ulog_signal_safe_fd_remove(int fd) {
+    (void)(fd);
+    warn_not_enabled("ULOG_BUILD_SIGNAL_SAFE");
+    return ULOG_STATUS_DISABLED;
+}
+
+#endif  // ULOG_HAS_WARN_NOT_ENABLED
+
+#endif  // ULOG_HAS_SIGNAL_SAFE
+
+/* ============================================================================
+   Core Feature: Callsite
+   (`callsite_*`, depends on: Generation, Lock, Log, Outputs, Topics)
+============================================================================ */
+
+// Private
+// ================
+
+// Layout of `ulog_callsite.state`. The whole decision is packed in one word so
+// the unlocked fast path reads it with a single load:
+// [generation:27][level:4][enabled:1]. Generation 0 is never current because
+// the valid bit below is folded into the level field.
+#define CALLSITE_ENABLED 0x1u
+#define CALLSITE_LEVEL_SHIFT 1
+#define CALLSITE_LEVEL_MASK 0xFu
+#define CALLSITE_GENERATION_SHIFT 5
+
+/// @brief Builds the callsite state for the current generation
+static unsigned int callsite_state_make(ulog_level level, bool enabled) {
+    // Level is stored +1 so a zeroed record never matches
+    unsigned int lvl = (((unsigned int)level + 1u) & CALLSITE_LEVEL_MASK);
+    return (generation_get() << CALLSITE_GENERATION_SHIFT) |
+           (lvl << CALLSITE_LEVEL_SHIFT) | (enabled ? CALLSITE_ENABLED : 0u);
+}
+
+/// @brief FNV-1a hash of the topic name, 0 for no topic
+static unsigned int callsite_topic_hash(const char *topic) {
+    if (topic == NULL) {
+        return 0u;
+    }
+    uint32_t hash = 2166136261u;
+    while (*topic != '\0') {
+        hash ^= (uint8_t)*topic++;
+        hash *= 16777619u;
+    }
+    return (unsigned int)hash;
+}
+
+/// @brief Decision read from a callsite cache
+typedef struct {
+    unsigned int state;
+    int topic;
+    ulog_output_id output;
+} callsite_entry;
+
+/// @brief Reads the cache if it is valid for this level and topic. The topic
+/// is matched by pointer and by a hash of its content, so a buffer reused for
+/// another name does not hit the old entry. Needs no lock: the fields are
+/// written under the lock between a cleared and a published state, and are
+/// used only if the state read before and after them is the same.
+/// @return false if the cache has to be resolved under the lock
+static bool callsite_read(ulog_callsite *cs, ulog_level level,
+                          const char *topic, callsite_entry *entry) {
+    unsigned int state = atomics_load_acquire(&cs->state);
+    if ((state & ~CALLSITE_ENABLED) != callsite_state_make(level, false)) {
+        return false;
     }
+    bool same_topic = (cs->topic_name == topic) &&
+                      (cs->topic_hash == callsite_topic_hash(topic));
+    entry->state    = state;
+    entry->topic    = cs->topic;
+    entry->output   = cs->output;
+    atomics_fence_acquire();
+    return same_topic && atomics_load(&cs->state) == state;
+}
 
-    va_end(ev.message_format_args);
+/// @brief Resolves topic and output for the callsite, refreshing the cache if
+/// the configuration has changed. Call with the lock held.
+/// @return true if the event would be handled by at least one output
+static bool callsite_resolve(ulog_callsite *cs, ulog_level level,
+                             const char *topic, int *topic_id,
+                             ulog_output_id *output) {
+    callsite_entry entry;
+    if (callsite_read(cs, level, topic, &entry)) {
+        *topic_id = entry.topic;
+        *output   = entry.output;
+        return (entry.state & CALLSITE_ENABLED) != 0;
+    }
+
+    bool enabled = log_is_enabled(level, topic, topic_id, output);
+    atomics_store(&cs->state, 0u);  // Readers skip the entry until published
+    atomics_fence_release();
+    cs->topic_name = topic;
+    cs->topic_hash = callsite_topic_hash(topic);
+    cs->topic      = *topic_id;
+    cs->output     = *output;
+    atomics_store_release(&cs->state, callsite_state_make(level, enabled));
+    return enabled;
+}
+
+/// @brief Filters the event through the callsite cache and dispatches it
+static void callsite_log(ulog_callsite *cs, ulog_level level, const char *file,
+                         int line, const char *topic, const ulog_kv *kv,
+                         size_t kv_count, const char *message, va_list args) {
+    if (cs == NULL) {
+        return;
+    }
+
+#if ULOG_HAS_ASYNC
+    // A current cache entry is enough to queue the event without the lock
+    callsite_entry entry;
+    if (callsite_read(cs, level, topic, &entry)) {
+        if ((entry.state & CALLSITE_ENABLED) != 0) {
+            log_dispatch(level, file, line, entry.topic, entry.output, kv,
+                         kv_count, message, args);
+        }
+        return;
+    }
+#endif  // ULOG_HAS_ASYNC
+
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return;  // Failed to acquire lock, drop log
+    }
+
+    int topic_id          = -1;
+    ulog_output_id output = ULOG_OUTPUT_ALL;
+    bool enabled = callsite_resolve(cs, level, topic, &topic_id, &output);
+    if (LOG_DISPATCH_IS_LOCK_FREE) {
+        (void)lock_unlock();
+    }
+    if (enabled) {
+        log_dispatch(level, file, line, topic_id, output, kv, kv_count,
+                     message, args);
+    }
+
+    if (!LOG_DISPATCH_IS_LOCK_FREE) {
+        (void)lock_unlock();
+    }
+}
+
+/// @brief `callsite_log` with the format arguments passed directly
+static void callsite_log_fields(ulog_callsite *cs, ulog_level level,
+                                const char *file, int line, const char *topic,
+                                const ulog_kv *kv, size_t kv_count,
+                                const char *message, ...) {
+    va_list args;
+    va_start(args, message);
+    callsite_log(cs, level, file, line, topic, kv, kv_count, message, args);
+    va_end(args);
+}
+
+// Public
+// ================
+
+bool ulog_callsite_is_enabled(ulog_callsite *cs, ulog_level level,
+                              const char *topic) {
+    if (cs == NULL) {
+        return false;
+    }
 
+    callsite_entry entry;
+    if (callsite_read(cs, level, topic, &entry)) {
+        return (entry.state & CALLSITE_ENABLED) != 0;  // Fast path, no lock
+    }
+
+    if (!ULOG_LEVEL_IS_BUILT(level) || !output_level_floor_allows(level)) {
+        return false;  // No output accepts this level
+    }
+    if (lock_lock() != ULOG_STATUS_OK) {
+        return false;  // Failed to acquire lock, drop log
+    }
+    int topic_id          = -1;
+    ulog_output_id output = ULOG_OUTPUT_ALL;
+    bool enabled = callsite_resolve(cs, level, topic, &topic_id, &output);
     (void)lock_unlock();
+    return enabled;
+}
+
+void ulog_log_callsite(ulog_callsite *cs, ulog_level level, const char *file,
+                       int line, const char *topic, const char *message, ...) {
+    va_list args;
+    va_start(args, message);
+    callsite_log(cs, level, file, line, topic, NULL, 0, message, args);
+    va_end(args);
+}
+
+void ulog_log_message(ulog_callsite *cs, ulog_level level, const char *file,
+                      int line, const char *topic, const char *message,
+                      size_t len) {
+    // The text is an argument, so it is never parsed as a format
+    const char *format = message != NULL ? log_text_format : NULL;
+    if (cs != NULL) {
+        ulog_log_callsite(cs, level, file, line, topic, format, message, len);
+    } else {
+        ulog_log(level, file, line, topic, format, message, len);
+    }
+}
+
+void ulog_log_kv(ulog_callsite *cs, ulog_level level, const char *file,
+                 int line, const char *topic, const char *message,
+                 const ulog_kv *fields, size_t count) {
+    if (fields == NULL) {
+        count = 0;
+    }
+#if !ULOG_HAS_KV && ULOG_HAS_WARN_NOT_ENABLED
+    if (count > 0) {
+        // The message is logged without the fields
+        warn_not_enabled("ULOG_BUILD_KV_FIELDS");
+    }
+#endif
+    // Plain text, as in ulog_log_message
+    if (message != NULL) {
+        callsite_log_fields(cs, level, file, line, topic, fields, count,
+                            log_text_format, message, strlen(message));
+    } else {
+        callsite_log_fields(cs, level, file, line, topic, fields, count, NULL);
+    }
 }
 
 /* ============================================================================
@@ -1833,27 +5739,17 @@ ulog_status ulog_cleanup(void) {
     if (lock_lock() != ULOG_STATUS_OK) {  // Lock the configuration
         return ULOG_STATUS_BUSY;
     }
+    // Flush queued events while their outputs and topics still exist
+    async_cleanup();
+    signal_safe_cleanup();
+
     // Cleanup Topics
 
-    // TODO: this section can be improved with topic_remove_all() function
 #if ULOG_HAS_TOPICS
     // Reset new-topic default enable flag
     topic_data.new_topic_enabled = false;
-#if TOPIC_IS_DYNAMIC
-    // Free linked list of dynamically allocated topics
-    topic_t *t = topic_data.topics;
-    while (t != NULL) {
-        topic_t *next = t->next;
-        free((void *)t->name);  // Free the allocated topic name
-        free(t);
-        t = next;
-    }
-    topic_data.topics = NULL;
-#else
-    // Zero out statically allocated topic array
-    memset(topic_data.topics, 0, sizeof(topic_data.topics));
-#endif
 #endif  // ULOG_HAS_TOPICS
+    topic_remove_all();
 
     // Cleanup Outputs (keep stdout (index 0) registered but reset its level)
     output_data.outputs[ULOG_OUTPUT_STDOUT].level = OUTPUT_STDOUT_DEFAULT_LEVEL;
@@ -1864,6 +5760,7 @@ ulog_status ulog_cleanup(void) {
         output_data.outputs[i].level   = OUTPUT_STDOUT_DEFAULT_LEVEL;
     }
 #endif  // ULOG_HAS_EXTRA_OUTPUTS
+    output_level_floor_update();
 
 #if ULOG_HAS_PREFIX
     // Reset prefix state
@@ -1871,6 +5768,11 @@ ulog_status ulog_cleanup(void) {
     memset(prefix_data.prefix, 0, sizeof(prefix_data.prefix));
 #endif
 
+#if ULOG_HAS_TIME
+    // Back to the wall clock
+    time_src = (time_source){0};
+#endif
+
     return lock_unlock();
 }
 
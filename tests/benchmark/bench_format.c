@@ -0,0 +1,69 @@
+//  benchmark: message formatter of ulog.c against vsnprintf
+//
+//  The formatter is static, so ulog.c is compiled into this file. Each case
+//  formats the same arguments into a buffer with both and prints the time per
+//  call. Build with -DULOG_BUILD_BENCHMARKS=ON and run bench_format.
+
+#include "../../src/ulog.c"
+
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_ITERATIONS 1000000
+#define BENCH_BUFFER_SIZE 256
+
+static char bench_buffer[BENCH_BUFFER_SIZE];
+
+static double bench_now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void bench_ulog(const char *format, ...) {
+    print_target tgt = {.type       = PRINT_TARGET_BUFFER,
+                        .dsc.buffer = {bench_buffer, 0, sizeof(bench_buffer)}};
+    va_list args;
+    va_start(args, format);
+    print_to_target_valist(&tgt, format, args);
+    va_end(args);
+}
+
+static void bench_libc(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(bench_buffer, sizeof(bench_buffer), format, args);
+    va_end(args);
+}
+
+// Times both formatters on one format and its arguments
+#define BENCH_CASE(name, ...)                                                  \
+    do {                                                                       \
+        double start_ = bench_now();                                           \
+        for (int i_ = 0; i_ < BENCH_ITERATIONS; i_++) {                        \
+            bench_ulog(__VA_ARGS__);                                           \
+        }                                                                      \
+        double ulog_ns_ = (bench_now() - start_) * 1e9 / BENCH_ITERATIONS;     \
+        start_          = bench_now();                                         \
+        for (int i_ = 0; i_ < BENCH_ITERATIONS; i_++) {                        \
+            bench_libc(__VA_ARGS__);                                           \
+        }                                                                      \
+        double libc_ns_ = (bench_now() - start_) * 1e9 / BENCH_ITERATIONS;     \
+        printf("%-12s %9.1f %9.1f %7.2fx\n", name, ulog_ns_, libc_ns_,         \
+               libc_ns_ / ulog_ns_);                                           \
+    } while (0)
+
+int main(void) {
+    printf("%-12s %9s %9s %8s\n", "case", "ulog ns", "libc ns", "speedup");
+    BENCH_CASE("int", "value=%d", 123456);
+    BENCH_CASE("ints", "%d %u %ld %lld", -42, 42u, -1234567L, 9876543210LL);
+    BENCH_CASE("hex", "addr=%08x mask=%#x", 0xbeefu, 0xffu);
+    BENCH_CASE("string", "user=%s host=%-10s", "bob", "example");
+    BENCH_CASE("double", "took %.3f ms", 12.3456);
+    BENCH_CASE("doubles", "%f %.2f %10.4f", 3.14159, -2.5, 1234.5678);
+    BENCH_CASE("pointer", "at %p", (void *)bench_buffer);
+    BENCH_CASE("mixed", "req %s id=%u took %.3f ms (%d%%)", "GET", 42u, 1.25,
+               99);
+    BENCH_CASE("fallback", "%e %g", 12345.678, 0.0001);
+    return 0;
+}
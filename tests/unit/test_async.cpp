@@ -0,0 +1,355 @@
+//  unit tests for the async feature
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+extern "C" {
+#include "ulog.h"
+#include "ut_callback.h"
+#include "../../extensions/ulog_async_pthread.h"
+#include "ulog_binary_decode.h"
+}
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+struct AsyncTestFixture {
+    AsyncTestFixture() {
+        ulog_cleanup();
+        ut_callback_reset();
+        ulog_output_level_set_all(ULOG_LEVEL_TRACE);
+        ulog_output_add(ut_callback, nullptr, ULOG_LEVEL_TRACE);
+    }
+
+    ~AsyncTestFixture() {
+        ulog_cleanup();
+    }
+};
+
+TEST_CASE_FIXTURE(AsyncTestFixture, "Async: Events are written on flush") {
+    ulog_info("Queued %d", 1);
+    ulog_debug("Queued %s", "two");
+    CHECK(ut_callback_get_message_count() == 0);
+    CHECK(ulog_async_pending() == 2);
+
+    CHECK(ulog_async_flush() == ULOG_STATUS_OK);
+    CHECK(ulog_async_pending() == 0);
+    CHECK(ut_callback_get_message_count() == 2);
+    CHECK(strstr(ut_callback_get_last_message(), "DEBUG") != nullptr);
+    CHECK(strstr(ut_callback_get_last_message(), "Queued two") != nullptr);
+}
+
+TEST_CASE_FIXTURE(AsyncTestFixture, "Async: Topics and outputs are kept") {
+    ulog_topic_add("net", ULOG_OUTPUT_ALL, ULOG_LEVEL_INFO);
+
+    ulog_t_info("net", "Connected");
+    ulog_t_debug("net", "Filtered before queueing");
+    CHECK(ulog_async_pending() == 1);
+
+    ulog_async_flush();
+    CHECK(ut_callback_get_message_count() == 1);
+    CHECK(strstr(ut_callback_get_last_message(), "[net]") != nullptr);
+
+    // Per-output levels are applied when the event is written
+    ulog_output_level_set_all(ULOG_LEVEL_ERROR);
+    ulog_error("Error");
+    ulog_output_level_set_all(ULOG_LEVEL_FATAL);
+    ulog_async_flush();
+    CHECK(ut_callback_get_message_count() == 1);
+}
+
+TEST_CASE_FIXTURE(AsyncTestFixture, "Async: Full queue drops events") {
+    for (int i = 0; i < ULOG_BUILD_ASYNC + 5; i++) {
+        ulog_info("Message %d", i);
+    }
+    CHECK(ulog_async_pending() == ULOG_BUILD_ASYNC);
+    CHECK(ulog_async_dropped() == 5);
+
+    ulog_async_flush();
+    CHECK(ut_callback_get_message_count() == ULOG_BUILD_ASYNC);
+
+    ulog_info("Fits again");
+    ulog_async_flush();
+    CHECK(ut_callback_get_message_count() == ULOG_BUILD_ASYNC + 1);
+    CHECK(strstr(ut_callback_get_last_message(), "Fits again") != nullptr);
+
+    ulog_cleanup();
+    CHECK(ulog_async_dropped() == 0);
+}
+
+static int requeue_left = 0;
+
+// Output that queues a new event for each event it is given
+static void requeue_handler(ulog_event *ev, void *arg) {
+    (void)ev;
+    (void)arg;
+    if (requeue_left > 0) {
+        requeue_left--;
+        ulog_info("Requeued");
+    }
+}
+
+TEST_CASE_FIXTURE(AsyncTestFixture, "Async: Flush stops at the queue end") {
+    requeue_left = 3;
+    ulog_output_add(requeue_handler, nullptr, ULOG_LEVEL_TRACE);
+    ulog_info("First");
+    CHECK(ulog_async_flush() == ULOG_STATUS_OK);
+    CHECK(ut_callback_get_message_count() == 1);
+    CHECK(ulog_async_pending() == 1);  // Queued during the flush
+
+    CHECK(ulog_async_flush() == ULOG_STATUS_OK);
+    CHECK(ut_callback_get_message_count() == 2);
+    CHECK(ulog_async_pending() == 1);
+    requeue_left = 0;
+}
+
+TEST_CASE_FIXTURE(AsyncTestFixture, "Async: Cleanup flushes pending events") {
+    ulog_info("Pending");
+    ulog_cleanup();
+    CHECK(ut_callback_get_message_count() == 1);
+}
+
+TEST_CASE_FIXTURE(AsyncTestFixture, "Async: Writer thread with producers") {
+    const int THREADS    = 4;
+    const int PER_THREAD  = 500;
+
+    REQUIRE(ulog_async_pthread_start(0) == ULOG_STATUS_OK);
+    CHECK(ulog_async_pthread_start(0) == ULOG_STATUS_BUSY);
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; t++) {
+        producers.emplace_back([t] {
+            for (int i = 0; i < PER_THREAD; i++) {
+                ulog_info("Thread %d message %d", t, i);
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+
+    CHECK(ulog_async_pthread_stop() == ULOG_STATUS_OK);
+    CHECK(ulog_async_pthread_stop() == ULOG_STATUS_NOT_FOUND);
+    CHECK(ulog_async_pending() == 0);
+    CHECK((size_t)ut_callback_get_message_count() + ulog_async_dropped() ==
+          (size_t)(THREADS * PER_THREAD));
+}
+
+TEST_CASE_FIXTURE(AsyncTestFixture, "Async: Deferred formatting") {
+    char expected[UT_LOG_BUFFER_SIZE];
+    int value = 42;
+    void *ptr = &value;
+
+    SUBCASE("Matches printf") {
+        ulog_info("%d|%-5i|%05u|%x|%c|%%|%lld|%zu|%ld|%hhd", -7, 3, 12u,
+                  0xbeefu, 'z', -1234567890123LL, (size_t)99, 77L, 5);
+        ulog_async_flush();
+        snprintf(expected, sizeof(expected),
+                 "%d|%-5i|%05u|%x|%c|%%|%lld|%zu|%ld|%hhd", -7, 3, 12u, 0xbeefu,
+                 'z', -1234567890123LL, (size_t)99, 77L, 5);
+        CHECK(strstr(ut_callback_get_last_message(), expected) != nullptr);
+
+        ulog_info("%.3f|%8.2e|%g|%Lf|%p|%*d|%.*s|%s", 3.14159, 1e10, 0.5,
+                  (long double)2.5, ptr, 6, 1, 3, "abcdef", (char *)nullptr);
+        ulog_async_flush();
+        snprintf(expected, sizeof(expected), "%.3f|%8.2e|%g|%Lf|%p|%*d|%.*s|%s",
+                 3.14159, 1e10, 0.5, (long double)2.5, ptr, 6, 1, 3, "abcdef",
+                 "(null)");
+        CHECK(strstr(ut_callback_get_last_message(), expected) != nullptr);
+    }
+
+    SUBCASE("Strings are copied at the call") {
+        char name[16] = "before";
+        ulog_info("Name: %s", name);
+        strcpy(name, "after");
+        ulog_async_flush();
+        CHECK(strstr(ut_callback_get_last_message(), "Name: before") !=
+              nullptr);
+    }
+
+    SUBCASE("Strings are read up to the precision") {
+        char *raw = (char *)malloc(4);  // Not terminated
+        REQUIRE(raw != nullptr);
+        memcpy(raw, "abcd", 4);
+        ulog_info("[%.3s] [%.*s] [%.4s]", raw, 2, raw, raw);
+        free(raw);
+        ulog_async_flush();
+        CHECK(strstr(ut_callback_get_last_message(), "[abc] [ab] [abcd]") !=
+              nullptr);
+    }
+
+    SUBCASE("Format in a temporary buffer") {
+        char format[16] = "Value %d";
+        ulog_info(format, value);
+        strcpy(format, "Changed");
+        ulog_async_flush();
+        CHECK(strstr(ut_callback_get_last_message(), "Value 42") != nullptr);
+    }
+
+    SUBCASE("Unsupported format falls back to formatting at the call") {
+        ulog_info("Wide %ls", L"text");
+        ulog_async_flush();
+        CHECK(strstr(ut_callback_get_last_message(), "Wide text") != nullptr);
+    }
+
+    SUBCASE("Record too long falls back to truncated text") {
+        char long_str[512];  // Longer than ULOG_BUILD_ASYNC_MESSAGE_SIZE
+        memset(long_str, 'a', sizeof(long_str) - 1);
+        long_str[sizeof(long_str) - 1] = '\0';
+        ulog_info("%s", long_str);
+        ulog_async_flush();
+        CHECK(ut_callback_get_message_count() == 1);
+        CHECK(strstr(ut_callback_get_last_message(), "aaaa") != nullptr);
+    }
+}
+
+TEST_CASE_FIXTURE(AsyncTestFixture, "Async: Key-value fields are copied") {
+    char key[8]    = "user";
+    char value[16] = "before";
+    ulog_kv_info(NULL, "login", ULOG_KV_STR(key, value),
+                 ULOG_KV_INT("id", 42));
+    strcpy(key, "xxxx");
+    strcpy(value, "after");
+    ulog_async_flush();
+    CHECK(strstr(ut_callback_get_last_message(), "login user=before id=42") !=
+          nullptr);
+}
+
+TEST_CASE_FIXTURE(AsyncTestFixture, "Async: Binary output") {
+    FILE *text   = tmpfile();
+    FILE *binary = tmpfile();
+    REQUIRE(text != nullptr);
+    REQUIRE(binary != nullptr);
+    ulog_output_add_file(text, ULOG_LEVEL_TRACE);
+    ulog_output_add_binary_file(binary, ULOG_LEVEL_TRACE);
+
+    char name[16] = "first";
+    ulog_info("captured %s %d %.2f", name, 7, 0.5);  // Deferred formatting
+    strcpy(name, "second");
+    ulog_kv_warn(NULL, "fields", ULOG_KV_STR("name", name));
+    ulog_async_flush();
+
+    FILE *decoded = tmpfile();
+    REQUIRE(decoded != nullptr);
+    rewind(binary);
+    CHECK(ulog_binary_decode(binary, decoded) == ULOG_STATUS_OK);
+
+    char expected[512] = {0};
+    char actual[512]   = {0};
+    rewind(text);
+    rewind(decoded);
+    CHECK(fread(expected, 1, sizeof(expected) - 1, text) > 0);
+    CHECK(fread(actual, 1, sizeof(actual) - 1, decoded) > 0);
+    CHECK(strstr(actual, "captured first 7 0.50\n") != nullptr);
+    CHECK(strcmp(actual, expected) == 0);
+
+    ulog_cleanup();
+    fclose(decoded);
+    fclose(binary);
+    fclose(text);
+}
+
+TEST_CASE_FIXTURE(AsyncTestFixture, "Async: Overflow policies") {
+    SUBCASE("Drop newest is the default") {
+        for (int i = 0; i < ULOG_BUILD_ASYNC + 3; i++) {
+            ulog_info("Message %d", i);
+        }
+        ulog_async_flush();
+        CHECK(ulog_async_dropped() == 3);
+        CHECK(ulog_async_dropped_by_level(ULOG_LEVEL_INFO) == 3);
+        CHECK(ulog_async_dropped_by_level(ULOG_LEVEL_WARN) == 0);
+        CHECK(strstr(ut_callback_get_last_message(), "Message 15") != nullptr);
+    }
+
+    SUBCASE("Drop oldest") {
+        REQUIRE(ulog_async_policy_set(ULOG_ASYNC_POLICY_DROP_OLDEST, 0) ==
+                ULOG_STATUS_OK);
+        ulog_warn("Oldest");
+        for (int i = 0; i < ULOG_BUILD_ASYNC + 2; i++) {
+            ulog_info("Message %d", i);
+        }
+        CHECK(ulog_async_pending() == ULOG_BUILD_ASYNC);
+        CHECK(ulog_async_dropped() == 3);
+        CHECK(ulog_async_dropped_by_level(ULOG_LEVEL_WARN) == 1);
+        CHECK(ulog_async_dropped_by_level(ULOG_LEVEL_INFO) == 2);
+
+        ulog_async_flush();
+        CHECK(ut_callback_get_message_count() == ULOG_BUILD_ASYNC);
+        CHECK(strstr(ut_callback_get_last_message(), "Message 17") != nullptr);
+    }
+
+    SUBCASE("Drop oldest with concurrent producers") {
+        REQUIRE(ulog_async_policy_set(ULOG_ASYNC_POLICY_DROP_OLDEST, 0) ==
+                ULOG_STATUS_OK);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; t++) {
+            producers.emplace_back([] {
+                for (int i = 0; i < 200; i++) {
+                    ulog_debug("Dropping producer %d", i);
+                }
+            });
+        }
+        for (auto &producer : producers) {
+            producer.join();
+        }
+        // Every event is either queued or counted as dropped once
+        CHECK(ulog_async_pending() == ULOG_BUILD_ASYNC);
+        CHECK(ulog_async_dropped() == 4 * 200 - ULOG_BUILD_ASYNC);
+    }
+
+    SUBCASE("Block with timeout") {
+        REQUIRE(ulog_async_policy_set(ULOG_ASYNC_POLICY_BLOCK_TIMEOUT, 20) ==
+                ULOG_STATUS_OK);
+        for (int i = 0; i < ULOG_BUILD_ASYNC; i++) {
+            ulog_info("Message %d", i);
+        }
+        auto start = std::chrono::steady_clock::now();
+        ulog_info("Times out");
+        auto waited = std::chrono::steady_clock::now() - start;
+        CHECK(waited >= std::chrono::milliseconds(10));
+        CHECK(ulog_async_dropped() == 1);
+    }
+
+    SUBCASE("Block waits for the writer") {
+        REQUIRE(ulog_async_policy_set(ULOG_ASYNC_POLICY_BLOCK, 0) ==
+                ULOG_STATUS_OK);
+        REQUIRE(ulog_async_pthread_start(0) == ULOG_STATUS_OK);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; t++) {
+            producers.emplace_back([] {
+                for (int i = 0; i < 200; i++) {
+                    ulog_debug("Blocking producer %d", i);
+                }
+            });
+        }
+        for (auto &producer : producers) {
+            producer.join();
+        }
+        CHECK(ulog_async_pthread_stop() == ULOG_STATUS_OK);
+        CHECK(ulog_async_dropped() == 0);
+        CHECK(ut_callback_get_message_count() == 4 * 200);
+    }
+
+    SUBCASE("Invalid policy") {
+        CHECK(ulog_async_policy_set((ulog_async_policy)42, 0) ==
+              ULOG_STATUS_INVALID_ARGUMENT);
+    }
+}
+
+TEST_CASE_FIXTURE(AsyncTestFixture, "Async: Drop report") {
+    REQUIRE(ulog_async_drop_report_set(true) == ULOG_STATUS_OK);
+    for (int i = 0; i < ULOG_BUILD_ASYNC + 2; i++) {
+        ulog_info("Message %d", i);
+    }
+    ulog_async_flush();
+    CHECK(ut_callback_get_message_count() == ULOG_BUILD_ASYNC + 1);
+    CHECK(strstr(ut_callback_get_last_message(), "WARN") != nullptr);
+    CHECK(strstr(ut_callback_get_last_message(), "2 messages dropped") !=
+          nullptr);
+
+    // Reported once
+    ulog_async_flush();
+    CHECK(ut_callback_get_message_count() == ULOG_BUILD_ASYNC + 1);
+}
@@ -0,0 +1,169 @@
+//  unit tests for the binary output and its decoder
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+extern "C" {
+#include "ulog.h"
+#include "ulog_binary_decode.h"
+}
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "ut_file.hpp"
+
+static void prefix_fn(ulog_event *ev, char *prefix, size_t prefix_size) {
+    snprintf(prefix, prefix_size, "[L%d]", (int)ulog_event_get_level(ev));
+}
+
+struct BinaryTestFixture {
+    FILE *text   = nullptr;
+    FILE *binary = nullptr;
+
+    BinaryTestFixture() {
+        ulog_cleanup();
+        ulog_output_level_set_all(ULOG_LEVEL_TRACE);
+        ulog_output_level_set(ULOG_OUTPUT_STDOUT, ULOG_LEVEL_FATAL);
+        text   = tmpfile();
+        binary = tmpfile();
+        REQUIRE(text != nullptr);
+        REQUIRE(binary != nullptr);
+        REQUIRE(ulog_output_add_file(text, ULOG_LEVEL_TRACE) !=
+                ULOG_OUTPUT_INVALID);
+        REQUIRE(ulog_output_add_binary_file(binary, ULOG_LEVEL_TRACE) !=
+                ULOG_OUTPUT_INVALID);
+    }
+
+    ~BinaryTestFixture() {
+        ulog_cleanup();
+        fclose(text);
+        fclose(binary);
+    }
+
+    /// @brief Decodes the binary log
+    std::string decode(ulog_status expected = ULOG_STATUS_OK) {
+        FILE *decoded = tmpfile();
+        REQUIRE(decoded != nullptr);
+        rewind(binary);
+        CHECK(ulog_binary_decode(binary, decoded) == expected);
+        std::string content = ut_read_stream(decoded);
+        fclose(decoded);
+        return content;
+    }
+};
+
+TEST_CASE_FIXTURE(BinaryTestFixture, "Binary: Decodes To The File Output Text") {
+    const char *null_str = nullptr;
+    ulog_info("Hello %s %d", "world", 42);
+    ulog_debug("%d %u %ld %lld %zu %x %c %%", -1, 2u, 3L, -4LL, (size_t)5,
+               0xabu, 'z');
+    ulog_warn("%f %.3f %e %g %s", 1.5, -2.25, 1e10, 0.0001, null_str);
+    ulog_error("[%*d] [%-*.*s] %p", 6, 42, 8, 2, "abc", (void *)0x1234);
+    ulog_trace("plain literal");
+    ulog_info("");
+
+    ulog_topic_add("net", ULOG_OUTPUT_ALL, ULOG_LEVEL_TRACE);
+    ulog_t_info("net", "link %s up", "eth0");
+    ulog_kv_warn("net", "request", ULOG_KV_STR("path", "/a b"),
+                 ULOG_KV_INT("status", -1), ULOG_KV_UINT("bytes", 10),
+                 ULOG_KV_BOOL("ok", true), ULOG_KV_DOUBLE("ms", 0.25));
+
+    ulog_prefix_set_fn(prefix_fn);
+    ulog_info("with prefix");
+    ulog_prefix_config(false);
+    ulog_info("prefix off, no space after the time");
+    ulog_prefix_config(true);
+
+    ulog_time_config(false);
+    ulog_source_location_config(false);
+    ulog_info("no time, no location");
+    ulog_time_config(true);
+    ulog_source_location_config(true);
+
+    std::string text_log = ut_read_stream(text);
+    CHECK(text_log.find("no time, no location") != std::string::npos);
+    CHECK(decode() == text_log);
+}
+
+TEST_CASE_FIXTURE(BinaryTestFixture, "Binary: Dictionary And Large Messages") {
+    // Longer than the text the dictionary keeps
+    for (int i = 0; i < 4; i++) {
+        std::string format = std::string(100, 'a' + i) + " %d";
+        ulog_info(format.c_str(), i);
+        ulog_info(format.c_str(), i);
+    }
+
+    // More distinct formats and files than the dictionary holds
+    for (int i = 0; i < 40; i++) {
+        char format[32];
+        snprintf(format, sizeof(format), "format %d: %%d", i % 20);
+        ulog_log(ULOG_LEVEL_INFO, i % 2 ? "a.c" : "b.c", i, nullptr, format,
+                 i);
+    }
+
+    // Larger than a capture record, formatted when logged
+    std::string big(2000, 'x');
+    ulog_info("big %s end", big.c_str());
+    ulog_info("%ls", L"wide");  // Not captured
+
+    std::string text_log = ut_read_stream(text);
+    CHECK(decode() == text_log);
+
+    // Smaller than the text
+    CHECK(ftell(binary) > 0);
+    fseek(binary, 0, SEEK_END);
+    CHECK(ftell(binary) < (long)text_log.size());
+}
+
+TEST_CASE_FIXTURE(BinaryTestFixture, "Binary: Invalid Input") {
+    ulog_info("first %d", 1);
+    ulog_info("second %d", 2);
+    std::string full = decode();
+
+    // Truncated: the complete lines are decoded
+    std::string log = ut_read_stream(binary);
+    FILE *truncated = tmpfile();
+    REQUIRE(truncated != nullptr);
+    fwrite(log.data(), 1, log.size() - 1, truncated);
+    rewind(truncated);
+    FILE *decoded = tmpfile();
+    REQUIRE(decoded != nullptr);
+    CHECK(ulog_binary_decode(truncated, decoded) == ULOG_STATUS_ERROR);
+    std::string lines = ut_read_stream(decoded);
+    CHECK(lines == full.substr(0, full.find('\n') + 1));
+    fclose(decoded);
+
+    // Not a binary log
+    rewind(text);
+    CHECK(ulog_binary_decode(text, truncated) == ULOG_STATUS_ERROR);
+    fclose(truncated);
+
+    CHECK(ulog_binary_decode(nullptr, binary) ==
+          ULOG_STATUS_INVALID_ARGUMENT);
+}
+
+TEST_CASE("Binary: Output Limit") {
+    ulog_cleanup();
+    FILE *files[3];
+    for (FILE *&file : files) {
+        file = tmpfile();
+        REQUIRE(file != nullptr);
+    }
+    ulog_output_id first = ulog_output_add_binary_file(files[0],
+                                                       ULOG_LEVEL_TRACE);
+    CHECK(first != ULOG_OUTPUT_INVALID);
+    CHECK(ulog_output_add_binary_file(files[1], ULOG_LEVEL_TRACE) !=
+          ULOG_OUTPUT_INVALID);
+    CHECK(ulog_output_add_binary_file(files[2], ULOG_LEVEL_TRACE) ==
+          ULOG_OUTPUT_INVALID);
+
+    // Removed outputs free their state
+    CHECK(ulog_output_remove(first) == ULOG_STATUS_OK);
+    CHECK(ulog_output_add_binary_file(files[2], ULOG_LEVEL_TRACE) !=
+          ULOG_OUTPUT_INVALID);
+
+    ulog_cleanup();
+    for (FILE *file : files) {
+        fclose(file);
+    }
+}
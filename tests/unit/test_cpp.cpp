@@ -0,0 +1,129 @@
+//  unit tests for the C++ front end (ulog.hpp)
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include "ulog.hpp"
+extern "C" {
+#include "ut_callback.h"
+}
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Types without a writer are rejected at compile time
+static_assert(ulog::detail::formattable<int>);
+static_assert(ulog::detail::formattable<std::string>);
+static_assert(!ulog::detail::formattable<std::vector<int>>);
+
+struct CppTestFixture {
+    CppTestFixture() {
+        ut_callback_reset();
+        ulog_cleanup();
+        ulog_output_level_set_all(ULOG_LEVEL_TRACE);
+        ulog_output_add(ut_callback, nullptr, ULOG_LEVEL_TRACE);
+    }
+
+    ~CppTestFixture() {
+        ulog_cleanup();
+    }
+};
+
+/// @brief Message text after "file:line: "
+static const char *last_text() {
+    const char *msg = ut_callback_get_last_message();
+    const char *end = strstr(msg, ": ");
+    return end != nullptr ? end + 2 : msg;
+}
+
+enum class Color { red = 3 };
+
+TEST_CASE_FIXTURE(CppTestFixture, "Argument Types") {
+    ulog::info("{} {} {} {}", 42, -7, 3000000000u, static_cast<short>(5));
+    CHECK(strcmp(last_text(), "42 -7 3000000000 5") == 0);
+
+    ulog::info("{} {}", 1.5, 0.25f);
+    CHECK(strcmp(last_text(), "1.5 0.25") == 0);
+
+    ulog::info("{} {} {}", true, false, 'x');
+    CHECK(strcmp(last_text(), "true false x") == 0);
+
+    const char *null_str = nullptr;
+    std::string str      = "string";
+    ulog::info("{} {} {} {}", "literal", str, std::string_view("view"),
+               null_str);
+    CHECK(strcmp(last_text(), "literal string view NULL") == 0);
+
+    ulog::info("{}", Color::red);
+    CHECK(strcmp(last_text(), "3") == 0);
+
+    int value = 0;
+    ulog::info("{}", &value);
+    CHECK(strncmp(last_text(), "0x", 2) == 0);
+}
+
+TEST_CASE_FIXTURE(CppTestFixture, "Format String") {
+    ulog::info("No arguments, 100% verbatim");
+    CHECK(strcmp(last_text(), "No arguments, 100% verbatim") == 0);
+
+    ulog::info("{{}} {{{}}}", 1);
+    CHECK(strcmp(last_text(), "{} {1}") == 0);
+
+    ulog::info("{}{}", "a", "b");
+    CHECK(strcmp(last_text(), "ab") == 0);
+}
+
+TEST_CASE_FIXTURE(CppTestFixture, "Source Location") {
+    ulog::warn("Location");
+    CHECK(strstr(ut_callback_get_last_message(), "test_cpp.cpp:") != nullptr);
+    CHECK(strstr(ut_callback_get_last_message(), "WARN") != nullptr);
+}
+
+TEST_CASE_FIXTURE(CppTestFixture, "Levels") {
+    ulog_output_level_set_all(ULOG_LEVEL_INFO);
+
+    ulog::debug("Filtered {}", 1);
+    ulog::trace("Filtered");
+    CHECK(ut_callback_get_message_count() == 0);
+
+    ulog::info("Passed");
+    ulog::error("Passed");
+    ulog::fatal("Passed");
+    CHECK(ut_callback_get_message_count() == 3);
+}
+
+TEST_CASE_FIXTURE(CppTestFixture, "Topics") {
+    ulog_topic_add("net", ULOG_OUTPUT_ALL, ULOG_LEVEL_WARN);
+
+    ulog::topic_info("net", "Filtered by topic {}", 1);
+    CHECK(ut_callback_get_message_count() == 0);
+
+    ulog::topic_warn("net", "Port {}", 80);
+    CHECK(ut_callback_get_message_count() == 1);
+    CHECK(strstr(ut_callback_get_last_message(), "net") != nullptr);
+    CHECK(strcmp(last_text(), "Port 80") == 0);
+}
+
+TEST_CASE_FIXTURE(CppTestFixture, "Long Message Is Truncated") {
+    std::string long_str(1000, 'a');
+    ulog::info("{}", long_str);
+    CHECK(strlen(last_text()) == ULOG_HPP_MESSAGE_SIZE - 1);
+}
+
+TEST_CASE_FIXTURE(CppTestFixture, "Callsites Keep Their Own Decision") {
+    ulog_topic_add("net", ULOG_OUTPUT_ALL, ULOG_LEVEL_WARN);
+
+    for (int i = 0; i < 3; i++) {
+        if (i == 2) {
+            ulog_topic_level_set("net", ULOG_LEVEL_INFO);
+        }
+        ut_callback_reset();
+        ulog::topic_info("net", "Net {}", i);
+        ulog::info("Plain {}", i);
+        ulog::topic_warn("net", "Net warning {}", i);
+        CHECK(ut_callback_get_message_count() == (i == 2 ? 3 : 2));
+        std::string expected = "Net warning " + std::to_string(i);
+        CHECK(strcmp(last_text(), expected.c_str()) == 0);
+    }
+}
@@ -33,6 +33,8 @@ TEST_CASE_FIXTURE(TestFixture, "Disabled - Basic Logging Macros") {
     
     // Generic macro
     ulog(ULOG_LEVEL_INFO, "Generic log message %d", ++counter);
+    ulog_signal_safe(ULOG_LEVEL_INFO, "Signal safe message %d", ++counter);
+    ulog_signal_safe_error("Signal safe error %d", ++counter);
     
     // Since the macros are ((void)0), arguments should NOT be evaluated
     // This is the intended behavior for zero-overhead when disabled
@@ -86,12 +88,15 @@ TEST_CASE_FIXTURE(TestFixture, "Disabled - Status Functions") {
     CHECK(ulog_output_remove(ULOG_OUTPUT_STDOUT) == ULOG_STATUS_DISABLED);
     CHECK(ulog_topic_level_set("test", ULOG_LEVEL_DEBUG) == ULOG_STATUS_DISABLED);
     CHECK(ulog_topic_remove("test") == ULOG_STATUS_DISABLED);
+    CHECK(ulog_signal_safe_fd_add(2, ULOG_LEVEL_INFO) == ULOG_STATUS_DISABLED);
+    CHECK(ulog_signal_safe_fd_remove(2) == ULOG_STATUS_DISABLED);
 }
 
 // Test event functions
 TEST_CASE_FIXTURE(TestFixture, "Disabled - Event Functions") {
     // These should return appropriate disabled values
     CHECK(ulog_event_to_cstr(nullptr, nullptr, 0) == ULOG_STATUS_DISABLED);
+    CHECK(ulog_event_to_line(nullptr, nullptr, 0, nullptr) == ULOG_STATUS_DISABLED);
     CHECK(ulog_event_get_message(nullptr, nullptr, 0) == ULOG_STATUS_DISABLED);
     CHECK(ulog_event_get_topic(nullptr) == ULOG_TOPIC_ID_INVALID);
     CHECK(ulog_event_get_line(nullptr) == -1);
@@ -108,6 +113,7 @@ TEST_CASE_FIXTURE(TestFixture, "Disabled - Event Functions") {
 TEST_CASE_FIXTURE(TestFixture, "Disabled - Output Functions") {
     CHECK(ulog_output_add(nullptr, nullptr, ULOG_LEVEL_INFO) == ULOG_OUTPUT_INVALID);
     CHECK(ulog_output_add_file(nullptr, ULOG_LEVEL_DEBUG) == ULOG_OUTPUT_INVALID);
+    CHECK(ulog_output_add_json_file(nullptr, ULOG_LEVEL_DEBUG) == ULOG_OUTPUT_INVALID);
 }
 
 // Test topic functions
@@ -351,3 +351,148 @@ TEST_CASE("Dynamic Topic Error Handling") {
     id = ulog_topic_get_id(nullptr);
     CHECK(id == ULOG_TOPIC_ID_INVALID);
 }
+
+static int callsite_side_effect_count = 0;
+
+static int callsite_side_effect() {
+    return ++callsite_side_effect_count;
+}
+
+static void log_from_one_callsite(const char *topic) {
+    ulog_t_info(topic, "Shared callsite");
+}
+
+TEST_CASE_FIXTURE(DynamicTopicsTestFixture, "Callsite Cache") {
+    ulog_topic_add("cache", ULOG_OUTPUT_ALL, ULOG_LEVEL_INFO);
+    callsite_side_effect_count = 0;
+
+    SUBCASE("Filtered messages do not evaluate arguments") {
+        for (int i = 0; i < 3; i++) {
+            ulog_t_debug("cache", "Filtered %d", callsite_side_effect());
+        }
+        CHECK(callsite_side_effect_count == 0);
+        CHECK(ut_callback_get_message_count() == 0);
+    }
+
+    SUBCASE("Topic level change invalidates the cache") {
+        for (int i = 0; i < 2; i++) {
+            ulog_t_debug("cache", "Message %d", callsite_side_effect());
+            ulog_topic_level_set("cache", ULOG_LEVEL_DEBUG);
+        }
+        CHECK(callsite_side_effect_count == 1);
+        CHECK(ut_callback_get_message_count() == 1);
+    }
+
+    SUBCASE("Output level change invalidates the cache") {
+        for (int i = 0; i < 2; i++) {
+            ulog_t_info("cache", "Message");
+            ulog_output_level_set_all(ULOG_LEVEL_ERROR);
+        }
+        CHECK(ut_callback_get_message_count() == 1);
+    }
+
+    SUBCASE("Topic removal and re-add invalidate the cache") {
+        for (int i = 0; i < 3; i++) {
+            ulog_t_info("cache", "Message");
+            if (i == 0) {
+                ulog_topic_remove("cache");
+            } else {
+                ulog_topic_add("cache", ULOG_OUTPUT_ALL, ULOG_LEVEL_TRACE);
+            }
+        }
+        CHECK(ut_callback_get_message_count() == 2);
+    }
+
+    SUBCASE("Different topics through the same callsite") {
+        ulog_topic_add("other", ULOG_OUTPUT_ALL, ULOG_LEVEL_ERROR);
+        log_from_one_callsite("cache");
+        log_from_one_callsite("other");
+        log_from_one_callsite("cache");
+        CHECK(ut_callback_get_message_count() == 2);
+        CHECK(strstr(ut_callback_get_last_message(), "[cache]") != nullptr);
+    }
+
+    SUBCASE("Topic buffer reused for another name") {
+        ulog_topic_add("other", ULOG_OUTPUT_ALL, ULOG_LEVEL_TRACE);
+        char topic[16];
+        strcpy(topic, "cache");
+        log_from_one_callsite(topic);
+        strcpy(topic, "other");
+        log_from_one_callsite(topic);
+        CHECK(ut_callback_get_message_count() == 2);
+        CHECK(strstr(ut_callback_get_last_message(), "[other]") != nullptr);
+    }
+}
+
+TEST_CASE_FIXTURE(DynamicTopicsTestFixture, "Log By Topic ID") {
+    ulog_topic_id id = ulog_topic_add("by_id", ULOG_OUTPUT_ALL, ULOG_LEVEL_INFO);
+    REQUIRE(id >= 0);
+
+    ulog_tid_info(id, "Message %d", 1);
+    CHECK(ut_callback_get_message_count() == 1);
+    CHECK(strstr(ut_callback_get_last_message(), "[by_id]") != nullptr);
+    CHECK(strstr(ut_callback_get_last_message(), "Message 1") != nullptr);
+
+    ulog_tid_debug(id, "Filtered by topic level");
+    CHECK(ut_callback_get_message_count() == 1);
+
+    ulog_tid(ULOG_LEVEL_WARN, ulog_topic_get_id("by_id"), "Warn");
+    CHECK(ut_callback_get_message_count() == 2);
+
+    ulog_tid_error(id + 100, "Invalid ID is dropped");
+    ulog_tid_error(-1, "Invalid ID is dropped");
+    CHECK(ut_callback_get_message_count() == 2);
+
+    ulog_topic_remove("by_id");
+    ulog_tid_error(id, "Removed topic is dropped");
+    CHECK(ut_callback_get_message_count() == 2);
+}
+
+TEST_CASE_FIXTURE(DynamicTopicsTestFixture, "Dynamic Topic Registry Growth") {
+    const int NUM_TOPICS = 400;
+    char topic_name[32];
+
+    for (int i = 0; i < NUM_TOPICS; i++) {
+        snprintf(topic_name, sizeof(topic_name), "grow_%d", i);
+        CHECK(ulog_topic_add(topic_name, ULOG_OUTPUT_ALL, ULOG_LEVEL_TRACE) ==
+              i);
+    }
+
+    // Remove every other topic, the rest must stay reachable by name
+    for (int i = 0; i < NUM_TOPICS; i += 2) {
+        snprintf(topic_name, sizeof(topic_name), "grow_%d", i);
+        CHECK(ulog_topic_remove(topic_name) == ULOG_STATUS_OK);
+    }
+    for (int i = 0; i < NUM_TOPICS; i++) {
+        snprintf(topic_name, sizeof(topic_name), "grow_%d", i);
+        ulog_topic_id expected = (i % 2 == 0) ? ULOG_TOPIC_ID_INVALID : i;
+        CHECK(ulog_topic_get_id(topic_name) == expected);
+    }
+
+    // Churn through removed names to exercise index tombstones
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < NUM_TOPICS; i += 2) {
+            snprintf(topic_name, sizeof(topic_name), "grow_%d", i);
+            CHECK(ulog_topic_add(topic_name, ULOG_OUTPUT_ALL,
+                                 ULOG_LEVEL_TRACE) != ULOG_TOPIC_ID_INVALID);
+            CHECK(ulog_topic_remove(topic_name) == ULOG_STATUS_OK);
+        }
+    }
+
+    // Removed slots are reused, so the ID range does not grow
+    for (int i = 0; i < NUM_TOPICS; i += 2) {
+        snprintf(topic_name, sizeof(topic_name), "reuse_%d", i);
+        ulog_topic_id id =
+            ulog_topic_add(topic_name, ULOG_OUTPUT_ALL, ULOG_LEVEL_TRACE);
+        CHECK(id >= 0);
+        CHECK(id < NUM_TOPICS);
+        CHECK(id % 2 == 0);
+    }
+    CHECK(ulog_topic_get_id("grow_1") == 1);  // Live IDs are stable
+
+    ut_callback_reset();
+    ulog_topic_info("grow_399", "Last topic");
+    ulog_topic_info("grow_0", "Removed topic");
+    CHECK(ut_callback_get_message_count() == 1);
+    CHECK(strstr(ut_callback_get_last_message(), "[grow_399]") != nullptr);
+}
@@ -0,0 +1,258 @@
+//  unit tests for the buffered POSIX file output extension
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+extern "C" {
+#include "ulog.h"
+#include "ulog_file_posix.h"
+}
+
+#include <glob.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ut_file.hpp"
+
+struct FilePosixTestFixture {
+    char path[32] = "/tmp/ulog_file_posix_XXXXXX";
+    FILE *text    = nullptr;  // ulog_output_add_file() for the reference
+    ulog_output_id text_output = ULOG_OUTPUT_INVALID;
+
+    FilePosixTestFixture() {
+        ulog_cleanup();
+        ulog_output_level_set_all(ULOG_LEVEL_TRACE);
+        ulog_output_level_set(ULOG_OUTPUT_STDOUT, ULOG_LEVEL_FATAL);
+        int fd = mkstemp(path);
+        REQUIRE(fd >= 0);
+        close(fd);
+        text = tmpfile();
+        REQUIRE(text != nullptr);
+        text_output = ulog_output_add_file(text, ULOG_LEVEL_TRACE);
+        REQUIRE(text_output != ULOG_OUTPUT_INVALID);
+    }
+
+    ~FilePosixTestFixture() {
+        ulog_cleanup();
+        fclose(text);
+        unlink(path);
+        for (const std::string &rotated : rotated_files()) {
+            unlink(rotated.c_str());
+        }
+    }
+
+    /// @brief Rotated files, in name order
+    std::vector<std::string> rotated_files() {
+        std::vector<std::string> names;
+        glob_t found;
+        std::string pattern = std::string(path) + ".*";
+        if (glob(pattern.c_str(), 0, nullptr, &found) == 0) {
+            names.assign(found.gl_pathv, found.gl_pathv + found.gl_pathc);
+        }
+        globfree(&found);
+        return names;
+    }
+
+    /// @brief Returns the text written by the reference file output
+    std::string text_content() {
+        return ut_read_stream(text);
+    }
+};
+
+TEST_CASE_FIXTURE(FilePosixTestFixture, "File POSIX: Buffered Lines") {
+    ulog_output_id out = ulog_file_posix_open(path, ULOG_LEVEL_TRACE, nullptr);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+
+    ulog_info("Hello %s %d", "world", 42);
+    ulog_debug("Second line");
+    CHECK(ut_read_file(path).empty());  // Still in the buffer
+
+    CHECK(ulog_file_posix_flush(out) == ULOG_STATUS_OK);
+    CHECK(ut_read_file(path) == text_content());
+
+    // Same text as the file output, appended
+    ulog_warn("Third line %f", 1.5);
+    CHECK(ulog_file_posix_close(out) == ULOG_STATUS_OK);
+    CHECK(ut_read_file(path) == text_content());
+    CHECK(ulog_file_posix_close(out) == ULOG_STATUS_NOT_FOUND);
+}
+
+TEST_CASE_FIXTURE(FilePosixTestFixture, "File POSIX: Flush Level") {
+    ulog_output_id out = ulog_file_posix_open(path, ULOG_LEVEL_TRACE, nullptr);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+
+    ulog_warn("Buffered");
+    CHECK(ut_read_file(path).empty());
+    ulog_error("Written at once");
+    CHECK(ut_read_file(path) == text_content());  // With the buffered line
+
+    CHECK(ulog_file_posix_close(out) == ULOG_STATUS_OK);
+}
+
+TEST_CASE_FIXTURE(FilePosixTestFixture, "File POSIX: Flush Bytes") {
+    ulog_file_posix_config config = ULOG_FILE_POSIX_CONFIG_DEFAULT;
+    config.flush_bytes            = 200;
+    ulog_output_id out = ulog_file_posix_open(path, ULOG_LEVEL_TRACE, &config);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+
+    size_t buffered = 0;
+    while (ut_read_file(path).empty()) {
+        REQUIRE(buffered < 200);
+        ulog_info("Line %d", 1);
+        buffered = text_content().size();
+    }
+    CHECK(buffered >= 200);
+    CHECK(ut_read_file(path) == text_content());
+
+    CHECK(ulog_file_posix_close(out) == ULOG_STATUS_OK);
+}
+
+TEST_CASE_FIXTURE(FilePosixTestFixture, "File POSIX: Full Buffer") {
+    ulog_file_posix_config config = ULOG_FILE_POSIX_CONFIG_DEFAULT;
+    config.buffer_size            = 100;  // Rounded up to 4096
+    ulog_output_id out = ulog_file_posix_open(path, ULOG_LEVEL_TRACE, &config);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+
+    for (int i = 0; i < 200; i++) {
+        ulog_info("Line %d of many, %s", i, "long enough to fill the buffer");
+    }
+    std::string written = ut_read_file(path);
+    CHECK(!written.empty());
+    CHECK(written.size() <= text_content().size());
+    CHECK(written.back() == '\n');  // Only whole lines
+    CHECK(text_content().compare(0, written.size(), written) == 0);
+
+    CHECK(ulog_file_posix_close(out) == ULOG_STATUS_OK);
+    CHECK(ut_read_file(path) == text_content());
+
+    // Longer than the whole buffer: truncated, the line break is kept
+    std::string before = ut_read_file(path);
+    out = ulog_file_posix_open(path, ULOG_LEVEL_TRACE, &config);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+    std::string long_str(5000, 'x');
+    ulog_info("%s", long_str.c_str());
+    CHECK(ulog_file_posix_close(out) == ULOG_STATUS_OK);
+    std::string content = ut_read_file(path);
+    CHECK(content.size() == before.size() + 4095);
+    CHECK(content.compare(0, before.size(), before) == 0);
+    CHECK(content.back() == '\n');
+}
+
+TEST_CASE_FIXTURE(FilePosixTestFixture, "File POSIX: Flush Interval") {
+    ulog_file_posix_config config = ULOG_FILE_POSIX_CONFIG_DEFAULT;
+    config.flush_ms               = 5;
+    ulog_output_id out = ulog_file_posix_open(path, ULOG_LEVEL_TRACE, &config);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+
+    ulog_info("Written by the flusher thread");
+    for (int i = 0; i < 1000 && ut_read_file(path).empty(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(ut_read_file(path) == text_content());
+
+    CHECK(ulog_file_posix_close(out) == ULOG_STATUS_OK);
+}
+
+TEST_CASE_FIXTURE(FilePosixTestFixture, "File POSIX: Invalid Arguments") {
+    CHECK(ulog_file_posix_open(nullptr, ULOG_LEVEL_TRACE, nullptr) ==
+          ULOG_OUTPUT_INVALID);
+    CHECK(ulog_file_posix_open("/nonexistent/dir/file.log", ULOG_LEVEL_TRACE,
+                               nullptr) == ULOG_OUTPUT_INVALID);
+    CHECK(ulog_file_posix_flush(text_output) == ULOG_STATUS_NOT_FOUND);
+    CHECK(ulog_file_posix_close(ULOG_OUTPUT_INVALID) == ULOG_STATUS_NOT_FOUND);
+
+    // Limited number of files, a closed one frees its slot
+    ulog_output_id outs[ULOG_FILE_POSIX_NUM];
+    for (auto &out : outs) {
+        out = ulog_file_posix_open(path, ULOG_LEVEL_TRACE, nullptr);
+        REQUIRE(out != ULOG_OUTPUT_INVALID);
+    }
+    CHECK(ulog_file_posix_open(path, ULOG_LEVEL_TRACE, nullptr) ==
+          ULOG_OUTPUT_INVALID);
+    CHECK(ulog_file_posix_close(outs[0]) == ULOG_STATUS_OK);
+    outs[0] = ulog_file_posix_open(path, ULOG_LEVEL_TRACE, nullptr);
+    CHECK(outs[0] != ULOG_OUTPUT_INVALID);
+    for (auto out : outs) {
+        CHECK(ulog_file_posix_close(out) == ULOG_STATUS_OK);
+    }
+}
+
+TEST_CASE_FIXTURE(FilePosixTestFixture, "File POSIX: Rotation By Size") {
+    ulog_file_posix_config config = ULOG_FILE_POSIX_CONFIG_DEFAULT;
+    config.flush_level            = ULOG_LEVEL_TRACE;  // Write every line
+    config.rotate_bytes           = 300;
+    config.rotate_keep            = 2;
+    ulog_output_id out = ulog_file_posix_open(path, ULOG_LEVEL_TRACE, &config);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+
+    std::string next = std::string(path) + ".next";
+    CHECK(access(next.c_str(), F_OK) == 0);  // Opened ahead of time
+    for (int i = 0; i < 40; i++) {
+        ulog_info("Rotated line %d", i);
+        // Let the worker rename, or the file grows until it is done
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    CHECK(ulog_file_posix_close(out) == ULOG_STATUS_OK);
+
+    std::string one = std::string(path) + ".1";
+    std::string two = std::string(path) + ".2";
+    CHECK(rotated_files() == std::vector<std::string>{one, two});
+    CHECK(ut_read_file(one.c_str()).size() >= 300);
+    CHECK(ut_read_file(two.c_str()).size() >= 300);
+
+    // The kept files hold the last lines in order, the oldest are deleted
+    std::string kept = ut_read_file(two.c_str()) + ut_read_file(one.c_str()) +
+                       ut_read_file(path);
+    std::string all = text_content();
+    CHECK(kept.size() <= all.size());
+    CHECK(all.compare(all.size() - kept.size(), kept.size(), kept) == 0);
+}
+
+TEST_CASE_FIXTURE(FilePosixTestFixture, "File POSIX: Rotation Timestamp") {
+    ulog_file_posix_config config = ULOG_FILE_POSIX_CONFIG_DEFAULT;
+    config.flush_level            = ULOG_LEVEL_TRACE;
+    config.rotate_bytes           = 100;
+    config.rotate_keep            = 3;
+    config.rotate_naming          = ULOG_FILE_POSIX_NAMING_TIMESTAMP;
+    ulog_output_id out = ulog_file_posix_open(path, ULOG_LEVEL_TRACE, &config);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+
+    for (int i = 0; i < 40; i++) {
+        ulog_info("Rotated line %d", i);
+        // Let the worker rename, or the file grows until it is done
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    CHECK(ulog_file_posix_close(out) == ULOG_STATUS_OK);
+
+    std::vector<std::string> rotated = rotated_files();
+    CHECK(rotated.size() == 3);  // Older ones are deleted, no ".next"
+    for (const std::string &name : rotated) {
+        CHECK(name.size() > strlen(path) + strlen(".YYYYmmdd-HHMMSS") - 1);
+        CHECK(name.find(".next") == std::string::npos);
+    }
+}
+
+TEST_CASE_FIXTURE(FilePosixTestFixture, "File POSIX: Rotation By Time") {
+    ulog_file_posix_config config = ULOG_FILE_POSIX_CONFIG_DEFAULT;
+    config.rotate_sec             = 1;
+    ulog_output_id out = ulog_file_posix_open(path, ULOG_LEVEL_TRACE, &config);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+
+    ulog_info("Before the rotation");
+    std::string one = std::string(path) + ".1";
+    for (int i = 0; i < 300 && access(one.c_str(), F_OK) != 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    // The worker writes the buffered line to the old file first
+    CHECK(ut_read_file(one.c_str()) == text_content());
+    CHECK(ut_read_file(path).empty());
+
+    ulog_info("After the rotation");
+    CHECK(ulog_file_posix_close(out) == ULOG_STATUS_OK);
+    CHECK(ut_read_file(one.c_str()) + ut_read_file(path) == text_content());
+}
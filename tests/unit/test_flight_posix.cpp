@@ -0,0 +1,213 @@
+//  unit tests for the flight recorder extension
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+extern "C" {
+#include "ulog.h"
+#include "ulog_flight_posix.h"
+}
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ut_file.hpp"
+
+/// @brief Number of lines in the text
+static size_t count_lines(const std::string &text) {
+    size_t lines = 0;
+    for (char c : text) {
+        lines += c == '\n' ? 1 : 0;
+    }
+    return lines;
+}
+
+struct FlightPosixTestFixture {
+    FILE *text = nullptr;  // ulog_output_add_file() for the reference
+    FILE *dump = nullptr;  // Dumps are written to its file descriptor
+    ulog_output_id text_output = ULOG_OUTPUT_INVALID;
+    ulog_flight_posix_config config = ULOG_FLIGHT_POSIX_CONFIG_DEFAULT;
+
+    FlightPosixTestFixture() {
+        ulog_cleanup();
+        ulog_output_level_set_all(ULOG_LEVEL_TRACE);
+        ulog_output_level_set(ULOG_OUTPUT_STDOUT, ULOG_LEVEL_FATAL);
+        text = tmpfile();
+        dump = tmpfile();
+        REQUIRE(text != nullptr);
+        REQUIRE(dump != nullptr);
+        text_output = ulog_output_add_file(text, ULOG_LEVEL_TRACE);
+        REQUIRE(text_output != ULOG_OUTPUT_INVALID);
+        config.dump_fd        = fileno(dump);
+        config.dump_on_fatal  = false;
+        config.dump_on_signal = false;
+    }
+
+    ~FlightPosixTestFixture() {
+        ulog_cleanup();
+        fclose(text);
+        fclose(dump);
+    }
+
+    /// @brief Dumps the recorder and returns the dump
+    std::string dump_content() {
+        CHECK(ulog_flight_posix_dump(fileno(dump)) == ULOG_STATUS_OK);
+        return ut_read_stream(dump);
+    }
+};
+
+TEST_CASE_FIXTURE(FlightPosixTestFixture, "Flight POSIX: Recorded Lines") {
+    ulog_output_id rec = ulog_flight_posix_open(ULOG_LEVEL_TRACE, &config);
+    REQUIRE(rec != ULOG_OUTPUT_INVALID);
+    CHECK(dump_content().empty());
+
+    ulog_trace("Trace %d", 1);
+    ulog_debug("Debug %s", "detail");
+    ulog_info("Info");
+    CHECK(dump_content() == ut_read_stream(text));  // Same text, oldest first
+
+    CHECK(ulog_flight_posix_open(ULOG_LEVEL_TRACE, &config) ==
+          ULOG_OUTPUT_INVALID);  // Only one recorder
+    CHECK(ulog_flight_posix_close(text_output) == ULOG_STATUS_NOT_FOUND);
+    CHECK(ulog_flight_posix_close(rec) == ULOG_STATUS_OK);
+    CHECK(ulog_flight_posix_close(rec) == ULOG_STATUS_NOT_FOUND);
+
+    // Reopening clears the ring
+    rec = ulog_flight_posix_open(ULOG_LEVEL_TRACE, &config);
+    REQUIRE(rec != ULOG_OUTPUT_INVALID);
+    CHECK(ftruncate(fileno(dump), 0) == 0);
+    CHECK(dump_content().empty());
+    CHECK(ulog_flight_posix_close(rec) == ULOG_STATUS_OK);
+}
+
+TEST_CASE_FIXTURE(FlightPosixTestFixture, "Flight POSIX: Ring Wraps") {
+    ulog_output_id rec = ulog_flight_posix_open(ULOG_LEVEL_TRACE, &config);
+    REQUIRE(rec != ULOG_OUTPUT_INVALID);
+
+    const int total = ULOG_FLIGHT_POSIX_SLOTS + 100;
+    for (int i = 0; i < total; i++) {
+        ulog_debug("Line %d", i);
+    }
+    std::string content = dump_content();
+    CHECK(count_lines(content) == ULOG_FLIGHT_POSIX_SLOTS);
+    CHECK(content.find("Line 99\n") == std::string::npos);
+    CHECK(content.find("Line 100\n") != std::string::npos);
+
+    // The newest lines are the end of the file output
+    std::string expected = ut_read_stream(text);
+    CHECK(expected.compare(expected.size() - content.size(), content.size(),
+                           content) == 0);
+
+    // Longer than a slot: truncated, the line break is kept
+    CHECK(ftruncate(fileno(dump), 0) == 0);
+    std::string long_str(1000, 'x');
+    ulog_info("%s", long_str.c_str());
+    content = dump_content();
+    CHECK(content.size() > ULOG_FLIGHT_POSIX_SLOT_SIZE);
+    size_t last = content.rfind('\n', content.size() - 2) + 1;
+    CHECK(content.size() - last == ULOG_FLIGHT_POSIX_SLOT_SIZE - 1);
+    CHECK(content.back() == '\n');
+
+    CHECK(ulog_flight_posix_close(rec) == ULOG_STATUS_OK);
+    CHECK(ulog_flight_posix_dump(-1) == ULOG_STATUS_ERROR);
+}
+
+TEST_CASE_FIXTURE(FlightPosixTestFixture, "Flight POSIX: Concurrent Lines") {
+    ulog_output_id rec = ulog_flight_posix_open(ULOG_LEVEL_TRACE, &config);
+    REQUIRE(rec != ULOG_OUTPUT_INVALID);
+    ulog_output_remove(text_output);
+    // Rendering needs the logging lock, the ring does not. The lock stays set
+    static std::mutex mutex;
+    ulog_lock_set_fn(
+        [](bool lock, void *arg) {
+            auto *m = static_cast<std::mutex *>(arg);
+            lock ? m->lock() : m->unlock();
+            return ULOG_STATUS_OK;
+        },
+        &mutex);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 1000; i++) {
+                ulog_trace("Thread %d line %d end", t, i);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // Every slot holds one complete line
+    std::string content = dump_content();
+    CHECK(count_lines(content) == ULOG_FLIGHT_POSIX_SLOTS);
+    size_t start = 0;
+    while (start < content.size()) {
+        size_t end = content.find('\n', start);
+        REQUIRE(end != std::string::npos);
+        CHECK(content.compare(end - 4, 4, " end") == 0);
+        start = end + 1;
+    }
+    CHECK(ulog_flight_posix_close(rec) == ULOG_STATUS_OK);
+}
+
+TEST_CASE_FIXTURE(FlightPosixTestFixture, "Flight POSIX: Dump On Fatal") {
+    config.dump_on_fatal = true;
+    ulog_output_id rec   = ulog_flight_posix_open(ULOG_LEVEL_TRACE, &config);
+    REQUIRE(rec != ULOG_OUTPUT_INVALID);
+
+    ulog_trace("Detail before the failure");
+    ulog_error("Not fatal");
+    CHECK(ut_read_stream(dump).empty());
+    ulog_fatal("Fatal");
+    CHECK(ut_read_stream(dump) == ut_read_stream(text));
+
+    CHECK(ulog_flight_posix_close(rec) == ULOG_STATUS_OK);
+}
+
+TEST_CASE_FIXTURE(FlightPosixTestFixture, "Flight POSIX: Dump On Signal") {
+    struct sigaction before;
+    REQUIRE(sigaction(SIGSEGV, nullptr, &before) == 0);
+
+    for (int sig : {SIGABRT, SIGSEGV}) {
+        CAPTURE(sig);
+        CHECK(ftruncate(fileno(dump), 0) == 0);
+        fflush(nullptr);  // Nothing buffered is written twice by the child
+        pid_t child = fork();
+        REQUIRE(child >= 0);
+        if (child == 0) {
+            ulog_output_remove(text_output);  // The file offset is shared
+            signal(sig, SIG_DFL);  // Not the crash report of the test runner
+            config.dump_on_signal = true;
+            if (ulog_flight_posix_open(ULOG_LEVEL_TRACE, &config) !=
+                ULOG_OUTPUT_INVALID) {
+                ulog_trace("Last trace before the crash");
+                raise(sig);
+            }
+            _exit(0);
+        }
+        int wstatus = 0;
+        REQUIRE(waitpid(child, &wstatus, 0) == child);
+        CHECK_FALSE((WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0));
+        CHECK(ut_read_stream(dump).find("Last trace before the crash\n") !=
+              std::string::npos);
+    }
+
+    // Handlers are restored on close
+    config.dump_on_signal = true;
+    ulog_output_id rec    = ulog_flight_posix_open(ULOG_LEVEL_TRACE, &config);
+    REQUIRE(rec != ULOG_OUTPUT_INVALID);
+    struct sigaction installed;
+    REQUIRE(sigaction(SIGSEGV, nullptr, &installed) == 0);
+    CHECK(installed.sa_handler != before.sa_handler);
+    CHECK(ulog_flight_posix_close(rec) == ULOG_STATUS_OK);
+    struct sigaction after;
+    REQUIRE(sigaction(SIGSEGV, nullptr, &after) == 0);
+    CHECK(after.sa_handler == before.sa_handler);
+}
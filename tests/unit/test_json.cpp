@@ -0,0 +1,136 @@
+//  unit tests for the JSON output
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+extern "C" {
+#include "ulog.h"
+}
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "ut_file.hpp"
+
+struct JsonTestFixture {
+    FILE *file = nullptr;
+
+    JsonTestFixture() {
+        ulog_cleanup();
+        ulog_output_level_set_all(ULOG_LEVEL_TRACE);
+        ulog_output_level_set(ULOG_OUTPUT_STDOUT, ULOG_LEVEL_FATAL);
+        ulog_time_config(false);
+        ulog_source_location_config(false);
+        file = tmpfile();
+        REQUIRE(file != nullptr);
+        REQUIRE(ulog_output_add_json_file(file, ULOG_LEVEL_TRACE) !=
+                ULOG_OUTPUT_INVALID);
+    }
+
+    ~JsonTestFixture() {
+        ulog_cleanup();
+        fclose(file);
+    }
+
+    /// @brief Returns the file content and empties the file
+    std::string take() {
+        std::string content = ut_read_stream(file);
+        file = freopen(nullptr, "w+", file);
+        REQUIRE(file != nullptr);
+        return content;
+    }
+};
+
+TEST_CASE_FIXTURE(JsonTestFixture, "JSON: Fields") {
+    ulog_info("Hello %s %d", "world", 42);
+    CHECK(take() == "{\"level\":\"INFO\",\"message\":\"Hello world 42\"}\n");
+
+    ulog_topic_add("net", ULOG_OUTPUT_ALL, ULOG_LEVEL_TRACE);
+    ulog_t_warn("net", "down");
+    CHECK(take() ==
+          "{\"level\":\"WARN\",\"topic\":\"net\",\"message\":\"down\"}\n");
+
+    ulog_source_location_config(true);
+    ulog_error("located");
+    std::string line = take();
+    CHECK(line.find("\"file\":\"") != std::string::npos);
+    CHECK(line.find("test_json.cpp\",\"line\":") != std::string::npos);
+
+    ulog_source_location_config(false);
+    ulog_time_config(true);
+    ulog_debug("timed");
+    line = take();
+    CHECK(line.rfind("{\"time\":\"", 0) == 0);
+    CHECK(line.find("\",\"level\":\"DEBUG\",\"message\":\"timed\"}\n") !=
+          std::string::npos);
+}
+
+TEST_CASE_FIXTURE(JsonTestFixture, "JSON: Escaping") {
+    ulog_info("quote \" backslash \\ tab \t newline \n bell \a end");
+    CHECK(take() == "{\"level\":\"INFO\",\"message\":\"quote \\\" backslash "
+                    "\\\\ tab \\t newline \\n bell \\u0007 end\"}\n");
+
+    // Long enough for the 16-byte scan, with escapes at each position
+    for (size_t pos = 0; pos < 40; pos++) {
+        std::string text(40, 'x');
+        std::string expected = text;
+        text[pos]            = '"';
+        expected.replace(pos, 1, "\\\"");
+        text += "\x1f\xc3\xa9";  // Control character, then UTF-8 as is
+        expected += "\\u001f\xc3\xa9";
+        ulog_info("%s", text.c_str());
+        CHECK(take() == "{\"level\":\"INFO\",\"message\":\"" + expected +
+                            "\"}\n");
+    }
+}
+
+TEST_CASE_FIXTURE(JsonTestFixture, "JSON: Key-Value Fields") {
+    ulog_kv_info(NULL, "request", ULOG_KV_STR("path", "/a \"b\""),
+                 ULOG_KV_INT("status", -1), ULOG_KV_UINT("bytes", 10),
+                 ULOG_KV_BOOL("ok", false), ULOG_KV_DOUBLE("ms", 0.5));
+    CHECK(take() == "{\"level\":\"INFO\",\"message\":\"request\","
+                    "\"path\":\"/a \\\"b\\\"\",\"status\":-1,\"bytes\":10,"
+                    "\"ok\":false,\"ms\":0.5}\n");
+}
+
+TEST_CASE_FIXTURE(JsonTestFixture, "JSON: Long Messages") {
+    std::string text(1000, 'y');
+    const char *null_str = nullptr;
+    ulog_info("a\"%s|%5d|%.2f|%s", text.c_str(), 42, 0.5, null_str);
+    CHECK(take() == "{\"level\":\"INFO\",\"message\":\"a\\\"" + text +
+                        "|   42|0.50|(null)\"}\n");
+
+    // Text messages, escaped as they are
+    text += "\n";
+    ulog_callsite cs = ULOG_CALLSITE_INIT;
+    ulog_log_message(&cs, ULOG_LEVEL_INFO, nullptr, 0, nullptr, text.c_str(),
+                     text.size());
+    CHECK(take() == "{\"level\":\"INFO\",\"message\":\"" +
+                        text.substr(0, 1000) + "\\n\"}\n");
+}
+
+TEST_CASE_FIXTURE(JsonTestFixture, "JSON: Truncated UTF-8") {
+    // Formats with a conversion of unknown argument type are truncated, the
+    // cut falls in the middle of the last character
+    for (const char *ch : {"\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80"}) {
+        std::string text(510, 'y');
+        text += ch;
+        ulog_info("%ls%s", L"", text.c_str());
+        std::string line = take();
+        CHECK(line.find(std::string(510, 'y') + "\"}\n") != std::string::npos);
+    }
+
+    // A whole character before the cut is kept
+    std::string text(509, 'y');
+    text += "\xc3\xa9zz";
+    ulog_info("%ls%s", L"", text.c_str());
+    CHECK(take().find("y\xc3\xa9\"}\n") != std::string::npos);
+}
+
+TEST_CASE_FIXTURE(JsonTestFixture, "JSON: Longer Than The Line Buffer") {
+    std::string text(300, '\x01');  // 6 characters each when escaped
+    ulog_info("%s", text.c_str());
+    std::string line = take();
+    CHECK(line.size() > 1024);
+    CHECK(line.rfind("{\"level\":\"INFO\",\"message\":\"\\u0001", 0) == 0);
+    CHECK(line.compare(line.size() - 9, 9, "\\u0001\"}\n") == 0);
+}
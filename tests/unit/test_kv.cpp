@@ -0,0 +1,161 @@
+//  unit tests for key-value fields
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+extern "C" {
+#include "ulog.h"
+#include "ut_callback.h"
+}
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct KvTestFixture {
+    KvTestFixture() {
+        ulog_cleanup();
+        ut_callback_reset();
+        ulog_output_level_set_all(ULOG_LEVEL_TRACE);
+        ulog_output_add(ut_callback, nullptr, ULOG_LEVEL_TRACE);
+    }
+
+    ~KvTestFixture() {
+        ulog_cleanup();
+    }
+};
+
+/// @brief Fields seen by the handler, as "key:type:value"
+static std::vector<std::string> seen_fields;
+
+static void fields_handler(ulog_event *ev, void *arg) {
+    (void)arg;
+    seen_fields.clear();
+    for (size_t i = 0; i < ulog_event_get_kv_count(ev); i++) {
+        const ulog_kv *kv = ulog_event_get_kv(ev, i);
+        std::string value;
+        switch (kv->type) {
+            case ULOG_KV_TYPE_INT:
+                value = std::to_string(kv->value.i);
+                break;
+            case ULOG_KV_TYPE_UINT:
+                value = std::to_string(kv->value.u);
+                break;
+            case ULOG_KV_TYPE_DOUBLE:
+                value = std::to_string(kv->value.d);
+                break;
+            case ULOG_KV_TYPE_BOOL:
+                value = kv->value.b ? "true" : "false";
+                break;
+            case ULOG_KV_TYPE_STR:
+                value = kv->value.s;
+                break;
+        }
+        seen_fields.push_back(std::string(kv->key) + ":" +
+                              std::to_string(kv->type) + ":" + value);
+    }
+    CHECK(ulog_event_get_kv(ev, ulog_event_get_kv_count(ev)) == nullptr);
+}
+
+TEST_CASE_FIXTURE(KvTestFixture, "Fields are rendered after the message") {
+    const char *path = "/index.html";
+    ulog_kv_info(NULL, "request done", ULOG_KV_INT("status", 200),
+                 ULOG_KV_STR("path", path), ULOG_KV_DOUBLE("ms", 1.5),
+                 ULOG_KV_BOOL("cached", false));
+
+    CHECK(ut_callback_get_message_count() == 1);
+    CHECK(strstr(ut_callback_get_last_message(),
+                 "request done status=200 path=/index.html ms=1.5 "
+                 "cached=false") != nullptr);
+}
+
+TEST_CASE_FIXTURE(KvTestFixture, "Strings are quoted when needed") {
+    ulog_kv_warn(NULL, "quoting", ULOG_KV_STR("a", "two words"),
+                 ULOG_KV_STR("b", ""), ULOG_KV_STR("c", "say \"hi\"\n"),
+                 ULOG_KV_STR("d", NULL));
+    CHECK(strstr(ut_callback_get_last_message(),
+                 "quoting a=\"two words\" b=\"\" c=\"say \\\"hi\\\"\\n\" "
+                 "d=NULL") != nullptr);
+}
+
+TEST_CASE_FIXTURE(KvTestFixture, "Control characters are escaped") {
+    ulog_kv_info(NULL, "control", ULOG_KV_STR("a", "bell\a"),
+                 ULOG_KV_STR("b", "esc\x1b[0m\x7f"));
+    CHECK(strstr(ut_callback_get_last_message(),
+                 "control a=\"bell\\x07\" b=\"esc\\x1b[0m\\x7f\"") !=
+          nullptr);
+}
+
+TEST_CASE_FIXTURE(KvTestFixture, "Keys are quoted when needed") {
+    ulog_kv_info(NULL, "keys", ULOG_KV_INT("a b", 1), ULOG_KV_INT("c=d", 2),
+                 ULOG_KV_INT("", 3), ULOG_KV_INT("e\n", 4));
+    CHECK(strstr(ut_callback_get_last_message(),
+                 "keys \"a b\"=1 \"c=d\"=2 \"\"=3 \"e\\n\"=4") != nullptr);
+}
+
+TEST_CASE_FIXTURE(KvTestFixture, "Doubles read back to the same value") {
+    double third = 1.0 / 3.0;
+    ulog_kv_info(NULL, "doubles", ULOG_KV_DOUBLE("short", 0.1),
+                 ULOG_KV_DOUBLE("third", third),
+                 ULOG_KV_DOUBLE("big", 123456789012.5));
+    const char *msg = strstr(ut_callback_get_last_message(), "doubles");
+    REQUIRE(msg != nullptr);
+    CHECK(strstr(msg, " short=0.1 ") != nullptr);
+    CHECK(strstr(msg, " big=123456789012.5") != nullptr);
+
+    const char *value = strstr(msg, "third=");
+    REQUIRE(value != nullptr);
+    CHECK(strtod(value + strlen("third="), nullptr) == third);
+}
+
+TEST_CASE_FIXTURE(KvTestFixture, "Message is not a format") {
+    ulog_kv_info(NULL, "100% done", ULOG_KV_UINT("n", 18446744073709551615u));
+    CHECK(strstr(ut_callback_get_last_message(),
+                 "100% done n=18446744073709551615") != nullptr);
+}
+
+TEST_CASE_FIXTURE(KvTestFixture, "Handlers get typed fields") {
+    ulog_output_id output = ulog_output_add(fields_handler, nullptr,
+                                            ULOG_LEVEL_TRACE);
+    ulog_kv_error(NULL, "typed", ULOG_KV_INT("i", -5), ULOG_KV_UINT("u", 7u),
+                  ULOG_KV_BOOL("b", true), ULOG_KV_STR("s", "text"));
+
+    REQUIRE(seen_fields.size() == 4);
+    CHECK(seen_fields[0] == "i:0:-5");
+    CHECK(seen_fields[1] == "u:1:7");
+    CHECK(seen_fields[2] == "b:3:true");
+    CHECK(seen_fields[3] == "s:4:text");
+    ulog_output_remove(output);
+}
+
+TEST_CASE_FIXTURE(KvTestFixture, "Fields beyond the limit are ignored") {
+    // ULOG_BUILD_KV_FIELDS=4
+    ulog_kv_info(NULL, "many", ULOG_KV_INT("f1", 1), ULOG_KV_INT("f2", 2),
+                 ULOG_KV_INT("f3", 3), ULOG_KV_INT("f4", 4),
+                 ULOG_KV_INT("f5", 5));
+    CHECK(strstr(ut_callback_get_last_message(), "f4=4") != nullptr);
+    CHECK(strstr(ut_callback_get_last_message(), "f5") == nullptr);
+}
+
+TEST_CASE_FIXTURE(KvTestFixture, "Topics and levels filter the message") {
+    ulog_topic_add("net", ULOG_OUTPUT_ALL, ULOG_LEVEL_WARN);
+
+    int evaluated = 0;
+    ulog_kv_info("net", "filtered", ULOG_KV_INT("n", ++evaluated));
+    CHECK(ut_callback_get_message_count() == 0);
+    CHECK(evaluated == 0);  // Fields of filtered messages are not evaluated
+
+    ulog_kv_warn("net", "passed", ULOG_KV_INT("n", ++evaluated));
+    CHECK(ut_callback_get_message_count() == 1);
+    CHECK(strstr(ut_callback_get_last_message(), "[net]") != nullptr);
+    CHECK(strstr(ut_callback_get_last_message(), "passed n=1") != nullptr);
+}
+
+TEST_CASE_FIXTURE(KvTestFixture, "Other messages have no fields") {
+    ulog_output_id output = ulog_output_add(fields_handler, nullptr,
+                                            ULOG_LEVEL_TRACE);
+    seen_fields.push_back("stale");
+    ulog_info("No fields %d", 1);
+    CHECK(seen_fields.empty());
+    ulog_output_remove(output);
+}
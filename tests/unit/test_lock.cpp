@@ -83,3 +83,17 @@ TEST_CASE_FIXTURE(LockingTestFixture, "Reentrancy: prefix + output nesting") {
     REQUIRE(last != nullptr);
     CHECK(strstr(last, "Nested from output") == nullptr);
 }
+
+TEST_CASE_FIXTURE(LockingTestFixture, "Level pre-filter skips the lock") {
+    ulog_output_level_set_all(ULOG_LEVEL_INFO);
+    lock_events.clear();
+
+    ulog_trace("Filtered trace");
+    ulog_debug("Filtered debug");
+    CHECK(lock_events.empty());
+
+    ulog_info("Accepted info");
+    CHECK(std::count(lock_events.begin(), lock_events.end(), "lock") >= 1);
+
+    ulog_output_level_set_all(ULOG_LEVEL_TRACE);
+}
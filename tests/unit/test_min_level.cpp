@@ -0,0 +1,62 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <cstring>
+#include "ulog.h"
+#include "ut_callback.h"
+
+// Built with ULOG_BUILD_MIN_LEVEL=ULOG_LEVEL_INFO (directly or through the
+// configuration header). TRACE and DEBUG macros must be compiled out.
+
+static int side_effect_counter = 0;
+
+static int side_effect() {
+    return ++side_effect_counter;
+}
+
+struct TestFixture {
+  public:
+    TestFixture() {
+        ulog_cleanup();
+        ulog_output_add(ut_callback, nullptr, ULOG_LEVEL_TRACE);
+        ulog_output_level_set_all(ULOG_LEVEL_TRACE);
+        ut_callback_reset();
+        side_effect_counter = 0;
+    }
+
+    ~TestFixture() {
+        ulog_cleanup();
+    }
+};
+
+TEST_CASE_FIXTURE(TestFixture, "Min Level - Lower levels are stripped") {
+    CHECK(!ULOG_LEVEL_IS_BUILT(ULOG_LEVEL_TRACE));
+    CHECK(!ULOG_LEVEL_IS_BUILT(ULOG_LEVEL_DEBUG));
+    CHECK(ULOG_LEVEL_IS_BUILT(ULOG_LEVEL_INFO));
+
+    ulog_trace("Trace %d", side_effect());
+    ulog_debug("Debug %d", side_effect());
+    ulog(ULOG_LEVEL_DEBUG, "Generic debug %d", side_effect());
+
+    CHECK(side_effect_counter == 0);  // Arguments are not evaluated
+    CHECK(ut_callback_get_message_count() == 0);
+}
+
+TEST_CASE_FIXTURE(TestFixture, "Min Level - Higher levels are logged") {
+    ulog_info("Info %d", side_effect());
+    ulog_warn("Warn %d", side_effect());
+    ulog(ULOG_LEVEL_ERROR, "Generic error %d", side_effect());
+
+    CHECK(side_effect_counter == 3);
+    CHECK(ut_callback_get_message_count() == 3);
+    CHECK(strstr(ut_callback_get_last_message(), "Generic error 3") !=
+          nullptr);
+}
+
+TEST_CASE_FIXTURE(TestFixture, "Min Level - Direct calls are filtered") {
+    ulog_log(ULOG_LEVEL_DEBUG, __FILE__, __LINE__, NULL, "Direct debug");
+    CHECK(ut_callback_get_message_count() == 0);
+
+    ulog_log(ULOG_LEVEL_INFO, __FILE__, __LINE__, NULL, "Direct info");
+    CHECK(ut_callback_get_message_count() == 1);
+}
@@ -0,0 +1,262 @@
+//  unit tests for the memory mapped segment output extension
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+extern "C" {
+#include "ulog.h"
+#include "ulog_mmap_posix.h"
+}
+
+#include <fcntl.h>
+#include <glob.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "ut_file.hpp"
+
+struct MmapPosixTestFixture {
+    char dir[32] = "/tmp/ulog_mmap_posix_XXXXXX";
+    std::string prefix;
+    FILE *text = nullptr;  // ulog_output_add_file() for the reference
+    ulog_output_id text_output = ULOG_OUTPUT_INVALID;
+
+    MmapPosixTestFixture() {
+        ulog_cleanup();
+        ulog_output_level_set_all(ULOG_LEVEL_TRACE);
+        ulog_output_level_set(ULOG_OUTPUT_STDOUT, ULOG_LEVEL_FATAL);
+        REQUIRE(mkdtemp(dir) != nullptr);
+        prefix = std::string(dir) + "/app";
+        text   = tmpfile();
+        REQUIRE(text != nullptr);
+        text_output = ulog_output_add_file(text, ULOG_LEVEL_TRACE);
+        REQUIRE(text_output != ULOG_OUTPUT_INVALID);
+    }
+
+    ~MmapPosixTestFixture() {
+        ulog_cleanup();
+        fclose(text);
+        for (const std::string &segment : segments()) {
+            unlink(segment.c_str());
+        }
+        rmdir(dir);
+    }
+
+    /// @brief Segment files, in name order
+    std::vector<std::string> segments() {
+        std::vector<std::string> names;
+        glob_t found;
+        std::string pattern = prefix + ".*.seg";
+        if (glob(pattern.c_str(), 0, nullptr, &found) == 0) {
+            names.assign(found.gl_pathv, found.gl_pathv + found.gl_pathc);
+        }
+        globfree(&found);
+        return names;
+    }
+
+    /// @brief Returns the lines of the segment as read by the extension
+    static std::string read_segment(const std::string &segment, bool recover,
+                                    ulog_mmap_posix_info *info) {
+        FILE *out = tmpfile();
+        REQUIRE(out != nullptr);
+        CHECK(ulog_mmap_posix_read(segment.c_str(), out, recover, info) ==
+              ULOG_STATUS_OK);
+        std::string content = ut_read_stream(out);
+        fclose(out);
+        return content;
+    }
+
+    /// @brief Returns the text written by the reference file output
+    std::string text_content() {
+        return ut_read_stream(text);
+    }
+};
+
+TEST_CASE_FIXTURE(MmapPosixTestFixture, "Mmap POSIX: Committed Lines") {
+    ulog_output_id out =
+        ulog_mmap_posix_open(prefix.c_str(), 1 << 16, ULOG_LEVEL_TRACE);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+    REQUIRE(segments().size() == 1);
+    std::string segment = segments()[0];
+    CHECK(segment == prefix + ".000000.seg");
+
+    // Readable while the output is open, same text as the file output
+    ulog_info("Hello %s %d", "world", 42);
+    ulog_debug("Second line");
+    ulog_mmap_posix_info info;
+    CHECK(read_segment(segment, false, &info) == text_content());
+    CHECK(info.sequence == 0);
+    CHECK(info.committed == text_content().size());
+    CHECK(info.recovered == 0);
+    CHECK_FALSE(info.closed);
+
+    ulog_warn("Third line %f", 1.5);
+    CHECK(ulog_mmap_posix_close(out) == ULOG_STATUS_OK);
+    CHECK(ulog_mmap_posix_close(out) == ULOG_STATUS_NOT_FOUND);
+    CHECK(read_segment(segment, true, &info) == text_content());
+    CHECK(info.closed);
+
+    // Trimmed to the header and the lines
+    struct stat st;
+    REQUIRE(stat(segment.c_str(), &st) == 0);
+    CHECK((size_t)st.st_size == 64 + text_content().size());
+
+    // A new output continues with the next unused number
+    out = ulog_mmap_posix_open(prefix.c_str(), 1 << 16, ULOG_LEVEL_TRACE);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+    CHECK(ulog_mmap_posix_close(out) == ULOG_STATUS_OK);
+    REQUIRE(segments().size() == 2);
+    CHECK(segments()[1] == prefix + ".000001.seg");
+}
+
+TEST_CASE_FIXTURE(MmapPosixTestFixture, "Mmap POSIX: Next Segment") {
+    ulog_output_id out =
+        ulog_mmap_posix_open(prefix.c_str(), 1, ULOG_LEVEL_TRACE);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+
+    for (int i = 0; i < 500; i++) {
+        ulog_info("Line %d of many, %s", i, "long enough to fill segments");
+    }
+    // Longer than a segment: truncated, the line break is kept
+    std::string long_str(3 * 4096, 'x');
+    ulog_info("%s", long_str.c_str());
+    ulog_info("After the long line");
+    CHECK(ulog_mmap_posix_close(out) == ULOG_STATUS_OK);
+
+    std::vector<std::string> names = segments();
+    CHECK(names.size() > 2);
+    std::string content;
+    ulog_mmap_posix_info info;
+    for (size_t i = 0; i < names.size(); i++) {
+        content += read_segment(names[i], false, &info);
+        CHECK(info.sequence == i);
+        CHECK(info.closed);
+    }
+
+    // All lines up to the long one are the same, each segment holds whole
+    // lines only
+    std::string expected = text_content();
+    size_t long_pos      = expected.find(long_str.substr(0, 64));
+    REQUIRE(long_pos != std::string::npos);
+    size_t line_start = expected.rfind('\n', long_pos) + 1;
+    CHECK(content.compare(0, line_start, expected, 0, line_start) == 0);
+    CHECK(content.back() == '\n');
+    CHECK(content.find("After the long line") != std::string::npos);
+    CHECK(content.size() < expected.size());
+}
+
+TEST_CASE_FIXTURE(MmapPosixTestFixture, "Mmap POSIX: Next Segment Ahead") {
+    ulog_output_id out =
+        ulog_mmap_posix_open(prefix.c_str(), 1, ULOG_LEVEL_TRACE);
+    REQUIRE(out != ULOG_OUTPUT_INVALID);
+
+    // Past half of the segment (two pages) the worker creates the next one
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    while (text_content().size() < 2 * page * 3 / 4) {
+        ulog_info("Filling the first half of the segment");
+    }
+    for (int i = 0; i < 1000 && segments().size() < 2; i++) {
+        usleep(1000);
+    }
+    REQUIRE(segments().size() == 2);
+    ulog_mmap_posix_info info;
+    CHECK(read_segment(segments()[1], false, &info) == "");
+    CHECK(info.sequence == 1);
+    CHECK_FALSE(info.closed);
+
+    // Not used before the output is closed: removed
+    CHECK(ulog_mmap_posix_close(out) == ULOG_STATUS_OK);
+    REQUIRE(segments().size() == 1);
+    CHECK(read_segment(segments()[0], false, &info) == text_content());
+    CHECK(info.closed);
+}
+
+TEST_CASE_FIXTURE(MmapPosixTestFixture, "Mmap POSIX: Killed Process") {
+    fflush(nullptr);  // Nothing buffered is written twice by the child
+    pid_t child = fork();
+    REQUIRE(child >= 0);
+    if (child == 0) {
+        ulog_output_remove(text_output);  // The file offset is shared
+        ulog_output_id out =
+            ulog_mmap_posix_open(prefix.c_str(), 1 << 16, ULOG_LEVEL_TRACE);
+        for (int i = 0; i < 100 && out != ULOG_OUTPUT_INVALID; i++) {
+            ulog_info("Line %d before the crash", i);
+        }
+        raise(SIGKILL);  // No close, no exit handlers
+    }
+    int wstatus = 0;
+    REQUIRE(waitpid(child, &wstatus, 0) == child);
+    CHECK(WIFSIGNALED(wstatus));
+    REQUIRE(segments().size() == 1);
+    std::string segment = segments()[0];
+
+    ulog_mmap_posix_info info;
+    std::string content = read_segment(segment, false, &info);
+    CHECK_FALSE(info.closed);
+    CHECK(info.committed == content.size());
+    CHECK(content.find("Line 0 before the crash\n") != std::string::npos);
+    CHECK(content.find("Line 99 before the crash\n") != std::string::npos);
+
+    // Simulate a crash between writing a line and its commit
+    int fd = open(segment.c_str(), O_WRONLY);
+    REQUIRE(fd >= 0);
+    const char extra[] = "Not committed\nUnterminated";
+    CHECK(pwrite(fd, extra, strlen(extra), (off_t)(64 + info.committed)) ==
+          (ssize_t)strlen(extra));
+    close(fd);
+
+    CHECK(read_segment(segment, false, &info) == content);
+    CHECK(info.recovered == 0);
+    CHECK(read_segment(segment, true, &info) == content + "Not committed\n");
+    CHECK(info.recovered == strlen("Not committed\n"));
+}
+
+TEST_CASE_FIXTURE(MmapPosixTestFixture, "Mmap POSIX: Invalid Arguments") {
+    CHECK(ulog_mmap_posix_open(nullptr, 4096, ULOG_LEVEL_TRACE) ==
+          ULOG_OUTPUT_INVALID);
+    CHECK(ulog_mmap_posix_open("/nonexistent/dir/app", 4096,
+                               ULOG_LEVEL_TRACE) == ULOG_OUTPUT_INVALID);
+    std::string long_prefix(600, 'p');
+    CHECK(ulog_mmap_posix_open(long_prefix.c_str(), 4096, ULOG_LEVEL_TRACE) ==
+          ULOG_OUTPUT_INVALID);
+    CHECK(ulog_mmap_posix_close(ULOG_OUTPUT_INVALID) == ULOG_STATUS_NOT_FOUND);
+    CHECK(ulog_mmap_posix_close(ULOG_OUTPUT_STDOUT) == ULOG_STATUS_NOT_FOUND);
+
+    // Limited number of outputs, a closed one frees its slot
+    ulog_output_id outs[ULOG_MMAP_POSIX_NUM];
+    for (auto &out : outs) {
+        out = ulog_mmap_posix_open(prefix.c_str(), 4096, ULOG_LEVEL_TRACE);
+        REQUIRE(out != ULOG_OUTPUT_INVALID);
+    }
+    CHECK(ulog_mmap_posix_open(prefix.c_str(), 4096, ULOG_LEVEL_TRACE) ==
+          ULOG_OUTPUT_INVALID);
+    CHECK(ulog_mmap_posix_close(outs[0]) == ULOG_STATUS_OK);
+    outs[0] = ulog_mmap_posix_open(prefix.c_str(), 4096, ULOG_LEVEL_TRACE);
+    CHECK(outs[0] != ULOG_OUTPUT_INVALID);
+    for (auto &out : outs) {
+        CHECK(ulog_mmap_posix_close(out) == ULOG_STATUS_OK);
+    }
+
+    // Not segment files
+    FILE *sink = tmpfile();
+    REQUIRE(sink != nullptr);
+    CHECK(ulog_mmap_posix_read(nullptr, sink, false, nullptr) ==
+          ULOG_STATUS_INVALID_ARGUMENT);
+    CHECK(ulog_mmap_posix_read(dir, nullptr, false, nullptr) ==
+          ULOG_STATUS_INVALID_ARGUMENT);
+    CHECK(ulog_mmap_posix_read("/nonexistent/file.seg", sink, false,
+                               nullptr) == ULOG_STATUS_ERROR);
+    std::string other = prefix + ".000099.seg";
+    FILE *file        = fopen(other.c_str(), "w");
+    REQUIRE(file != nullptr);
+    fprintf(file, "%s\n", std::string(100, 'a').c_str());
+    fclose(file);
+    CHECK(ulog_mmap_posix_read(other.c_str(), sink, true, nullptr) ==
+          ULOG_STATUS_ERROR);
+    fclose(sink);
+}
@@ -10,6 +10,7 @@ extern "C" {
 #include <cstdio>
 #include <cstring>
 #include <memory>
+#include <string>
 
 // Custom test output handler for testing
 static int custom_callback_count = 0;
@@ -247,6 +248,157 @@ TEST_CASE_FIXTURE(OutputTestFixture, "Output Add File") {
     }
 }
 
+TEST_CASE_FIXTURE(OutputTestFixture, "Output Fan-out To Files") {
+    const int NUM_FILES = 3;
+    FILE *files[NUM_FILES];
+    for (int i = 0; i < NUM_FILES; i++) {
+        files[i] = tmpfile();
+        REQUIRE(files[i] != nullptr);
+        REQUIRE(ulog_output_add_file(files[i], ULOG_LEVEL_TRACE) !=
+                ULOG_OUTPUT_INVALID);
+    }
+    ulog_output_add(custom_test_output_handler, nullptr, ULOG_LEVEL_TRACE);
+
+    std::string long_message(400, 'x');  // Longer than a cached line
+    ulog_info("Shared line %d", 42);
+    ulog_warn("%s", long_message.c_str());
+
+    std::string contents[NUM_FILES];
+    for (int i = 0; i < NUM_FILES; i++) {
+        fflush(files[i]);
+        rewind(files[i]);
+        char buffer[1024];
+        while (fgets(buffer, sizeof(buffer), files[i]) != nullptr) {
+            contents[i] += buffer;
+        }
+        fclose(files[i]);
+    }
+
+    CHECK(contents[0].find("Shared line 42\n") != std::string::npos);
+    CHECK(contents[0].find(long_message + "\n") != std::string::npos);
+    CHECK(contents[1] == contents[0]);
+    CHECK(contents[2] == contents[0]);
+    CHECK(custom_callback_count == 2);
+    CHECK(strstr(custom_callback_last_message, "xxxx") != nullptr);
+    ulog_cleanup();
+}
+
+TEST_CASE_FIXTURE(OutputTestFixture, "Output Line Styles Beyond Cache") {
+    // stdout, the user handler (to_cstr) and the file take 3 line styles
+    ulog_output_add(custom_test_output_handler, nullptr, ULOG_LEVEL_TRACE);
+    FILE *file = tmpfile();
+    REQUIRE(file != nullptr);
+    REQUIRE(ulog_output_add_file(file, ULOG_LEVEL_TRACE) != ULOG_OUTPUT_INVALID);
+
+    ulog_info("Three styles %d", 3);
+
+    fflush(file);
+    rewind(file);
+    char buffer[256];
+    REQUIRE(fgets(buffer, sizeof(buffer), file) != nullptr);
+    CHECK(strstr(buffer, "INFO") != nullptr);
+    CHECK(strstr(buffer, "Three styles 3\n") != nullptr);
+    CHECK(strstr(custom_callback_last_message, "Three styles 3") != nullptr);
+    CHECK(strchr(custom_callback_last_message, '\n') == nullptr);
+    fclose(file);
+    ulog_cleanup();
+}
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+/// @brief Unbuffered stream that counts the writes reaching it
+struct CountingStream {
+    int writes = 0;
+    std::string data;
+};
+
+#if defined(__GLIBC__)
+static ssize_t counting_write(void *cookie, const char *buf, size_t size) {
+#else
+static int counting_write(void *cookie, const char *buf, int size) {
+#endif
+    auto *stream = static_cast<CountingStream *>(cookie);
+    stream->writes++;
+    stream->data.append(buf, (size_t)size);
+    return size;
+}
+
+static FILE *counting_open(CountingStream *stream) {
+#if defined(__GLIBC__)
+    cookie_io_functions_t io = {nullptr, counting_write, nullptr, nullptr};
+    FILE *file               = fopencookie(stream, "w", io);
+#else
+    FILE *file = funopen(stream, nullptr, counting_write, nullptr, nullptr);
+#endif
+    REQUIRE(file != nullptr);
+    setvbuf(file, nullptr, _IONBF, 0);  // Each stdio call is a write
+    return file;
+}
+
+TEST_CASE_FIXTURE(OutputTestFixture, "Output File Line In One Write") {
+    CountingStream stream;
+    FILE *file = counting_open(&stream);
+    REQUIRE(ulog_output_add_file(file, ULOG_LEVEL_TRACE) != ULOG_OUTPUT_INVALID);
+
+    ulog_info("First %d", 1);
+    ulog_warn("Second %s", "line");
+    CHECK(stream.writes == 2);
+    CHECK(stream.data.find("First 1\n") != std::string::npos);
+    CHECK(stream.data.find("Second line\n") != std::string::npos);
+
+    // Longer than the line buffer: written in parts, still whole
+    std::string long_message(400, 'x');
+    ulog_info("%s", long_message.c_str());
+    CHECK(stream.writes > 3);
+    CHECK(stream.data.find(long_message + "\n") != std::string::npos);
+
+    ulog_cleanup();
+    fclose(file);
+}
+#endif  // __GLIBC__ || __APPLE__
+
+static char line_handler_line[512];
+static ulog_status line_handler_status;
+
+static void line_test_output_handler(ulog_event *ev, void *arg) {
+    size_t size = arg != nullptr ? *(size_t *)arg : sizeof(line_handler_line);
+    size_t len  = 0;
+    line_handler_status = ulog_event_to_line(ev, line_handler_line, size, &len);
+    CHECK(len == strlen(line_handler_line));
+}
+
+TEST_CASE_FIXTURE(OutputTestFixture, "Output Event To Line") {
+    FILE *file = tmpfile();
+    REQUIRE(file != nullptr);
+    ulog_output_id file_output = ulog_output_add_file(file, ULOG_LEVEL_TRACE);
+    REQUIRE(file_output != ULOG_OUTPUT_INVALID);
+    ulog_output_id output =
+        ulog_output_add(line_test_output_handler, nullptr, ULOG_LEVEL_TRACE);
+    REQUIRE(output != ULOG_OUTPUT_INVALID);
+
+    ulog_info("Same as the file %d", 7);
+
+    fflush(file);
+    rewind(file);
+    char buffer[512];
+    REQUIRE(fgets(buffer, sizeof(buffer), file) != nullptr);
+    CHECK(line_handler_status == ULOG_STATUS_OK);
+    CHECK(strcmp(line_handler_line, buffer) == 0);
+    ulog_output_remove(file_output);
+    fclose(file);
+
+    // Truncated to the buffer
+    static size_t small_size = 8;
+    ulog_output_remove(output);
+    ulog_output_add(line_test_output_handler, &small_size, ULOG_LEVEL_TRACE);
+    ulog_info("Does not fit");
+    CHECK(line_handler_status == ULOG_STATUS_ERROR);
+    CHECK(strlen(line_handler_line) == small_size - 1);
+
+    CHECK(ulog_event_to_line(nullptr, buffer, sizeof(buffer), nullptr) ==
+          ULOG_STATUS_INVALID_ARGUMENT);
+    ulog_cleanup();
+}
+
 TEST_CASE_FIXTURE(OutputTestFixture, "Output Remove") {
     SUBCASE("Remove custom output") {
         ulog_output_id output_id = ulog_output_add(custom_test_output_handler, nullptr, ULOG_LEVEL_TRACE);
@@ -0,0 +1,214 @@
+//  unit tests for the async-signal-safe logging path
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+extern "C" {
+#include "ulog.h"
+}
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+struct SignalSafeTestFixture {
+    int pipe_fds[2] = {-1, -1};
+
+    SignalSafeTestFixture() {
+        ulog_cleanup();
+        ulog_output_level_set(ULOG_OUTPUT_STDOUT, ULOG_LEVEL_FATAL);
+        REQUIRE(pipe(pipe_fds) == 0);
+        REQUIRE(fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK) == 0);
+        REQUIRE(ulog_signal_safe_fd_add(pipe_fds[1], ULOG_LEVEL_TRACE) ==
+                ULOG_STATUS_OK);
+    }
+
+    ~SignalSafeTestFixture() {
+        ulog_cleanup();
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+    }
+
+    /// @brief Returns what was written to the pipe so far
+    std::string read_pipe() {
+        std::string content;
+        char buf[4096];
+        ssize_t n = 0;
+        while ((n = read(pipe_fds[0], buf, sizeof(buf))) > 0) {
+            content.append(buf, (size_t)n);
+        }
+        return content;
+    }
+};
+
+/// @brief Line of an INFO message without location, formatted by the C library
+#define EXPECTED_INFO(buf, ...)                                                \
+    (snprintf(buf, sizeof(buf), __VA_ARGS__), std::string("INFO  ") + buf + "\n")
+
+TEST_CASE_FIXTURE(SignalSafeTestFixture, "Signal Safe: Same As printf") {
+    char buf[256];
+#define CHECK_SAME(...)                                                        \
+    do {                                                                       \
+        ulog_log_signal_safe(ULOG_LEVEL_INFO, NULL, 0, NULL, __VA_ARGS__);     \
+        CHECK(read_pipe() == EXPECTED_INFO(buf, __VA_ARGS__));                 \
+    } while (0)
+
+    CHECK_SAME("Plain text");
+    CHECK_SAME("%d %i %d %d", 0, -42, INT32_MAX, INT32_MIN);
+    CHECK_SAME("%u %x %X", 4000000000u, 0xbeefu, 0xBEEFu);
+    CHECK_SAME("%ld %lu %lld %llu", -1L, 2UL, -3LL, 18446744073709551615ULL);
+    CHECK_SAME("%zu %jd %td", (size_t)7, (intmax_t)-8, (ptrdiff_t)-9);
+    CHECK_SAME("[%5d] [%-5d] [%05d] [%+d] [% d]", 42, 42, -42, 42, 42);
+    CHECK_SAME("[%08x] [%-6X]", 0x1fu, 0xABu);
+    CHECK_SAME("%c%c [%3c]", 'o', 'k', 'x');
+    CHECK_SAME("%s [%8s] [%-8s] [%.2s]", "str", "right", "left", "cut");
+    CHECK_SAME("%f %.0f %.3f %.15f", 1.5, 2.0, -3.14159, 0.1);
+    CHECK_SAME("[%10.2f] [%-10.2f] [%010.2f] [%+.1f]", 3.14159, 3.14159, -3.5,
+               2.75);
+    CHECK_SAME("100%% %d%%", 5);
+    CHECK_SAME("%p", (void *)0x1234);
+#undef CHECK_SAME
+}
+
+TEST_CASE_FIXTURE(SignalSafeTestFixture, "Signal Safe: Unsupported Specs") {
+    // Not formatted, the arguments are skipped
+    ulog_log_signal_safe(ULOG_LEVEL_INFO, NULL, 0, NULL,
+                         "%e [%*d] [%.3d] %hd %Lf %s", 1.5, 4, 7, 8, (short)9,
+                         (long double)1.0, "end");
+    CHECK(read_pipe() == "INFO  %e [%*d] [%.3d] %hd %Lf end\n");
+
+    // Unknown argument type: the rest is copied as it is
+    int count = 0;
+    ulog_log_signal_safe(ULOG_LEVEL_INFO, NULL, 0, NULL, "%d %n %d", 1,
+                         &count, 2);
+    CHECK(read_pipe() == "INFO  1 %n %d\n");
+    CHECK(count == 0);
+
+    // Not exact, but formatted: large values and non-finite ones
+    ulog_log_signal_safe(ULOG_LEVEL_INFO, NULL, 0, NULL, "%.1f %f %f %.20f",
+                         1e15, 1.0 / 0.0, -1.0 / 0.0, 0.5);
+    CHECK(read_pipe() == "INFO  1000000000000000.0 inf -inf %.20f\n");
+}
+
+TEST_CASE_FIXTURE(SignalSafeTestFixture, "Signal Safe: Line") {
+    ulog_log_signal_safe(ULOG_LEVEL_ERROR, "src/f.c", 7, "net", "id %d", 3);
+    CHECK(read_pipe() == "ERROR [net] src/f.c:7: id 3\n");
+
+    ulog_signal_safe_warn("From the macro");
+    std::string line = read_pipe();
+    CHECK(line.rfind("WARN  ", 0) == 0);
+    CHECK(line.find("test_signal_safe.cpp:") != std::string::npos);
+    CHECK(line.find(": From the macro\n") != std::string::npos);
+
+    ulog_log_signal_safe(ULOG_LEVEL_INFO, NULL, 0, NULL, NULL);
+    CHECK(read_pipe() == "INFO  NULL\n");
+    const char *null_str = nullptr;
+    ulog_log_signal_safe(ULOG_LEVEL_INFO, NULL, 0, NULL, "%s", null_str);
+    CHECK(read_pipe() == "INFO  (null)\n");
+
+    // Truncated, the line break is kept
+    std::string long_str(1000, 'x');
+    ulog_log_signal_safe(ULOG_LEVEL_INFO, NULL, 0, NULL, "%s",
+                         long_str.c_str());
+    line = read_pipe();
+    CHECK(line.size() == 255);
+    CHECK(line.back() == '\n');
+}
+
+TEST_CASE_FIXTURE(SignalSafeTestFixture, "Signal Safe: Descriptors") {
+    int other[2];
+    REQUIRE(pipe(other) == 0);
+    REQUIRE(fcntl(other[0], F_SETFL, O_NONBLOCK) == 0);
+    CHECK(ulog_signal_safe_fd_add(other[1], ULOG_LEVEL_ERROR) ==
+          ULOG_STATUS_OK);
+
+    ulog_log_signal_safe(ULOG_LEVEL_INFO, NULL, 0, NULL, "Info");
+    ulog_log_signal_safe(ULOG_LEVEL_ERROR, NULL, 0, NULL, "Error");
+    CHECK(read_pipe() == "INFO  Info\nERROR Error\n");
+    char buf[64] = {0};
+    CHECK(read(other[0], buf, sizeof(buf) - 1) > 0);
+    CHECK(std::string(buf) == "ERROR Error\n");
+
+    // Registering again changes the level
+    CHECK(ulog_signal_safe_fd_add(pipe_fds[1], ULOG_LEVEL_FATAL) ==
+          ULOG_STATUS_OK);
+    ulog_log_signal_safe(ULOG_LEVEL_ERROR, NULL, 0, NULL, "Error");
+    CHECK(read_pipe().empty());
+    CHECK(read(other[0], buf, sizeof(buf) - 1) > 0);
+
+    // ULOG_BUILD_SIGNAL_SAFE descriptors at most
+    CHECK(ulog_signal_safe_fd_add(STDERR_FILENO, ULOG_LEVEL_TRACE) ==
+          ULOG_STATUS_ERROR);
+    CHECK(ulog_signal_safe_fd_add(-1, ULOG_LEVEL_TRACE) ==
+          ULOG_STATUS_INVALID_ARGUMENT);
+    CHECK(ulog_signal_safe_fd_add(other[1], ULOG_LEVEL_TOTAL) ==
+          ULOG_STATUS_INVALID_ARGUMENT);
+
+    CHECK(ulog_signal_safe_fd_remove(other[1]) == ULOG_STATUS_OK);
+    CHECK(ulog_signal_safe_fd_remove(other[1]) == ULOG_STATUS_NOT_FOUND);
+    CHECK(ulog_signal_safe_fd_remove(-1) == ULOG_STATUS_NOT_FOUND);
+    ulog_log_signal_safe(ULOG_LEVEL_FATAL, NULL, 0, NULL, "Fatal");
+    CHECK(read_pipe() == "FATAL Fatal\n");
+    CHECK(read(other[0], buf, sizeof(buf)) < 0);  // Nothing written
+
+    // Cleanup unregisters all
+    ulog_cleanup();
+    ulog_log_signal_safe(ULOG_LEVEL_FATAL, NULL, 0, NULL, "Fatal");
+    CHECK(read_pipe().empty());
+    close(other[0]);
+    close(other[1]);
+}
+
+TEST_CASE_FIXTURE(SignalSafeTestFixture, "Signal Safe: Keeps errno") {
+    int closed[2];
+    REQUIRE(pipe(closed) == 0);
+    close(closed[0]);
+    close(closed[1]);
+    CHECK(ulog_signal_safe_fd_add(closed[1], ULOG_LEVEL_TRACE) ==
+          ULOG_STATUS_OK);
+
+    // The write to the closed descriptor fails with EBADF
+    errno = ERANGE;
+    ulog_log_signal_safe(ULOG_LEVEL_ERROR, NULL, 0, NULL, "Error");
+    CHECK(errno == ERANGE);
+    CHECK(read_pipe() == "ERROR Error\n");
+
+    errno = ERANGE;
+    ulog_log_signal_safe(ULOG_LEVEL_TOTAL, NULL, 0, NULL, "Invalid level");
+    CHECK(errno == ERANGE);
+}
+
+static bool lock_refused = false;
+
+static ulog_status refusing_lock(bool lock, void *arg) {
+    (void)arg;
+    return lock && lock_refused ? ULOG_STATUS_BUSY : ULOG_STATUS_OK;
+}
+
+static void on_signal(int sig) {
+    ulog_signal_safe_error("Caught signal %d", sig);
+}
+
+TEST_CASE_FIXTURE(SignalSafeTestFixture, "Signal Safe: Without The Lock") {
+    ulog_lock_set_fn(refusing_lock, nullptr);
+    lock_refused = true;  // As if held by the interrupted thread
+
+    struct sigaction action;
+    struct sigaction old_action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_signal;
+    sigemptyset(&action.sa_mask);
+    REQUIRE(sigaction(SIGUSR1, &action, &old_action) == 0);
+    raise(SIGUSR1);
+    sigaction(SIGUSR1, &old_action, nullptr);
+
+    std::string line = read_pipe();
+    CHECK(line.rfind("ERROR ", 0) == 0);
+    CHECK(line.find(": Caught signal " + std::to_string(SIGUSR1) + "\n") !=
+          std::string::npos);
+
+    lock_refused = false;
+}
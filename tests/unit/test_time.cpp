@@ -6,8 +6,16 @@
 #include "ulog.h"
 #include "ut_callback.h"
 
-constexpr static size_t TIME_STAMP_SIZE      = 8;   // HH:MM:SS
-constexpr static size_t FULL_TIME_STAMP_SIZE = 19;  // YYYY-MM-DD HH:MM:SS
+#ifndef ULOG_BUILD_TIME_PRECISION
+#define ULOG_BUILD_TIME_PRECISION 0
+#endif
+
+// ".mmm", ".uuuuuu" or ".nnnnnnnnn" after the seconds
+constexpr static size_t FRACTION_SIZE =
+    ULOG_BUILD_TIME_PRECISION > 0 ? ULOG_BUILD_TIME_PRECISION + 1 : 0;
+constexpr static size_t TIME_STAMP_SIZE = 8 + FRACTION_SIZE;  // HH:MM:SS
+constexpr static size_t FULL_TIME_STAMP_SIZE =
+    19 + FRACTION_SIZE;  // YYYY-MM-DD HH:MM:SS
 
 #if ULOG_BUILD_PREFIX_SIZE > 0
 static void test_prefix(ulog_event *ev, char *prefix, size_t prefix_size) {
@@ -193,3 +201,170 @@ TEST_CASE_FIXTURE(TimeTestFixture, "Check time with prefix") {
     _check_file_time(true);
 }
 #endif  // ULOG_BUILD_PREFIX_SIZE
+
+#if ULOG_BUILD_TIME_PRECISION > 0
+TEST_CASE_FIXTURE(TimeTestFixture, "Check sub-second time") {
+    ulog_info("Sub-second time");
+
+    const char *msg = ut_callback_get_last_message();
+    REQUIRE(msg[8] == '.');
+    for (size_t i = 9; i < TIME_STAMP_SIZE; i++) {
+        CHECK(msg[i] >= '0');
+        CHECK(msg[i] <= '9');
+    }
+}
+#endif  // ULOG_BUILD_TIME_PRECISION
+
+static int event_hour = -1;
+
+static void time_event_callback(ulog_event *ev, void *arg) {
+    (void)arg;
+    struct tm *tm = ulog_event_get_time(ev);
+    event_hour    = tm ? tm->tm_hour : -1;
+}
+
+TEST_CASE_FIXTURE(TimeTestFixture, "Event time matches printed time") {
+    ulog_output_id output =
+        ulog_output_add(time_event_callback, nullptr, ULOG_LEVEL_TRACE);
+    REQUIRE(output != ULOG_OUTPUT_INVALID);
+
+    ulog_info("Event time");
+
+    int hh = -1;
+    REQUIRE(sscanf(ut_callback_get_last_message(), "%d:", &hh) == 1);
+    CHECK(event_hour == hh);
+
+    ulog_output_remove(output);
+}
+
+#if ULOG_BUILD_TIME_PRECISION > 0
+TEST_CASE_FIXTURE(TimeTestFixture, "Outputs of an event print the same time") {
+    FILE *fp = tmpfile();
+    REQUIRE(fp != nullptr);
+    ulog_output_id file_output = ulog_output_add_file(fp, ULOG_LEVEL_TRACE);
+    REQUIRE(file_output != ULOG_OUTPUT_INVALID);
+
+    ulog_info("Same time");
+    ulog_output_remove(file_output);
+
+    char buffer[256] = {0};
+    rewind(fp);
+    REQUIRE(fgets(buffer, sizeof(buffer), fp) != nullptr);
+    fclose(fp);
+
+    // Short time is the end of the full time, fraction included
+    CHECK(strncmp(buffer + FULL_TIME_STAMP_SIZE - TIME_STAMP_SIZE,
+                  ut_callback_get_last_message(), TIME_STAMP_SIZE) == 0);
+}
+#endif  // ULOG_BUILD_TIME_PRECISION
+
+static long long fixed_clock(void *arg) {
+    return *(long long *)arg;
+}
+
+static long long ms_to_ns(long long stamp, void *arg) {
+    (void)arg;
+    return stamp * 1000000LL;
+}
+
+TEST_CASE_FIXTURE(TimeTestFixture, "Custom clock source") {
+    long long stamp = 1700000000123LL;  // Milliseconds since the epoch
+    REQUIRE(ulog_time_set_fn(fixed_clock, ms_to_ns, &stamp) == ULOG_STATUS_OK);
+
+    ulog_info("Injected time");
+
+    time_t sec        = (time_t)(stamp / 1000);
+    struct tm expected = *localtime(&sec);
+    char text[16];
+    strftime(text, sizeof(text), "%H:%M:%S", &expected);
+    const char *msg = ut_callback_get_last_message();
+    CHECK(strncmp(msg, text, 8) == 0);
+#if ULOG_BUILD_TIME_PRECISION > 0
+    CHECK(strncmp(msg + 8, ".123", 4) == 0);
+#endif
+
+    CHECK(ulog_time_set_fn(nullptr, ms_to_ns, nullptr) ==
+          ULOG_STATUS_INVALID_ARGUMENT);
+    CHECK(ulog_time_set_fn(nullptr, nullptr, nullptr) == ULOG_STATUS_OK);
+}
+
+#ifdef ULOG_TEST_TIME_THREADS
+#include <atomic>
+#include <thread>
+
+static thread_local long long thread_stamp = 0;
+static std::atomic<int> thread_mismatches{0};
+
+static long long thread_clock(void *arg) {
+    (void)arg;
+    return thread_stamp;
+}
+
+static void thread_time_callback(ulog_event *ev, void *arg) {
+    (void)arg;
+    time_t sec         = (time_t)(thread_stamp / 1000000000LL);
+    struct tm expected = {};
+    localtime_r(&sec, &expected);
+    struct tm *tm = ulog_event_get_time(ev);
+    if (tm == nullptr || tm->tm_sec != expected.tm_sec ||
+        tm->tm_min != expected.tm_min) {
+        thread_mismatches++;
+    }
+}
+
+TEST_CASE_FIXTURE(TimeTestFixture, "Time cache without a lock") {
+    ulog_output_level_set_all(ULOG_LEVEL_FATAL);  // ut_callback is not shared
+    ulog_output_id output =
+        ulog_output_add(thread_time_callback, nullptr, ULOG_LEVEL_TRACE);
+    REQUIRE(output != ULOG_OUTPUT_INVALID);
+    REQUIRE(ulog_time_set_fn(thread_clock, nullptr, nullptr) ==
+            ULOG_STATUS_OK);
+
+    // Each thread logs a new second every time: the cache is updated by
+    // both threads all the time
+    auto worker = [](long long first) {
+        for (int i = 0; i < 2000; i++) {
+            thread_stamp = (first + 2 * i) * 1000000000LL;
+            ulog_info("Thread time");
+        }
+    };
+    std::thread even(worker, 1700000000LL);
+    std::thread odd(worker, 1700000001LL);
+    even.join();
+    odd.join();
+    CHECK(thread_mismatches == 0);
+
+    CHECK(ulog_time_set_fn(nullptr, nullptr, nullptr) == ULOG_STATUS_OK);
+    ulog_output_remove(output);
+    ulog_output_level_set_all(ULOG_LEVEL_TRACE);
+}
+#endif  // ULOG_TEST_TIME_THREADS
+
+#ifdef ULOG_TEST_TIME_POSIX
+#include "ulog_time_posix.h"
+
+TEST_CASE_FIXTURE(TimeTestFixture, "POSIX clock sources") {
+    ulog_time_posix_clock clocks[] = {
+        ULOG_TIME_POSIX_REALTIME, ULOG_TIME_POSIX_REALTIME_COARSE,
+        ULOG_TIME_POSIX_MONOTONIC, ULOG_TIME_POSIX_TSC};
+
+    for (ulog_time_posix_clock clock : clocks) {
+        ulog_status status = ulog_time_posix_enable(clock);
+        if (status == ULOG_STATUS_DISABLED) {
+            continue;  // Not available on this platform
+        }
+        REQUIRE(status == ULOG_STATUS_OK);
+
+        time_t before, after;
+        _get_time_bounds(before, after);
+        int hh, mm, ss;
+        REQUIRE(sscanf(ut_callback_get_last_message(), "%d:%d:%d", &hh, &mm,
+                       &ss) == 3);
+        _check_time_fields(hh, mm, ss, before, after);
+    }
+
+    CHECK(ulog_time_posix_enable((ulog_time_posix_clock)100) ==
+          ULOG_STATUS_INVALID_ARGUMENT);
+    CHECK(ulog_time_posix_disable() == ULOG_STATUS_OK);
+}
+#endif  // ULOG_TEST_TIME_POSIX
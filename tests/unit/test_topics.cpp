@@ -4,6 +4,9 @@
 #include "ulog.h"
 #include "ut_callback.h"
 
+#include <cstdio>
+#include <cstring>
+
 struct TestFixture {
   public:
     static bool callback_is_set;
@@ -124,3 +127,32 @@ TEST_CASE_FIXTURE(
     ulog_t_error("testtopic_2", "After re-add");
     CHECK(ut_callback_get_message_count() == 2);
 }
+
+static int dispatched_count = 0;
+
+// Called for each event passed to the outputs, whatever output it is routed to
+static void count_prefix(ulog_event *ev, char *prefix, size_t prefix_size) {
+    (void)ev;
+    dispatched_count++;
+    snprintf(prefix, prefix_size, "%s", "");
+}
+
+TEST_CASE_FIXTURE(TestFixture, "Topics: Log by topic ID") {
+    ulog_prefix_set_fn(count_prefix);
+    ulog_topic_id id = ulog_topic_get_id("testtopic_2");
+    REQUIRE(id != ULOG_TOPIC_ID_INVALID);
+
+    ulog_tid_error(id, "By ID");
+    CHECK(ut_callback_get_message_count() == 1);
+    CHECK(strstr(ut_callback_get_last_message(), "[testtopic_2]") != nullptr);
+    CHECK(dispatched_count == 1);
+
+    // An empty slot is not a topic
+    REQUIRE(ulog_topic_remove("testtopic_2") == ULOG_STATUS_OK);
+    ulog_tid_error(id, "Removed topic is dropped");
+    ulog_tid_error(id + 100, "Invalid ID is dropped");
+    CHECK(dispatched_count == 1);
+    CHECK(ut_callback_get_message_count() == 1);
+
+    ulog_topic_add("testtopic_2", ULOG_OUTPUT_ALL, ULOG_LEVEL_TRACE);
+}
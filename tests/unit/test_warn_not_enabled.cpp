@@ -267,6 +267,23 @@ TEST_CASE_FIXTURE(WarnNotEnabledTestFixture,
     ulog_cleanup();
 }
 
+TEST_CASE_FIXTURE(WarnNotEnabledTestFixture, "Key-Value Fields Warning") {
+    ulog_output_id warning_output =
+        ulog_output_add(warning_test_callback, nullptr, ULOG_LEVEL_WARN);
+    REQUIRE(warning_output != ULOG_OUTPUT_INVALID);
+
+    reset_warning_callback();
+    ulog_kv_error(NULL, "Fields dropped", ULOG_KV_INT("code", 7));
+
+    // The warning, then the message without its fields
+    CHECK(warning_callback_count == 2);
+    CHECK(strstr(warning_last_message, "ulog_log_kv") != nullptr);
+    CHECK(strstr(warning_last_message, "ULOG_BUILD_KV_FIELDS disabled") !=
+          nullptr);
+
+    ulog_output_remove(warning_output);
+}
+
 TEST_CASE_FIXTURE(WarnNotEnabledTestFixture, "Warning Message Format") {
     ulog_output_id warning_output =
         ulog_output_add(warning_test_callback, nullptr, ULOG_LEVEL_WARN);
@@ -0,0 +1,8 @@
+// Sample configuration header for the minimum build level test.
+// Included when ULOG_BUILD_CONFIG_HEADER_ENABLED is defined and
+// ULOG_BUILD_CONFIG_HEADER_NAME points to this file.
+
+#pragma once
+
+#define ULOG_BUILD_EXTRA_OUTPUTS 4
+#define ULOG_BUILD_MIN_LEVEL ULOG_LEVEL_INFO
@@ -0,0 +1,28 @@
+#pragma once
+// Reading back what outputs wrote to files and streams
+
+#include <cstdio>
+#include <string>
+#include "doctest/doctest.h"
+
+/// @brief Reads the whole stream from the start
+inline std::string ut_read_stream(FILE *file) {
+    std::string content;
+    fflush(file);
+    rewind(file);
+    char buf[4096];
+    size_t n = 0;
+    while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+        content.append(buf, n);
+    }
+    return content;
+}
+
+/// @brief Reads the whole file
+inline std::string ut_read_file(const char *path) {
+    FILE *file = fopen(path, "rb");
+    REQUIRE(file != nullptr);
+    std::string content = ut_read_stream(file);
+    fclose(file);
+    return content;
+}
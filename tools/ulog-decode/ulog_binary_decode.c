@@ -0,0 +1,373 @@
+// *************************************************************************
+//
+// microlog tool: decoder of the binary output
+//
+// See ulog_binary_decode.h. The records are printed with the capture,
+// key-value and print code of the library, included below.
+//
+// *************************************************************************
+
+#include "ulog_binary_decode.h"
+#include "../../src/ulog.c"
+
+#if !ULOG_HAS_BINARY
+#error "The decoder requires ULOG_BUILD_BINARY_OUTPUT > 0"
+#endif
+
+// Private
+// ================
+
+#define BINARY_DECODE_MAX_LEN (1u << 24)  // Longest string a decoder reads
+
+/// @brief Date of a day since 1970-01-01 in the proleptic Gregorian calendar
+static void binary_civil_from_days(long long z, long long *y, unsigned int *m,
+                                   unsigned int *d) {
+    z += 719468;
+    long long era    = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned int doe = (unsigned int)(z - era * 146097);
+    unsigned int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned int mp  = (5 * doy + 2) / 153;
+    *d               = doy - (153 * mp + 2) / 5 + 1;
+    *m               = mp < 10 ? mp + 3 : mp - 9;
+    *y               = (long long)yoe + era * 400 + (*m <= 2);
+}
+
+/// @brief Growing array of owned strings
+typedef struct {
+    char **items;
+    size_t count;
+    size_t capacity;
+} binary_strs;
+
+typedef struct {
+    FILE *in;
+    int precision;       // Time precision of the log
+    bool clock_read;     // utc_offset was read
+    long utc_offset;
+    long long last_ns;
+    binary_strs dict;    // Dictionary strings, id - BINARY_DICT_FIRST_ID
+    binary_strs scratch; // Strings of the current event
+} binary_decoder;
+
+static bool binary_strs_push(binary_strs *strs, char *str) {
+    if (strs->count == strs->capacity) {
+        size_t capacity = strs->capacity != 0 ? strs->capacity * 2 : 64;
+        char **items    = realloc(strs->items, capacity * sizeof(char *));
+        if (items == NULL) {
+            free(str);
+            return false;
+        }
+        strs->items    = items;
+        strs->capacity = capacity;
+    }
+    strs->items[strs->count++] = str;
+    return true;
+}
+
+static void binary_strs_clear(binary_strs *strs) {
+    for (size_t i = 0; i < strs->count; i++) {
+        free(strs->items[i]);
+    }
+    strs->count = 0;
+}
+
+static bool binary_read_varint(FILE *in, unsigned long long *value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(in);
+        if (c == EOF) {
+            return false;
+        }
+        *value |= (unsigned long long)(c & 0x7f) << shift;
+        if ((c & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;  // Too long
+}
+
+static bool binary_read_svarint(FILE *in, long long *value) {
+    unsigned long long u = 0;
+    if (!binary_read_varint(in, &u)) {
+        return false;
+    }
+    *value = (u & 1) != 0 ? (long long)~(u >> 1) : (long long)(u >> 1);
+    return true;
+}
+
+/// @brief Allocates a buffer freed with the strings of the current event
+static char *binary_alloc(binary_decoder *d, size_t size) {
+    char *data = malloc(size);
+    if (data == NULL || !binary_strs_push(&d->scratch, data)) {
+        return NULL;
+    }
+    return data;
+}
+
+/// @brief Reads `len` bytes into a new NUL-terminated buffer
+/// @return Buffer freed with the strings of the current event or NULL on error
+static char *binary_read_bytes(binary_decoder *d, size_t len) {
+    if (len > BINARY_DECODE_MAX_LEN) {
+        return NULL;
+    }
+    char *data = binary_alloc(d, len + 1);
+    if (data == NULL || fread(data, 1, len, d->in) != len) {
+        return NULL;
+    }
+    data[len] = '\0';
+    return data;
+}
+
+/// @brief Reads a string written by binary_put_str() or binary_put_inline()
+/// @return The string or NULL on error
+static const char *binary_read_str(binary_decoder *d) {
+    unsigned long long tag = 0;
+    unsigned long long len = 0;
+    if (!binary_read_varint(d->in, &tag)) {
+        return NULL;
+    }
+    if (tag >= BINARY_DICT_FIRST_ID) {
+        unsigned long long index = tag - BINARY_DICT_FIRST_ID;
+        return index < d->dict.count ? d->dict.items[index] : NULL;
+    }
+    if (!binary_read_varint(d->in, &len)) {
+        return NULL;
+    }
+    char *str = binary_read_bytes(d, (size_t)len);
+    if (str == NULL || tag == BINARY_STR_INLINE) {
+        return str;
+    }
+    d->scratch.count--;  // Moved to the dictionary
+    return binary_strs_push(&d->dict, str) ? str : NULL;
+}
+
+/// @brief Prints the time as time_print_text() does
+static void binary_print_time(print_target *tgt, binary_decoder *d,
+                              long long ns, bool append_space) {
+    long long sec = ns / BINARY_NS_PER_SEC;
+    long long rem = ns % BINARY_NS_PER_SEC;
+    if (rem < 0) {
+        sec -= 1;
+        rem += BINARY_NS_PER_SEC;
+    }
+    long long local = sec + d->utc_offset;
+    long long days  = local / 86400;
+    long long secs  = local % 86400;
+    if (secs < 0) {
+        days -= 1;
+        secs += 86400;
+    }
+    long long year     = 0;
+    unsigned int month = 0;
+    unsigned int day   = 0;
+    binary_civil_from_days(days, &year, &month, &day);
+    print_to_target(tgt, "%04lld-%02u-%02u %02lld:%02lld:%02lld", year, month,
+                    day, secs / 3600, secs / 60 % 60, secs % 60);
+    if (d->precision > 0) {
+        for (int i = d->precision; i < 9; i++) {
+            rem /= 10;
+        }
+        print_to_target(tgt, ".%0*lld", d->precision, rem);
+    }
+    if (append_space) {
+        print_to_target(tgt, " ");
+    }
+}
+
+#if ULOG_HAS_KV
+/// @brief Reads the key-value fields
+/// @return Fields to free or NULL on error
+static ulog_kv *binary_read_kv(binary_decoder *d, size_t *count) {
+    unsigned long long n = 0;
+    if (!binary_read_varint(d->in, &n) || n == 0 ||
+        n > BINARY_DECODE_MAX_LEN / sizeof(ulog_kv)) {
+        return NULL;
+    }
+    ulog_kv *fields = calloc((size_t)n, sizeof(ulog_kv));
+    if (fields == NULL) {
+        return NULL;
+    }
+    bool ok = true;
+    for (size_t i = 0; ok && i < n; i++) {
+        ulog_kv *kv          = &fields[i];
+        kv->key              = binary_read_str(d);
+        int type             = fgetc(d->in);
+        kv->type             = (ulog_kv_type)type;
+        unsigned long long u = 0;
+        ok                   = kv->key != NULL && type != EOF;
+        switch (ok ? type : -1) {
+            case ULOG_KV_TYPE_INT:
+                ok = binary_read_svarint(d->in, &kv->value.i);
+                break;
+            case ULOG_KV_TYPE_UINT:
+                ok          = binary_read_varint(d->in, &u);
+                kv->value.u = u;
+                break;
+            case ULOG_KV_TYPE_DOUBLE:
+                ok = fread(&kv->value.d, sizeof(kv->value.d), 1, d->in) == 1;
+                break;
+            case ULOG_KV_TYPE_BOOL:
+                type        = fgetc(d->in);
+                ok          = type != EOF;
+                kv->value.b = type == 1;
+                break;
+            case ULOG_KV_TYPE_STR:
+                kv->value.s = binary_read_str(d);
+                ok          = kv->value.s != NULL;
+                break;
+            default:
+                break;  // Unknown type, no value
+        }
+    }
+    if (!ok) {
+        free(fields);
+        return NULL;
+    }
+    *count = (size_t)n;
+    return fields;
+}
+#endif  // ULOG_HAS_KV
+
+/// @brief Decodes an event record and prints its line as a file output does
+/// @return false on a malformed or truncated record
+static bool binary_decode_event(binary_decoder *d, print_target *tgt) {
+    int flags = fgetc(d->in);
+    int level = fgetc(d->in);
+    if (flags == EOF || level == EOF) {
+        return false;
+    }
+    const char *level_name = binary_read_str(d);
+    long long delta        = 0;
+    if (level_name == NULL ||
+        ((flags & BINARY_EVENT_TIME) != 0 &&
+         (!d->clock_read || !binary_read_svarint(d->in, &delta)))) {
+        return false;
+    }
+    d->last_ns += delta;
+
+    const char *prefix = NULL;
+    const char *topic  = NULL;
+    const char *file   = NULL;
+    long long line     = 0;
+    if ((flags & BINARY_EVENT_PREFIX) != 0 &&
+        (prefix = binary_read_str(d)) == NULL) {
+        return false;
+    }
+    if ((flags & BINARY_EVENT_TOPIC) != 0 &&
+        (topic = binary_read_str(d)) == NULL) {
+        return false;
+    }
+    if ((flags & BINARY_EVENT_LOCATION) != 0 &&
+        ((file = binary_read_str(d)) == NULL ||
+         !binary_read_svarint(d->in, &line))) {
+        return false;
+    }
+
+    // Capture record: format, then the argument values
+    const char *format          = binary_read_str(d);
+    unsigned long long args_len = 0;
+    if (format == NULL || !binary_read_varint(d->in, &args_len) ||
+        args_len > BINARY_DECODE_MAX_LEN) {
+        return false;
+    }
+    size_t format_len = strlen(format);
+    size_t size       = format_len + 1 + (size_t)args_len;
+    char *record      = binary_alloc(d, size);
+    if (record == NULL ||
+        fread(record + format_len + 1, 1, (size_t)args_len, d->in) !=
+            args_len) {
+        return false;
+    }
+    memcpy(record, format, format_len + 1);
+    if (capture_size(record, size) == 0) {
+        return false;  // Arguments do not match the format
+    }
+
+    ulog_kv *fields = NULL;
+    size_t count    = 0;
+#if ULOG_HAS_KV
+    if ((flags & BINARY_EVENT_KV) != 0 &&
+        (fields = binary_read_kv(d, &count)) == NULL) {
+        return false;
+    }
+#else
+    if ((flags & BINARY_EVENT_KV) != 0) {
+        return false;  // Fields cannot be printed without the feature
+    }
+#endif
+
+    // Same order as log_render_event()
+    if ((flags & BINARY_EVENT_TIME) != 0) {
+        binary_print_time(tgt, d, d->last_ns,
+                          (flags & BINARY_EVENT_TIME_SPACE) != 0);
+    } else if ((flags & BINARY_EVENT_TIME_INVALID) != 0) {
+        print_to_target(tgt, "INVALID_TIME");
+    }
+    if (prefix != NULL) {
+        print_to_target(tgt, "%s", prefix);
+    }
+    print_to_target(tgt, "%s ", level_name);
+    if (topic != NULL) {
+        print_to_target(tgt, "[%s] ", topic);
+    }
+    if (file != NULL) {
+        print_to_target(tgt, "%s:%d: ", file, (int)line);
+    }
+    capture_print(tgt, record);
+#if ULOG_HAS_KV
+    if (fields != NULL) {
+        ulog_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.kv       = fields;
+        ev.kv_count = count;
+        kv_print(tgt, &ev);
+        free(fields);
+    }
+#else
+    (void)fields, (void)count;
+#endif
+    print_to_target(tgt, "\n");
+    return true;
+}
+
+// Public
+// ================
+
+ulog_status ulog_binary_decode(FILE *in, FILE *out) {
+    if (in == NULL || out == NULL) {
+        return ULOG_STATUS_INVALID_ARGUMENT;
+    }
+
+    unsigned char expected[BINARY_HEADER_LEN];
+    unsigned char header[BINARY_HEADER_LEN];
+    binary_header(expected);
+    if (fread(header, 1, sizeof(header), in) != sizeof(header) ||
+        memcmp(header, expected, BINARY_HEADER_CHECK_LEN) != 0 ||
+        header[BINARY_HEADER_CHECK_LEN] > 9) {
+        return ULOG_STATUS_ERROR;  // Not a log of this build
+    }
+
+    binary_decoder d = {.in = in, .precision = header[BINARY_HEADER_CHECK_LEN]};
+    print_target tgt = {.type = PRINT_TARGET_STREAM, .dsc.stream = out};
+    ulog_status status = ULOG_STATUS_OK;
+    int type           = 0;
+    while (status == ULOG_STATUS_OK && (type = fgetc(in)) != EOF) {
+        long long offset = 0;
+        bool ok          = false;
+        if (type == BINARY_RECORD_CLOCK) {
+            ok           = binary_read_svarint(in, &offset);
+            d.utc_offset = (long)offset;
+            d.clock_read = ok;
+        } else if (type == BINARY_RECORD_EVENT) {
+            ok = binary_decode_event(&d, &tgt);
+        }
+        binary_strs_clear(&d.scratch);
+        status = ok ? ULOG_STATUS_OK : ULOG_STATUS_ERROR;
+    }
+
+    binary_strs_clear(&d.dict);
+    free(d.dict.items);
+    free(d.scratch.items);
+    return status;
+}
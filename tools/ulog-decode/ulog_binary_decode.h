@@ -0,0 +1,43 @@
+// *************************************************************************
+//
+// microlog tool: decoder of the binary output
+//
+// Turns a log written by ulog_output_add_binary_file() back into the text a
+// file output would have written. Kept out of the library: it allocates and
+// reads files, which the writing side never needs.
+//
+// The decoder is built from ulog_binary_decode.c, which includes src/ulog.c
+// to print the records with the same code as the file output. Compile it
+// instead of ulog.c, with the ULOG_BUILD_* options of the writer (at least
+// ULOG_BUILD_EXTRA_OUTPUTS and ULOG_BUILD_BINARY_OUTPUT), for the same type
+// sizes and byte order.
+//
+// Usage:
+//    #include "ulog_binary_decode.h"
+//    ...
+//    ulog_binary_decode(binary_log, stdout);
+//
+// *************************************************************************
+
+#pragma once
+#include <stdio.h>
+#include "ulog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * @brief Decode a binary log into the text a file output would have written.
+ * The log must come from a build with the same type sizes and byte order.
+ * Lines are written as they are decoded.
+ * @param in Binary log, at its start
+ * @param out Text output
+ * @return ULOG_STATUS_OK on success, ULOG_STATUS_INVALID_ARGUMENT if a stream
+ * is NULL, ULOG_STATUS_ERROR if the log is not valid, truncated or from an
+ * incompatible build
+ */
+ulog_status ulog_binary_decode(FILE *in, FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
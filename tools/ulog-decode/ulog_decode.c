@@ -0,0 +1,57 @@
+// *************************************************************************
+// microlog tool: ulog-decode
+//
+// Turns a log written by ulog_output_add_binary_file() back into the text a
+// file output would have written.
+//
+// Usage: ulog-decode [input.bin [output.txt]]
+//        Reads stdin and writes stdout when the files are not given.
+//
+// The tool must be built for the same type sizes and byte order as the
+// program that wrote the log.
+// *************************************************************************
+
+#include "ulog_binary_decode.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+int main(int argc, char **argv) {
+    if (argc > 3 || (argc > 1 && strcmp(argv[1], "--help") == 0)) {
+        fprintf(stderr, "Usage: %s [input.bin [output.txt]]\n", argv[0]);
+        return 2;
+    }
+
+    FILE *in  = stdin;
+    FILE *out = stdout;
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    if (argc > 1 && (in = fopen(argv[1], "rb")) == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    if (argc > 2 && (out = fopen(argv[2], "w")) == NULL) {
+        perror(argv[2]);
+        fclose(in);
+        return 1;
+    }
+
+    ulog_status status = ulog_binary_decode(in, out);
+    if (status != ULOG_STATUS_OK) {
+        fprintf(stderr, "%s: not a valid binary log or truncated\n",
+                argc > 1 ? argv[1] : "stdin");
+    }
+
+    if (in != stdin) {
+        fclose(in);
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+    return status == ULOG_STATUS_OK ? 0 : 1;
+}
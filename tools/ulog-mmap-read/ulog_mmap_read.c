@@ -0,0 +1,46 @@
+// *************************************************************************
+// microlog tool: ulog-mmap-read
+//
+// Writes the lines of segment files of the ulog_mmap_posix extension to
+// stdout, in the given order.
+//
+// Usage: ulog-mmap-read [--recover] segment...
+//        --recover also writes the complete lines after the last committed
+//        one and reports the state of each segment to stderr.
+// *************************************************************************
+
+#include "ulog_mmap_posix.h"
+#include <stdio.h>
+#include <string.h>
+
+int main(int argc, char **argv) {
+    int first    = 1;
+    bool recover = false;
+    if (argc > 1 && strcmp(argv[1], "--recover") == 0) {
+        recover = true;
+        first++;
+    }
+    if (first >= argc || strcmp(argv[first], "--help") == 0) {
+        fprintf(stderr, "Usage: %s [--recover] segment...\n", argv[0]);
+        return 2;
+    }
+
+    int result = 0;
+    for (int i = first; i < argc; i++) {
+        ulog_mmap_posix_info info;
+        if (ulog_mmap_posix_read(argv[i], stdout, recover, &info) !=
+            ULOG_STATUS_OK) {
+            fprintf(stderr, "%s: not a segment file or cannot be read\n",
+                    argv[i]);
+            result = 1;
+            continue;
+        }
+        if (recover) {
+            fprintf(stderr,
+                    "%s: segment %llu, %zu bytes committed, %zu recovered%s\n",
+                    argv[i], info.sequence, info.committed, info.recovered,
+                    info.closed ? "" : ", not closed cleanly");
+        }
+    }
+    return result;
+}